@@ -0,0 +1,127 @@
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+#include "bitmap.h"
+#include "filefinder.h"
+#include "filesystem_stream.h"
+#include "output.h"
+#include "pixel_format.h"
+#include "utils.h"
+
+// Loads all files of a game. Set EP_BENCH_GAME to the directory of a (mid-size) game.
+
+struct Asset {
+	std::string path;
+	bool is_image;
+};
+
+static void CollectAssets(const FilesystemView& fs, std::vector<Asset>& assets) {
+	auto* entries = fs.ListDirectory();
+	if (!entries) {
+		return;
+	}
+
+	for (const auto& it : *entries) {
+		if (it.second.type == DirectoryTree::FileType::Directory) {
+			CollectAssets(fs.Subtree(it.second.name), assets);
+		} else if (it.second.type == DirectoryTree::FileType::Regular) {
+			auto& name = it.first;
+			bool is_image = StringView(name).ends_with(".png") || StringView(name).ends_with(".bmp") || StringView(name).ends_with(".xyz");
+			assets.push_back({ FileFinder::MakePath(fs.GetFullPath(), it.second.name), is_image });
+		}
+	}
+}
+
+static const std::vector<Asset>& GetAssets() {
+	static std::vector<Asset> assets = []() {
+		std::vector<Asset> assets;
+		if (const char* path = getenv("EP_BENCH_GAME")) {
+			Output::SetLogLevel(LogLevel::Error);
+			auto fs = FileFinder::Root().Create(path);
+			if (fs) {
+				CollectAssets(fs, assets);
+			}
+		}
+		return assets;
+	}();
+	return assets;
+}
+
+// Reads every byte like a decoder would, so both benchmarks do the same work on the data
+static size_t Consume(Span<const uint8_t> data) {
+	unsigned sum = std::accumulate(data.begin(), data.end(), 0u);
+	benchmark::DoNotOptimize(sum);
+	return data.size();
+}
+
+// Reading through a plain file stream into a buffer, how most assets were read before
+static void BM_ReadAssetsFilebuf(benchmark::State& state) {
+	auto& assets = GetAssets();
+	if (assets.empty()) {
+		state.SkipWithError("EP_BENCH_GAME is not set or contains no files");
+		return;
+	}
+
+	size_t bytes = 0;
+	for (auto _: state) {
+		for (auto& asset: assets) {
+			std::ifstream is(asset.path, std::ios_base::in | std::ios_base::binary);
+			auto data = Utils::ReadStream(is);
+			bytes += Consume(data);
+		}
+	}
+	state.SetBytesProcessed(bytes);
+}
+
+BENCHMARK(BM_ReadAssetsFilebuf)->Unit(benchmark::kMillisecond);
+
+// Reading through the filesystem, memory backed streams are accessed without copying
+static void BM_ReadAssets(benchmark::State& state) {
+	auto& assets = GetAssets();
+	if (assets.empty()) {
+		state.SkipWithError("EP_BENCH_GAME is not set or contains no files");
+		return;
+	}
+
+	size_t bytes = 0;
+	for (auto _: state) {
+		for (auto& asset: assets) {
+			auto is = FileFinder::Root().OpenInputStream(asset.path);
+			auto data = is.GetData();
+			if (!data.empty()) {
+				bytes += Consume(data);
+			} else {
+				auto buffer = Utils::ReadStream(is);
+				bytes += Consume(buffer);
+			}
+		}
+	}
+	state.SetBytesProcessed(bytes);
+}
+
+BENCHMARK(BM_ReadAssets)->Unit(benchmark::kMillisecond);
+
+static void BM_LoadImages(benchmark::State& state) {
+	auto& assets = GetAssets();
+	if (assets.empty()) {
+		state.SkipWithError("EP_BENCH_GAME is not set or contains no files");
+		return;
+	}
+
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	for (auto _: state) {
+		for (auto& asset: assets) {
+			if (asset.is_image) {
+				auto bmp = Bitmap::Create(FileFinder::Root().OpenInputStream(asset.path));
+				benchmark::DoNotOptimize(bmp.get());
+			}
+		}
+	}
+}
+
+BENCHMARK(BM_LoadImages)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+#include "system.h"
+
+#ifdef HAVE_LHASA
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include "filefinder.h"
+#include "filesystem_lzh.h"
+#include "output.h"
+#include "utils.h"
+
+// Opens every file of a LZH archive twice. Set EP_BENCH_LZH to the path of a (mid-size) archive.
+
+static void CollectFiles(const FilesystemView& fs, std::vector<std::string>& files) {
+	auto* entries = fs.ListDirectory();
+	if (!entries) {
+		return;
+	}
+
+	for (const auto& it : *entries) {
+		if (it.second.type == DirectoryTree::FileType::Directory) {
+			CollectFiles(fs.Subtree(it.second.name), files);
+		} else if (it.second.type == DirectoryTree::FileType::Regular) {
+			files.push_back(FileFinder::MakePath(fs.GetSubPath(), it.second.name));
+		}
+	}
+}
+
+static std::shared_ptr<LzhFilesystem> OpenArchive() {
+	const char* path = getenv("EP_BENCH_LZH");
+	if (!path) {
+		return nullptr;
+	}
+	Output::SetLogLevel(LogLevel::Error);
+	auto dir_and_name = FileFinder::GetPathAndFilename(FileFinder::MakeCanonical(path, 0));
+	auto parent = FileFinder::Root().Create(std::get<0>(dir_and_name));
+	if (!parent) {
+		return nullptr;
+	}
+	auto lzh = std::make_shared<LzhFilesystem>(std::get<1>(dir_and_name), parent);
+	return lzh->IsValid() ? lzh : nullptr;
+}
+
+// Arg: cache limit in MiB, 0 decompresses on every open
+static void BM_LzhOpenTwice(benchmark::State& state) {
+	if (!OpenArchive()) {
+		state.SkipWithError("EP_BENCH_LZH is not set or not a LZH archive");
+		return;
+	}
+
+	LzhFilesystem::SetCacheLimit(static_cast<size_t>(state.range(0)) * 1024 * 1024);
+
+	size_t bytes = 0;
+	for (auto _: state) {
+		state.PauseTiming();
+		auto lzh = OpenArchive();
+		FilesystemView fs = lzh->Subtree("");
+		std::vector<std::string> files;
+		CollectFiles(fs, files);
+		state.ResumeTiming();
+
+		for (int i = 0; i < 2; ++i) {
+			for (auto& file: files) {
+				auto is = fs.OpenInputStream(file);
+				auto data = Utils::ReadStream(is);
+				benchmark::DoNotOptimize(data.data());
+				bytes += data.size();
+			}
+		}
+	}
+	state.SetBytesProcessed(bytes);
+
+	LzhFilesystem::SetCacheLimit(8 * 1024 * 1024);
+}
+
+BENCHMARK(BM_LzhOpenTwice)->Arg(0)->Arg(8)->Arg(64)->Unit(benchmark::kMillisecond);
+
+// Reads only the header of every file, large entries are decoded lazily
+static void BM_LzhReadHeaders(benchmark::State& state) {
+	auto lzh = OpenArchive();
+	if (!lzh) {
+		state.SkipWithError("EP_BENCH_LZH is not set or not a LZH archive");
+		return;
+	}
+
+	FilesystemView fs = lzh->Subtree("");
+	std::vector<std::string> files;
+	CollectFiles(fs, files);
+
+	LzhFilesystem::SetStreamingThreshold(static_cast<uint32_t>(state.range(0)));
+	LzhFilesystem::SetCacheLimit(0);
+	for (auto _: state) {
+		for (auto& file: files) {
+			auto is = fs.OpenInputStream(file);
+			char header[16] = {};
+			is.read(header, sizeof(header));
+			benchmark::DoNotOptimize(header);
+		}
+	}
+	LzhFilesystem::SetStreamingThreshold(1024 * 1024);
+	LzhFilesystem::SetCacheLimit(8 * 1024 * 1024);
+}
+
+BENCHMARK(BM_LzhReadHeaders)->Arg(UINT32_MAX)->Arg(64 * 1024)->Unit(benchmark::kMillisecond);
+
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,120 @@
+#include <benchmark/benchmark.h>
+#include "game_actors.h"
+#include "game_event.h"
+#include "game_map.h"
+#include "game_party.h"
+#include "game_pictures.h"
+#include "game_player.h"
+#include "game_screen.h"
+#include "game_switches.h"
+#include "game_system.h"
+#include "game_variables.h"
+#include "main_data.h"
+#include "map_data.h"
+#include <lcf/data.h>
+
+// A town map crowded with 500 decorative NPCs: Most stand still and animate,
+// some walk around randomly.
+constexpr int num_events = 500;
+
+static std::unique_ptr<lcf::rpg::Map> MakeMap() {
+	auto map = std::make_unique<lcf::rpg::Map>();
+	map->width = 100;
+	map->height = 100;
+	map->lower_layer.resize(map->width * map->height, BLOCK_E);
+	map->upper_layer.resize(map->width * map->height, BLOCK_F);
+
+	for (int i = 0; i < num_events; ++i) {
+		map->events.push_back({});
+		auto& ev = map->events.back();
+		ev.ID = i + 1;
+		ev.x = (i % 25) * 4;
+		ev.y = (i / 25) * 5;
+		ev.pages.push_back({});
+		auto& page = ev.pages.back();
+		page.ID = 1;
+		page.character_name = "People";
+		page.move_type = (i % 10 == 0) ? lcf::rpg::EventPage::MoveType_random : lcf::rpg::EventPage::MoveType_stationary;
+		page.animation_type = (i % 3 == 0) ? lcf::rpg::EventPage::AnimType_continuous : lcf::rpg::EventPage::AnimType_non_continuous;
+		page.move_speed = 1 + i % 6;
+		page.move_frequency = 1 + i % 8;
+	}
+	return map;
+}
+
+static void SetupMap() {
+	lcf::Data::data = {};
+	lcf::Data::terrains.push_back({});
+	lcf::Data::chipsets.push_back({});
+	auto& chipset = lcf::Data::chipsets.back();
+	chipset.passable_data_lower.resize(162, 0xF);
+	chipset.passable_data_upper.resize(162, 0xF);
+	chipset.terrain_data.resize(144, 1);
+
+	lcf::Data::treemap.maps.push_back(lcf::rpg::MapInfo());
+	lcf::Data::treemap.maps.back().type = lcf::rpg::TreeMap::MapType_root;
+	lcf::Data::treemap.maps.push_back(lcf::rpg::MapInfo());
+	lcf::Data::treemap.maps.back().ID = 1;
+	lcf::Data::treemap.maps.back().type = lcf::rpg::TreeMap::MapType_map;
+
+	Main_Data::game_actors = std::make_unique<Game_Actors>();
+	Main_Data::game_party = std::make_unique<Game_Party>();
+	Game_Map::Init();
+	Main_Data::game_system = std::make_unique<Game_System>();
+	Main_Data::game_switches = std::make_unique<Game_Switches>();
+	Main_Data::game_variables = std::make_unique<Game_Variables>(Game_Variables::min_2k3, Game_Variables::max_2k3);
+	Main_Data::game_pictures = std::make_unique<Game_Pictures>();
+	Main_Data::game_screen = std::make_unique<Game_Screen>();
+	Main_Data::game_player = std::make_unique<Game_Player>();
+	Main_Data::game_player->SetMapId(1);
+
+	Game_Map::Setup(MakeMap());
+}
+
+static void TeardownMap() {
+	Main_Data::game_switches = {};
+	Main_Data::game_variables = {};
+	Main_Data::game_player = {};
+	Main_Data::game_screen = {};
+	Main_Data::game_pictures = {};
+	Game_Map::Quit();
+	Main_Data::game_party = {};
+	Main_Data::game_actors = {};
+	Main_Data::game_system = {};
+	lcf::Data::data = {};
+}
+
+// Every event through Game_Event::Update, how all events were updated before
+static void BM_UpdateEventsSequential(benchmark::State& state) {
+	SetupMap();
+	auto& events = Game_Map::GetEvents();
+	for (auto _: state) {
+		for (auto& ev: events) {
+			ev.SetProcessed(false);
+		}
+		for (auto& ev: events) {
+			ev.Update(false);
+		}
+	}
+	TeardownMap();
+}
+
+BENCHMARK(BM_UpdateEventsSequential);
+
+// Events that only advance their counters are updated in batches
+static void BM_UpdateEventsBatched(benchmark::State& state) {
+	SetupMap();
+	auto& events = Game_Map::GetEvents();
+	for (auto _: state) {
+		for (auto& ev: events) {
+			ev.SetProcessed(false);
+		}
+		MapUpdateAsyncContext actx;
+		Game_Map::UpdateMapEvents(actx);
+	}
+	TeardownMap();
+}
+
+BENCHMARK(BM_UpdateEventsBatched);
+
+BENCHMARK_MAIN();
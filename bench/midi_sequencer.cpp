@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <vector>
+#include "audio_decoder_midi.h"
+#include "filesystem_stream.h"
+#include "midisequencer.h"
+
+// Builds a 3 minute SMF with dense controller traffic on all channels
+static std::vector<uint8_t> MakeSong() {
+	std::vector<uint8_t> track;
+	auto write_delta = [&](uint32_t v) {
+		uint8_t b[5];
+		int n = 0;
+		b[n++] = v & 0x7F;
+		while (v >>= 7) {
+			b[n++] = 0x80 | (v & 0x7F);
+		}
+		while (n--) {
+			track.push_back(b[n]);
+		}
+	};
+
+	uint32_t rnd = 1;
+	for (int i = 0; i < 40000; ++i) {
+		rnd = rnd * 1103515245 + 12345;
+		write_delta((rnd >> 16) % 10);
+		uint8_t c = (rnd >> 8) & 0xF;
+		switch ((rnd >> 20) % 8) {
+			case 0:
+				track.insert(track.end(), { uint8_t(0xC0 | c), uint8_t((rnd >> 3) & 0x7F) });
+				break;
+			case 1:
+				track.insert(track.end(), { uint8_t(0xB0 | c), uint8_t(rnd % 4 * 3 + 7), uint8_t((rnd >> 12) & 0x7F) });
+				break;
+			case 2:
+				track.insert(track.end(), { uint8_t(0xE0 | c), uint8_t(rnd & 0x7F), uint8_t((rnd >> 7) & 0x7F) });
+				break;
+			default:
+				track.insert(track.end(), { uint8_t(0x90 | c), uint8_t(36 + (rnd >> 4) % 48), uint8_t(rnd & 1 ? 100 : 0) });
+				break;
+		}
+	}
+	write_delta(0);
+	track.insert(track.end(), { 0xFF, 0x2F, 0x00 });
+
+	std::vector<uint8_t> file = { 'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96, 'M', 'T', 'r', 'k' };
+	uint32_t len = track.size();
+	file.insert(file.end(), { uint8_t(len >> 24), uint8_t(len >> 16), uint8_t(len >> 8), uint8_t(len) });
+	file.insert(file.end(), track.begin(), track.end());
+	return file;
+}
+
+static const std::vector<uint8_t> song = MakeSong();
+
+class NullMidiDecoder : public MidiDecoder {
+public:
+	std::string GetName() override {
+		return "Null";
+	}
+};
+
+class NullMidiOutput : public midisequencer::output {
+public:
+	void midi_message(int, uint_least32_t) override {}
+	void sysex_message(int, const void*, std::size_t) override {}
+	void meta_event(int, const void*, std::size_t) override {}
+	void reset() override {}
+};
+
+static int ReadSong(void* userdata) {
+	auto& pos = *static_cast<size_t*>(userdata);
+	return pos < song.size() ? song[pos++] : EOF;
+}
+
+static void BM_MidiParse(benchmark::State& state) {
+	midisequencer::sequencer seq;
+	for (auto _: state) {
+		size_t pos = 0;
+		seq.load(&pos, ReadSong);
+	}
+}
+
+BENCHMARK(BM_MidiParse)->Unit(benchmark::kMicrosecond);
+
+static void BM_MidiOpen(benchmark::State& state) {
+	for (auto _: state) {
+		AudioDecoderMidi dec(std::make_unique<NullMidiDecoder>());
+		Filesystem_Stream::InputStream is(new Filesystem_Stream::InputMemoryStreamBuf(song), "bench.mid");
+		dec.Open(std::move(is));
+	}
+}
+
+BENCHMARK(BM_MidiOpen)->Unit(benchmark::kMicrosecond);
+
+static void BM_MidiSeek(benchmark::State& state) {
+	midisequencer::sequencer seq;
+	size_t pos = 0;
+	seq.load(&pos, ReadSong);
+	NullMidiOutput out;
+	auto target = seq.get_total_time() * state.range(0) / 100;
+
+	for (auto _: state) {
+		// Playing from the start restarts from the closest controller snapshot
+		seq.rewind();
+		seq.play(target, &out);
+	}
+}
+
+BENCHMARK(BM_MidiSeek)->Arg(10)->Arg(50)->Arg(90)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
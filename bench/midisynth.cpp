@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+#include "system.h"
+
+#ifdef WANT_FMMIDI
+
+#include <vector>
+#include "decoder_fmmidi.h"
+
+constexpr int render_seconds = 60;
+constexpr int block_samples = 1024;
+
+// Renders 60 seconds of a dense song: 16th notes on 12 melodic channels and drums
+static void RenderSong(midisynth::synthesizer& synth) {
+	std::vector<int_least16_t> out(block_samples * 2);
+	const int blocks = render_seconds * EP_MIDI_FREQ / block_samples;
+	const int blocks_per_step = 3;
+	uint32_t rnd = 1;
+
+	for (int c = 0; c < 16; ++c) {
+		synth.program_change(c, c * 8);
+		synth.control_change(c, 10, (c * 37) % 128);
+	}
+
+	for (int b = 0; b < blocks; ++b) {
+		if (b % blocks_per_step == 0) {
+			for (int c = 0; c < 13; ++c) {
+				int ch = c == 12 ? 9 : c;
+				rnd = rnd * 1103515245 + 12345;
+				int note = 36 + (rnd >> 16) % 48;
+				synth.note_off(ch, (note + 7) % 128, 64);
+				synth.note_on(ch, note, 60 + (rnd >> 24) % 60);
+			}
+		}
+		synth.synthesize(out.data(), block_samples, static_cast<float>(EP_MIDI_FREQ));
+	}
+	synth.all_sound_off_immediately();
+}
+
+static void BM_FmMidiRender(benchmark::State& state) {
+	FmMidiDecoder dec;
+	dec.synth->set_max_polyphony(static_cast<int>(state.range(0)));
+	for (auto _: state) {
+		RenderSong(*dec.synth);
+	}
+}
+
+BENCHMARK(BM_FmMidiRender)->Arg(0)->Arg(EP_FMMIDI_POLYPHONY)->Arg(32)->Unit(benchmark::kMillisecond);
+
+#endif
+
+BENCHMARK_MAIN();
@@ -1,7 +1,11 @@
 #include <benchmark/benchmark.h>
+#include <sstream>
+#include "filefinder.h"
 #include "filefinder_rtp.h"
+#include "filesystem_stream.h"
 #include "output.h"
 #include "player.h"
+#include "rtp.h"
 
 static void BM_InitRtp2k(benchmark::State& state) {
 	Output::SetLogLevel(LogLevel::Error);
@@ -35,4 +39,107 @@ static void BM_InitRtp2k3(benchmark::State& state) {
 
 BENCHMARK(BM_InitRtp2k3);
 
+// Startup of the RTP lookup with empty directory caches, as on every launch
+static void BM_InitRtp2kCold(benchmark::State& state) {
+	Output::SetLogLevel(LogLevel::Error);
+	Player::engine = Player::EngineRpg2k;
+
+	bool no_rtp_flag = false;
+	bool no_rtp_warning_flag = false;
+	for (auto _: state) {
+		FileFinder::Quit();
+		FileFinder_RTP(no_rtp_flag, no_rtp_warning_flag, "");
+	}
+
+	Player::engine = Player::EngineNone;
+	Output::SetLogLevel(LogLevel::Debug);
+}
+
+BENCHMARK(BM_InitRtp2kCold);
+
+// Same with the directory index of a previous launch
+static void BM_InitRtp2kIndexed(benchmark::State& state) {
+	Output::SetLogLevel(LogLevel::Error);
+	Player::engine = Player::EngineRpg2k;
+
+	bool no_rtp_flag = false;
+	bool no_rtp_warning_flag = false;
+
+	FileFinder::Quit();
+	Filesystem_Stream::InputStream no_index;
+	FileFinder::Root().GetOwner().LoadDirectoryIndex(no_index);
+	FileFinder_RTP(no_rtp_flag, no_rtp_warning_flag, "");
+	std::stringstream ss;
+	FileFinder::Root().GetOwner().SaveDirectoryIndex(ss);
+	std::string index = ss.str();
+
+	for (auto _: state) {
+		FileFinder::Quit();
+		std::stringstream is(index);
+		FileFinder::Root().GetOwner().LoadDirectoryIndex(is);
+		FileFinder_RTP(no_rtp_flag, no_rtp_warning_flag, "");
+	}
+
+	FileFinder::Quit();
+	Player::engine = Player::EngineNone;
+	Output::SetLogLevel(LogLevel::Debug);
+}
+
+BENCHMARK(BM_InitRtp2kIndexed);
+
+// Resolves every asset of the 2000 RTP table, as a game using the RTP heavily does
+static void LookupAll2k(const FileFinder_RTP& rtp) {
+	for (int i = 0; RTP::rtp_table_2k[i][0] != nullptr; ++i) {
+		StringView category = RTP::rtp_table_2k[i][0];
+		const char* name = RTP::rtp_table_2k[i][1];
+		if (name == nullptr) {
+			continue;
+		}
+
+		Span<const StringView> exts = FileFinder::IMG_TYPES;
+		if (category == "music") {
+			exts = FileFinder::MUSIC_TYPES;
+		} else if (category == "sound") {
+			exts = FileFinder::SOUND_TYPES;
+		}
+		auto is = rtp.Lookup(category, name, exts);
+		benchmark::DoNotOptimize(is);
+	}
+}
+
+// First lookups of a game, the RTP of the game is detected
+static void BM_LookupRtp2kCold(benchmark::State& state) {
+	Output::SetLogLevel(LogLevel::Error);
+	Player::engine = Player::EngineRpg2k;
+
+	for (auto _: state) {
+		state.PauseTiming();
+		FileFinder_RTP rtp(false, true, "");
+		state.ResumeTiming();
+		LookupAll2k(rtp);
+	}
+
+	Player::engine = Player::EngineNone;
+	Output::SetLogLevel(LogLevel::Debug);
+}
+
+BENCHMARK(BM_LookupRtp2kCold)->Unit(benchmark::kMillisecond);
+
+// Repeated lookups, e.g. after the asset cache was cleared
+static void BM_LookupRtp2kWarm(benchmark::State& state) {
+	Output::SetLogLevel(LogLevel::Error);
+	Player::engine = Player::EngineRpg2k;
+
+	FileFinder_RTP rtp(false, true, "");
+	LookupAll2k(rtp);
+	for (auto _: state) {
+		LookupAll2k(rtp);
+	}
+
+	Player::engine = Player::EngineNone;
+	Output::SetLogLevel(LogLevel::Debug);
+}
+
+BENCHMARK(BM_LookupRtp2kWarm)->Unit(benchmark::kMillisecond);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+#include "game_map.h"
+#include "game_strings.h"
+#include "game_variables.h"
+
+// 1 KiB of text with the match at the end
+static std::string MakeText(StringView filler) {
+	std::string text;
+	while (text.size() < 1000) {
+		text += ToString(filler);
+	}
+	text += "Gold: 12345";
+	return text;
+}
+
+template <typename F>
+static void BM_StringOp(benchmark::State& state, StringView filler, F&& op) {
+	// Skips the map event lookup when the result variable is written
+	Game_Map::SetNeedRefresh(true);
+
+	Game_Variables variables(Game_Variables::min_2k3, Game_Variables::max_2k3);
+	variables.SetWarning(0);
+	Game_Strings strings;
+	strings.Asg({ 1 }, MakeText(filler));
+
+	for (auto _: state) {
+		op(strings, variables);
+	}
+}
+
+static void BM_ExMatch(benchmark::State& state) {
+	BM_StringOp(state, "The quick brown fox jumps over the lazy dog. ", [](auto& strings, auto& variables) {
+		strings.ExMatch({ 1 }, "Gold: ([0-9]+)", 1, 0, 2, variables);
+	});
+}
+
+BENCHMARK(BM_ExMatch);
+
+static void BM_ExMatchUnicode(benchmark::State& state) {
+	BM_StringOp(state, "素早い茶色の狐がのろまな犬を飛び越える。", [](auto& strings, auto& variables) {
+		strings.ExMatch({ 1 }, "Gold: ([0-9]+)", 1, 0, 2, variables);
+	});
+}
+
+BENCHMARK(BM_ExMatchUnicode);
+
+static void BM_RegExReplace(benchmark::State& state) {
+	auto text = MakeText("The quick brown fox jumps over the lazy dog. ");
+	for (auto _: state) {
+		auto result = Game_Strings::RegExReplace(text, "o([a-z])", "0$1");
+		benchmark::DoNotOptimize(result.data());
+	}
+}
+
+BENCHMARK(BM_RegExReplace);
+
+// Games using thousands of string variables as a text database
+constexpr int max_strings = 5000;
+
+static Game_Strings MakeDatabase() {
+	Game_Strings strings;
+	for (int i = 1; i <= max_strings; ++i) {
+		// Mix of short names and longer descriptions
+		if (i % 4 == 0) {
+			strings.Asg({ i }, "Description of item " + std::to_string(i) + ": Restores a bit of HP");
+		} else {
+			strings.Asg({ i }, "Item" + std::to_string(i));
+		}
+	}
+	return strings;
+}
+
+static void BM_StringsGet(benchmark::State& state) {
+	auto strings = MakeDatabase();
+	uint32_t rnd = 1;
+	size_t len = 0;
+	for (auto _: state) {
+		rnd = rnd * 1103515245 + 12345;
+		len += strings.Get(1 + (rnd >> 8) % max_strings).size();
+	}
+	benchmark::DoNotOptimize(len);
+}
+
+BENCHMARK(BM_StringsGet);
+
+static void BM_StringsAsg(benchmark::State& state) {
+	auto strings = MakeDatabase();
+	uint32_t rnd = 1;
+	std::string short_value = "Potion";
+	std::string long_value = "A long description that does not fit into a small string";
+	for (auto _: state) {
+		rnd = rnd * 1103515245 + 12345;
+		strings.Asg({ static_cast<int>(1 + (rnd >> 8) % max_strings) }, (rnd & 1) ? short_value : long_value);
+	}
+}
+
+BENCHMARK(BM_StringsAsg);
+
+static void BM_StringsCat(benchmark::State& state) {
+	for (auto _: state) {
+		state.PauseTiming();
+		auto strings = MakeDatabase();
+		state.ResumeTiming();
+		for (int i = 1; i <= max_strings; ++i) {
+			strings.Cat({ i }, "!");
+		}
+	}
+}
+
+BENCHMARK(BM_StringsCat)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -64,5 +64,43 @@ static void BM_SwitchFlipRange(benchmark::State& state) {
 
 BENCHMARK(BM_SwitchFlipRange);
 
+constexpr int max_sws_large = 10000;
+
+// Unaligned ranges of different lengths in a large switch list
+static void BM_SwitchSetRangeLarge(benchmark::State& state) {
+	auto s = make(max_sws_large);
+	int len = state.range(0);
+	bool val = false;
+	for (auto _: state) {
+		s.SetRange(3, 3 + len - 1, val);
+		val = !val;
+	}
+}
+
+BENCHMARK(BM_SwitchSetRangeLarge)->Arg(10)->Arg(500)->Arg(max_sws_large - 3);
+
+static void BM_SwitchFlipRangeLarge(benchmark::State& state) {
+	auto s = make(max_sws_large);
+	int len = state.range(0);
+	for (auto _: state) {
+		s.FlipRange(3, 3 + len - 1);
+	}
+}
+
+BENCHMARK(BM_SwitchFlipRangeLarge)->Arg(10)->Arg(500)->Arg(max_sws_large - 3);
+
+static void BM_SwitchCountRange(benchmark::State& state) {
+	auto s = make(max_sws_large);
+	for (int i = 1; i <= max_sws_large; i += 3) {
+		s.Set(i, true);
+	}
+	int len = state.range(0);
+	volatile int x = 0;
+	for (auto _: state) {
+		x = s.CountRange(3, 3 + len - 1);
+	}
+}
+
+BENCHMARK(BM_SwitchCountRange)->Arg(10)->Arg(500)->Arg(max_sws_large - 3);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+#include "bitmap.h"
+#include "cache.h"
+#include "drawable_list.h"
+#include "drawable_mgr.h"
+#include "game_actors.h"
+#include "game_map.h"
+#include "game_party.h"
+#include "game_pictures.h"
+#include "game_player.h"
+#include "game_screen.h"
+#include "game_switches.h"
+#include "game_system.h"
+#include "game_variables.h"
+#include "main_data.h"
+#include "map_data.h"
+#include "tilemap_layer.h"
+#include <lcf/data.h>
+
+// A large map of a chipset-heavy game: The lower layer uses every autotile
+// variant of the blocks A, B and D.
+static std::unique_ptr<lcf::rpg::Map> MakeMap() {
+	auto map = std::make_unique<lcf::rpg::Map>();
+	map->width = 200;
+	map->height = 200;
+	map->lower_layer.resize(map->width * map->height);
+	map->upper_layer.resize(map->width * map->height, BLOCK_F);
+
+	for (int i = 0; i < map->width * map->height; ++i) {
+		if (i % 2) {
+			map->lower_layer[i] = BLOCK_D + (i / 2) % (BLOCK_D_END - BLOCK_D);
+		} else {
+			const int id = (i / 2) % BLOCK_C;
+			map->lower_layer[i] = (id % 50 < 47 && (id % 1000) / 50 < 16) ? id : BLOCK_A;
+		}
+	}
+	return map;
+}
+
+static void SetupMap() {
+	lcf::Data::data = {};
+	lcf::Data::terrains.push_back({});
+	lcf::Data::chipsets.push_back({});
+	auto& chipset = lcf::Data::chipsets.back();
+	chipset.passable_data_lower.resize(162, 0xF);
+	chipset.passable_data_upper.resize(162, 0xF);
+	chipset.terrain_data.resize(144, 1);
+
+	lcf::Data::treemap.maps.push_back(lcf::rpg::MapInfo());
+	lcf::Data::treemap.maps.back().type = lcf::rpg::TreeMap::MapType_root;
+	lcf::Data::treemap.maps.push_back(lcf::rpg::MapInfo());
+	lcf::Data::treemap.maps.back().ID = 1;
+	lcf::Data::treemap.maps.back().type = lcf::rpg::TreeMap::MapType_map;
+
+	Main_Data::game_actors = std::make_unique<Game_Actors>();
+	Main_Data::game_party = std::make_unique<Game_Party>();
+	Game_Map::Init();
+	Main_Data::game_system = std::make_unique<Game_System>();
+	Main_Data::game_switches = std::make_unique<Game_Switches>();
+	Main_Data::game_variables = std::make_unique<Game_Variables>(Game_Variables::min_2k3, Game_Variables::max_2k3);
+	Main_Data::game_pictures = std::make_unique<Game_Pictures>();
+	Main_Data::game_screen = std::make_unique<Game_Screen>();
+	Main_Data::game_player = std::make_unique<Game_Player>();
+	Main_Data::game_player->SetMapId(1);
+
+	Game_Map::Setup(MakeMap());
+}
+
+static void TeardownMap() {
+	Main_Data::game_switches = {};
+	Main_Data::game_variables = {};
+	Main_Data::game_player = {};
+	Main_Data::game_screen = {};
+	Main_Data::game_pictures = {};
+	Game_Map::Quit();
+	Main_Data::game_party = {};
+	Main_Data::game_actors = {};
+	Main_Data::game_system = {};
+	lcf::Data::data = {};
+	Cache::Clear();
+}
+
+// Map setup followed by the first frame, the whole screen is scrolled over the map
+static void MapTransition(benchmark::State& state, bool shared) {
+	SetupMap();
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+
+	auto chipset = Bitmap::Create(480, 256);
+	chipset->SetId("ChipSet/bench");
+	auto screen = Bitmap::Create(320, 240);
+
+	for (auto _: state) {
+		if (!shared) {
+			Cache::Clear();
+		}
+
+		TilemapLayer layer(0);
+		layer.SetWidth(Game_Map::GetTilesX());
+		layer.SetHeight(Game_Map::GetTilesY());
+		layer.SetChipset(chipset);
+		layer.SetMapData(Game_Map::GetMapDataDown());
+		for (int y = 0; y < Game_Map::GetTilesY() * TILE_SIZE; y += 240) {
+			for (int x = 0; x < Game_Map::GetTilesX() * TILE_SIZE; x += 320) {
+				layer.SetOx(x);
+				layer.SetOy(y);
+				layer.Draw(*screen, TilemapLayer::TileBelow, 0, 0);
+			}
+		}
+	}
+
+	DrawableMgr::SetLocalList(nullptr);
+	TeardownMap();
+}
+
+// Every map composes its autotiles again
+static void BM_MapTransitionCold(benchmark::State& state) {
+	MapTransition(state, false);
+}
+
+BENCHMARK(BM_MapTransitionCold);
+
+// The autotile atlas of the chipset is shared with the previous map
+static void BM_MapTransitionShared(benchmark::State& state) {
+	MapTransition(state, true);
+}
+
+BENCHMARK(BM_MapTransitionShared);
+
+BENCHMARK_MAIN();
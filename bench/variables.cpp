@@ -124,4 +124,73 @@ static void BM_VariableSetRangeRandom(benchmark::State& state) {
 
 BENCHMARK(BM_VariableSetRangeRandom);
 
+static void BM_VariableBitOrRange(benchmark::State& state) {
+	BM_VariableOp(state, [](auto& v, auto, auto val) { v.BitOrRange(1, max_vars, val); });
+}
+
+BENCHMARK(BM_VariableBitOrRange);
+
+static void BM_VariableAddArray(benchmark::State& state) {
+	BM_VariableOp(state, [](auto& v, auto, auto) { v.AddArray(1, max_vars / 2, max_vars / 2 + 1); });
+}
+
+BENCHMARK(BM_VariableAddArray);
+
+static void BM_VariableMultArray(benchmark::State& state) {
+	BM_VariableOp(state, [](auto& v, auto, auto) { v.MultArray(1, max_vars / 2, max_vars / 2 + 1); });
+}
+
+BENCHMARK(BM_VariableMultArray);
+
+// Games using variables as large arrays, alternating signs keep values from saturating
+constexpr int max_vars_large = 10000;
+
+template <typename F>
+static void BM_VariableLargeOp(benchmark::State& state, F&& op) {
+	auto v = make(max_vars_large);
+	int len = state.range(0);
+	int i = 0;
+	for (auto _: state) {
+		op(v, len, (i & 1) ? 3 : -3);
+		++i;
+	}
+	state.SetItemsProcessed(state.iterations() * len);
+}
+
+static void BM_VariableSetRangeLarge(benchmark::State& state) {
+	BM_VariableLargeOp(state, [](auto& v, int len, auto val) { v.SetRange(1, len, val); });
+}
+
+BENCHMARK(BM_VariableSetRangeLarge)->Arg(100)->Arg(max_vars_large);
+
+static void BM_VariableAddRangeLarge(benchmark::State& state) {
+	BM_VariableLargeOp(state, [](auto& v, int len, auto val) { v.AddRange(1, len, val); });
+}
+
+BENCHMARK(BM_VariableAddRangeLarge)->Arg(100)->Arg(max_vars_large);
+
+static void BM_VariableSubRangeLarge(benchmark::State& state) {
+	BM_VariableLargeOp(state, [](auto& v, int len, auto val) { v.SubRange(1, len, val); });
+}
+
+BENCHMARK(BM_VariableSubRangeLarge)->Arg(100)->Arg(max_vars_large);
+
+static void BM_VariableMultRangeLarge(benchmark::State& state) {
+	BM_VariableLargeOp(state, [](auto& v, int len, auto val) { v.MultRange(1, len, val < 0 ? -1 : 1); });
+}
+
+BENCHMARK(BM_VariableMultRangeLarge)->Arg(100)->Arg(max_vars_large);
+
+static void BM_VariableBitXorRangeLarge(benchmark::State& state) {
+	BM_VariableLargeOp(state, [](auto& v, int len, auto val) { v.BitXorRange(1, len, val); });
+}
+
+BENCHMARK(BM_VariableBitXorRangeLarge)->Arg(100)->Arg(max_vars_large);
+
+static void BM_VariableAddArrayLarge(benchmark::State& state) {
+	BM_VariableLargeOp(state, [](auto& v, int len, auto) { v.SubArray(1, len / 2, len / 2 + 1); v.AddArray(1, len / 2, len / 2 + 1); });
+}
+
+BENCHMARK(BM_VariableAddArrayLarge)->Arg(100)->Arg(max_vars_large);
+
 BENCHMARK_MAIN();
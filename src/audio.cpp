@@ -23,16 +23,26 @@
 #include "player.h"
 #include "game_clock.h"
 
+namespace {
+	std::unique_ptr<AudioInterface> audio_override;
+}
+
 AudioInterface& Audio() {
 	static Game_ConfigAudio cfg;
 	static EmptyAudio default_(cfg);
 #ifdef SUPPORT_AUDIO
+	if (audio_override)
+		return *audio_override;
 	if (!Player::no_audio_flag && DisplayUi)
 		return DisplayUi->GetAudio();
 #endif
 	return default_;
 }
 
+void SetAudioOverride(std::unique_ptr<AudioInterface> audio) {
+	audio_override = std::move(audio);
+}
+
 void EmptyAudio::BGM_Play(Filesystem_Stream::InputStream, int, int, int) {
 	bgm_starttick = Player::GetFrames();
 	playing = true;
@@ -19,6 +19,7 @@
 #define EP_AUDIO_H
 
 // Headers
+#include <memory>
 #include <string>
 #include "audio_generic_midiout.h"
 #include "filesystem_stream.h"
@@ -186,4 +187,12 @@ private:
 
 AudioInterface& Audio();
 
+/**
+ * Replaces the audio of the UI, e.g. with an offline renderer.
+ * The previous override is destroyed.
+ *
+ * @param audio audio to use or nullptr to use the audio of the UI again
+ */
+void SetAudioOverride(std::unique_ptr<AudioInterface> audio);
+
 #endif
@@ -17,6 +17,9 @@
 
 #include <array>
 #include <algorithm>
+#include <list>
+#include <mutex>
+#include <zlib.h>
 #include "audio.h"
 #include "audio_decoder_midi.h"
 #include "midisequencer.h"
@@ -119,6 +122,43 @@ AudioDecoderMidi::~AudioDecoderMidi() {
 	reset();
 }
 
+namespace {
+	/**
+	 * Parsed event streams of recently played MIDI files.
+	 * Games often alternate between a few songs on map transitions, this
+	 * avoids parsing them again.
+	 */
+	struct MidiCacheEntry {
+		uint32_t crc;
+		std::vector<uint8_t> file;
+		std::shared_ptr<const midisequencer::song> song;
+	};
+
+	constexpr size_t midi_cache_size = 8;
+	std::list<MidiCacheEntry> midi_cache;
+	std::mutex midi_cache_mutex;
+
+	std::shared_ptr<const midisequencer::song> GetCachedSong(const std::vector<uint8_t>& file, uint32_t crc) {
+		std::lock_guard<std::mutex> lock(midi_cache_mutex);
+		for (auto it = midi_cache.begin(); it != midi_cache.end(); ++it) {
+			if (it->crc == crc && it->file == file) {
+				// Move to the front (most recently used)
+				midi_cache.splice(midi_cache.begin(), midi_cache, it);
+				return it->song;
+			}
+		}
+		return nullptr;
+	}
+
+	void AddCachedSong(const std::vector<uint8_t>& file, uint32_t crc, std::shared_ptr<const midisequencer::song> song) {
+		std::lock_guard<std::mutex> lock(midi_cache_mutex);
+		midi_cache.push_front({crc, file, std::move(song)});
+		if (midi_cache.size() > midi_cache_size) {
+			midi_cache.pop_back();
+		}
+	}
+}
+
 static int read_func(void* instance) {
 	AudioDecoderMidi* midi = reinterpret_cast<AudioDecoderMidi*>(instance);
 
@@ -137,9 +177,15 @@ bool AudioDecoderMidi::Open(Filesystem_Stream::InputStream stream) {
 	file_buffer = Utils::ReadStream(stream);
 	loop_count = 0;
 
-	if (!seq->load(this, read_func)) {
-		error_message = "Midi: Error reading file";
-		return false;
+	uint32_t crc = crc32(0L, file_buffer.data(), file_buffer.size());
+	if (auto song = GetCachedSong(file_buffer, crc)) {
+		seq->load(std::move(song));
+	} else {
+		if (!seq->load(this, read_func)) {
+			error_message = "Midi: Error reading file";
+			return false;
+		}
+		AddCachedSong(file_buffer, crc, seq->get_song_data());
 	}
 
 	seq->rewind();
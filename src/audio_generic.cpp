@@ -19,9 +19,12 @@
 
 #include <cstring>
 #include <cassert>
+#include <algorithm>
 #include <memory>
 #include "audio_generic.h"
+#include "instrumentation.h"
 #include "output.h"
+#include "player.h"
 
 GenericAudio::GenericAudio(const Game_ConfigAudio& cfg) : AudioInterface(cfg) {
 	int i = 0;
@@ -30,12 +33,7 @@ GenericAudio::GenericAudio(const Game_ConfigAudio& cfg) : AudioInterface(cfg) {
 		BGM_Channel.decoder.reset();
 		BGM_Channel.instance = this;
 	}
-	i = 0;
-	for (auto& SE_Channel : SE_Channels) {
-		SE_Channel.id = i++;
-		SE_Channel.decoder.reset();
-		SE_Channel.instance = this;
-	}
+	SE_Channels.reserve(max_se_channels);
 	BGM_PlayedOnceIndicator = false;
 	midi_thread.reset();
 
@@ -177,21 +175,83 @@ void GenericAudio::SE_Play(std::unique_ptr<AudioSeCache> se, int volume, int pit
 		return;
 	}
 
+	// Logical frame and not the frame time, which is shared by all frames of a fast forward step
+	auto frame = Player::GetFrames();
+	std::string name = ToString(se->GetName());
+
+	LockMutex();
 	for (auto& SE_Channel : SE_Channels) {
-		if (!SE_Channel.decoder) {
-			//If there is an unused se channel
-			PlayOnChannel(SE_Channel, std::move(se), volume, pitch);
+		if (SE_Channel.decoder && SE_Channel.frame == frame && SE_Channel.pitch == pitch && SE_Channel.name == name) {
+			// The same SE was already started this frame: Playing it twice only makes it louder
+			if (volume > SE_Channel.volume) {
+				SE_Channel.volume = volume;
+				SE_Channel.decoder->SetVolume(volume);
+			}
+			UnlockMutex();
 			return;
 		}
 	}
-	// FIXME Not displaying as warning because multiple games exhaust free channels available, see #1356
-	Output::Debug("Couldn't play {} SE. No free channel available", se->GetName());
+	UnlockMutex();
+
+	// Create the decoder without holding the lock to not stall the audio thread
+	SeChannel chan;
+	chan.decoder = se->CreateSeDecoder();
+	chan.decoder->SetPitch(pitch);
+	chan.decoder->SetFormat(output_format.frequency, output_format.format, output_format.channels);
+	chan.decoder->SetVolume(volume);
+	chan.name = name;
+	chan.volume = volume;
+	chan.pitch = pitch;
+	chan.frame = frame;
+
+	LockMutex();
+	auto result = AddSeChannel(chan);
+	UnlockMutex();
+
+	if (result == SeAddResult::Dropped) {
+		// FIXME Not displaying as warning because multiple games exhaust free channels available, see #1356
+		Output::Debug("Couldn't play {} SE. No free channel available", name);
+	} else if (result == SeAddResult::Replaced) {
+		Output::Debug("SE {} replaces {}. No free channel available", name, chan.name);
+	}
 }
 
-void GenericAudio::SE_Stop() {
-	for (auto& SE_Channel : SE_Channels) {
-		SE_Channel.stopped = true; //Stop all running sound effects
+GenericAudio::SeAddResult GenericAudio::AddSeChannel(SeChannel& chan) {
+	chan.serial = se_serial++;
+
+	if (SE_Channels.size() < max_se_channels) {
+		// Lowest free voice id
+		uint32_t used = 0;
+		for (auto& SE_Channel : SE_Channels) {
+			used |= 1u << SE_Channel.id;
+		}
+		chan.id = 0;
+		while (used & (1u << chan.id)) {
+			++chan.id;
+		}
+		SE_Channels.push_back(std::move(chan));
+		return SeAddResult::Added;
+	}
+
+	// Steal the quietest voice, the oldest one when multiple are equally quiet
+	auto victim = std::min_element(SE_Channels.begin(), SE_Channels.end(), [](const SeChannel& a, const SeChannel& b) {
+		return a.volume < b.volume || (a.volume == b.volume && a.serial < b.serial);
+	});
+
+	Instrumentation::AudioSeDropped();
+	if (victim->volume > chan.volume) {
+		return SeAddResult::Dropped;
 	}
+	chan.id = victim->id;
+	std::swap(*victim, chan);
+	return SeAddResult::Replaced;
+}
+
+void GenericAudio::SE_Stop() {
+	LockMutex();
+	// Stop all running sound effects
+	SE_Channels.clear();
+	UnlockMutex();
 }
 
 void GenericAudio::Update() {
@@ -278,22 +338,12 @@ bool GenericAudio::PlayOnChannel(BgmChannel& chan, Filesystem_Stream::InputStrea
 	return false;
 }
 
-bool GenericAudio::PlayOnChannel(SeChannel& chan, std::unique_ptr<AudioSeCache> se, int volume, int pitch) {
-	chan.paused = true; // Pause channel so the audio thread doesn't work on it
-	chan.stopped = false; // Unstop channel so the audio thread doesn't delete it
-
-	chan.decoder = se->CreateSeDecoder();
-	chan.decoder->SetPitch(pitch);
-	chan.decoder->SetFormat(output_format.frequency, output_format.format, output_format.channels);
-	chan.decoder->SetVolume(volume);
-	chan.paused = false; // Unpause channel -> Play it.
-	return true;
-}
-
 void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
+	auto decode_begin = Game_Clock::now();
 	bool channel_active = false;
 	float total_volume = 0;
 	int samples_per_frame = buffer_length / output_format.channels / 2;
+	int se_active = static_cast<int>(SE_Channels.size());
 
 	assert(buffer_length > 0);
 
@@ -309,7 +359,8 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 	}
 	std::fill(mixer_buffer.begin(), mixer_buffer.end(), '\0');
 
-	for (unsigned i = 0; i < nr_of_bgm_channels + nr_of_se_channels; i++) {
+	// Only active SE voices are mixed, finished voices are removed afterwards
+	for (unsigned i = 0; i < nr_of_bgm_channels + SE_Channels.size(); i++) {
 		int read_bytes = 0;
 		int channels = 0;
 		int samplesize = 0;
@@ -340,7 +391,9 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 					unsigned bytes_to_read = (samplesize * channels * samples_per_frame);
 					bytes_to_read = (bytes_to_read < scrap_buffer_size) ? bytes_to_read : scrap_buffer_size;
 
+					auto channel_begin = Game_Clock::now();
 					read_bytes = currently_mixed_channel.decoder->Decode(scrap_buffer.data(), bytes_to_read);
+					Instrumentation::AudioChannelDecoded(currently_mixed_channel.id, Game_Clock::now() - channel_begin);
 
 					if (read_bytes <= 0) {
 						// An error occured when reading - the channel is faulty - discard
@@ -359,36 +412,34 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 			SeChannel& currently_mixed_channel = SE_Channels[i - nr_of_bgm_channels];
 			float current_master_volume = cfg.sound_volume.Get() / 100.0f;
 
-			if (currently_mixed_channel.decoder && !currently_mixed_channel.paused) {
-				if (currently_mixed_channel.stopped) {
-					currently_mixed_channel.decoder.reset();
-				} else {
-					volume = current_master_volume * (currently_mixed_channel.decoder->GetVolume() / 100.0);
-					currently_mixed_channel.decoder->GetFormat(frequency, sampleformat, channels);
-					samplesize = AudioDecoder::GetSamplesizeForFormat(sampleformat);
+			if (currently_mixed_channel.decoder) {
+				volume = current_master_volume * (currently_mixed_channel.decoder->GetVolume() / 100.0);
+				currently_mixed_channel.decoder->GetFormat(frequency, sampleformat, channels);
+				samplesize = AudioDecoder::GetSamplesizeForFormat(sampleformat);
 
-					total_volume += volume;
+				total_volume += volume;
 
-					// determine how much data has to be read from this channel (but cap at the bounds of the scrap buffer)
-					unsigned bytes_to_read = (samplesize * channels * samples_per_frame);
-					bytes_to_read = (bytes_to_read < scrap_buffer_size) ? bytes_to_read : scrap_buffer_size;
+				// determine how much data has to be read from this channel (but cap at the bounds of the scrap buffer)
+				unsigned bytes_to_read = (samplesize * channels * samples_per_frame);
+				bytes_to_read = (bytes_to_read < scrap_buffer_size) ? bytes_to_read : scrap_buffer_size;
 
-					read_bytes = currently_mixed_channel.decoder->Decode(scrap_buffer.data(), bytes_to_read);
-
-					if (read_bytes <= 0) {
-						// An error occured when reading - the channel is faulty - discard
-						currently_mixed_channel.decoder.reset();
-						continue; // skip this loop run - there is nothing to mix
-					}
+				auto channel_begin = Game_Clock::now();
+				read_bytes = currently_mixed_channel.decoder->Decode(scrap_buffer.data(), bytes_to_read);
+				Instrumentation::AudioChannelDecoded(nr_of_bgm_channels + currently_mixed_channel.id, Game_Clock::now() - channel_begin);
 
-					// Now decide what to do when a channel has reached its end
-					if (currently_mixed_channel.decoder->IsFinished()) {
-						// SE are only played once so free the se if finished
-						currently_mixed_channel.decoder.reset();
-					}
+				if (read_bytes <= 0) {
+					// An error occured when reading - the channel is faulty - discard
+					currently_mixed_channel.decoder.reset();
+					continue; // skip this loop run - there is nothing to mix
+				}
 
-					channel_used = true;
+				// Now decide what to do when a channel has reached its end
+				if (currently_mixed_channel.decoder->IsFinished()) {
+					// SE are only played once so free the se if finished
+					currently_mixed_channel.decoder.reset();
 				}
+
+				channel_used = true;
 			}
 		}
 
@@ -481,6 +532,13 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 	} else {
 		memset(output_buffer, '\0', buffer_length);
 	}
+
+	SE_Channels.erase(std::remove_if(SE_Channels.begin(), SE_Channels.end(), [](const SeChannel& chan) {
+		return !chan.decoder;
+	}), SE_Channels.end());
+
+	Instrumentation::AudioSeChannels(se_active, max_se_channels);
+	Instrumentation::AudioCallback(decode_begin, Game_Clock::now(), samples_per_frame, output_format.frequency);
 }
 
 void GenericAudio::BgmChannel::Stop() {
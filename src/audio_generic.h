@@ -22,7 +22,9 @@
 #include "audio_secache.h"
 #include "audio_decoder_base.h"
 #include "audio_generic_midiout.h"
+#include "game_clock.h"
 #include <memory>
+#include <vector>
 
 /**
  * A software implementation for handling EasyRPG Audio utilizing the
@@ -86,12 +88,18 @@ private:
 		void SetPitch(int pitch);
 		bool IsUsed() const;
 	};
+	/** A playing sound effect. Only active voices are stored. */
 	struct SeChannel {
-		int id;
 		std::unique_ptr<AudioDecoderBase> decoder;
-		GenericAudio* instance = nullptr;
-		bool paused;
-		bool stopped;
+		std::string name;
+		int volume = 0;
+		int pitch = 0;
+		/** Start order, used to find the oldest voice */
+		uint64_t serial = 0;
+		/** Voice id, stable while the voice plays */
+		int id = 0;
+		/** Logical frame in which the SE was started, used for coalescing */
+		int frame = -1;
 	};
 	struct Format {
 		int frequency;
@@ -101,13 +109,42 @@ private:
 	Format output_format = {};
 
 	bool PlayOnChannel(BgmChannel& chan, Filesystem_Stream::InputStream stream, int volume, int pitch, int fadein);
-	bool PlayOnChannel(SeChannel& chan, std::unique_ptr<AudioSeCache> se, int volume, int pitch);
 
-	static constexpr unsigned nr_of_se_channels = 31;
+	enum class SeAddResult {
+		/** The voice was added to the pool */
+		Added,
+		/** The voice replaced a quieter one, which is returned in chan */
+		Replaced,
+		/** All voices are louder, chan was not added */
+		Dropped
+	};
+
+	/**
+	 * Adds a voice to the SE pool. When the pool is full the voice with the
+	 * lowest volume is stolen, the oldest one on ties.
+	 * Must be called with the mutex locked. Logging and destroying the
+	 * stolen voice is left to the caller to do after unlocking.
+	 *
+	 * @param chan voice to add, receives the stolen voice when replaced
+	 * @return whether the voice was added, replaced another one or dropped
+	 */
+	SeAddResult AddSeChannel(SeChannel& chan);
+
+	/**
+	 * Maximum number of sound effects playing at once.
+	 * Bounds the mixing work per buffer when a game starts sound effects
+	 * faster than they end (e.g. from parallel events every frame).
+	 * Games rarely have more than a few audible at once, so the quietest
+	 * voice is stolen instead. Voice ids are tracked in a 32 bit mask.
+	 */
+	static constexpr unsigned max_se_channels = 32;
+	static_assert(max_se_channels <= 32, "Voice ids are tracked in a 32 bit mask");
 	static constexpr unsigned nr_of_bgm_channels = 2;
 
 	BgmChannel BGM_Channels[nr_of_bgm_channels];
-	SeChannel SE_Channels[nr_of_se_channels];
+	/** Active sound effect voices, idle voices are removed */
+	std::vector<SeChannel> SE_Channels;
+	uint64_t se_serial = 0;
 	mutable bool BGM_PlayedOnceIndicator;
 
 	std::vector<int16_t> sample_buffer = {};
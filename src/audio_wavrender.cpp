@@ -0,0 +1,122 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "audio_wavrender.h"
+
+#ifdef WANT_DRWAV
+
+#include "filefinder.h"
+#include "output.h"
+
+namespace {
+	constexpr int render_frequency = 44100;
+	constexpr int render_channels = 2;
+
+	size_t write_func(void* userdata, const void* data, size_t bytes) {
+		auto* f = reinterpret_cast<Filesystem_Stream::OutputStream*>(userdata);
+		f->write(reinterpret_cast<const char*>(data), bytes);
+		return f->good() ? bytes : 0;
+	}
+
+	drwav_bool32 seek_func(void* userdata, int offset, drwav_seek_origin origin) {
+		auto* f = reinterpret_cast<Filesystem_Stream::OutputStream*>(userdata);
+		f->seekp(offset, Filesystem_Stream::CSeekdirToCppSeekdir(origin));
+		return f->good() ? DRWAV_TRUE : DRWAV_FALSE;
+	}
+}
+
+std::unique_ptr<WavRenderAudio> WavRenderAudio::Create(const Game_ConfigAudio& cfg, StringView path) {
+	auto stream = FileFinder::Root().OpenOutputStream(path, std::ios_base::binary | std::ios_base::out | std::ios_base::trunc);
+	if (!stream) {
+		Output::Warning("Audio render: Cannot open {} for writing", path);
+		return nullptr;
+	}
+
+	auto audio = std::make_unique<WavRenderAudio>(cfg, std::move(stream));
+	if (!audio->init) {
+		Output::Warning("Audio render: Cannot write WAV header to {}", path);
+		return nullptr;
+	}
+
+	Output::Debug("Audio render: Writing to {}", path);
+	return audio;
+}
+
+WavRenderAudio::WavRenderAudio(const Game_ConfigAudio& cfg, Filesystem_Stream::OutputStream stream_) :
+	GenericAudio(cfg), stream(std::move(stream_)) {
+	// Not deterministic and cannot be captured
+	this->cfg.native_midi.Set(false);
+
+	SetFormat(render_frequency, AudioDecoder::Format::S16, render_channels);
+
+	drwav_data_format format;
+	format.container = drwav_container_riff;
+	format.format = DR_WAVE_FORMAT_PCM;
+	format.channels = render_channels;
+	format.sampleRate = render_frequency;
+	format.bitsPerSample = 16;
+
+	init = drwav_init_write(&handle, &format, write_func, seek_func, &stream, nullptr) == DRWAV_TRUE;
+}
+
+WavRenderAudio::~WavRenderAudio() {
+	if (!init) {
+		return;
+	}
+
+	drwav_uninit(&handle);
+	stream.Close();
+
+	auto seconds = std::chrono::duration_cast<std::chrono::duration<double>>(decode_time).count();
+	Output::Debug("Audio render: {} frames decoded in {:.3f}s ({:.0f} frames/s)",
+		rendered_frames, seconds, seconds > 0 ? rendered_frames / seconds : 0.0);
+}
+
+void WavRenderAudio::Update() {
+	GenericAudio::Update();
+
+	if (!init) {
+		return;
+	}
+
+	// Derive the target from the frame counter to avoid rounding drift
+	++update_count;
+	int64_t target_frames = update_count * render_frequency / static_cast<int64_t>(Game_Clock::GetTargetGameFps());
+	int frames = static_cast<int>(target_frames - rendered_frames);
+	if (frames <= 0) {
+		return;
+	}
+
+	int bytes = frames * render_channels * sizeof(int16_t);
+	if (buffer.size() < static_cast<size_t>(bytes)) {
+		buffer.resize(bytes);
+	}
+
+	auto start = Game_Clock::now();
+	Decode(buffer.data(), bytes);
+	decode_time += Game_Clock::now() - start;
+
+	if (drwav_write_pcm_frames(&handle, frames, buffer.data()) != static_cast<drwav_uint64>(frames)) {
+		Output::Warning("Audio render: Write failed, stopping");
+		drwav_uninit(&handle);
+		init = false;
+	}
+	rendered_frames = target_frames;
+}
+
+#endif
@@ -0,0 +1,81 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_AUDIO_WAVRENDER_H
+#define EP_AUDIO_WAVRENDER_H
+
+#include "system.h"
+#ifdef WANT_DRWAV
+
+// Headers
+#include <memory>
+#include <string>
+#include <vector>
+#include "audio_generic.h"
+#include "game_clock.h"
+#include "decoder_drwav.h"
+
+/**
+ * Offline audio output: Instead of being driven by the callback of an audio
+ * device the mixer is invoked once per game frame and the mixed stream is
+ * written to a WAV file.
+ *
+ * Because the amount of decoded samples only depends on the frame counter
+ * the output is reproducible, e.g. when used together with --replay-input.
+ * Native MIDI is disabled as it cannot be captured.
+ */
+class WavRenderAudio : public GenericAudio {
+public:
+	/**
+	 * Creates a renderer writing to the file at path.
+	 *
+	 * @param cfg audio configuration
+	 * @param path path of the WAV file
+	 * @return renderer or nullptr when the file cannot be written
+	 */
+	static std::unique_ptr<WavRenderAudio> Create(const Game_ConfigAudio& cfg, StringView path);
+
+	WavRenderAudio(const Game_ConfigAudio& cfg, Filesystem_Stream::OutputStream stream);
+	~WavRenderAudio() override;
+
+	/** Decodes the samples of one game frame and appends them to the file. */
+	void Update() override;
+
+	void LockMutex() const override {}
+	void UnlockMutex() const override {}
+
+	/** @return amount of sample frames written so far */
+	int64_t GetRenderedFrames() const;
+
+private:
+	Filesystem_Stream::OutputStream stream;
+	drwav handle = {};
+	bool init = false;
+
+	std::vector<uint8_t> buffer;
+	int64_t update_count = 0;
+	int64_t rendered_frames = 0;
+	Game_Clock::duration decode_time = {};
+};
+
+inline int64_t WavRenderAudio::GetRenderedFrames() const {
+	return rendered_frames;
+}
+
+#endif
+
+#endif
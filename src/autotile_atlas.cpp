@@ -0,0 +1,365 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include "autotile_atlas.h"
+#include "bitmap.h"
+#include "options.h"
+#include "output.h"
+
+// Blocks subtiles IDs
+// Mess with this code and you will die in 3 days...
+// [tile-id][row][col]
+static constexpr int8_t BlockA_Subtiles_IDS[47][2][2] = {
+#define N -1
+	{{N, N}, {N, N}},
+	{{3, N}, {N, N}},
+	{{N, 3}, {N, N}},
+	{{3, 3}, {N, N}},
+	{{N, N}, {N, 3}},
+	{{3, N}, {N, 3}},
+	{{N, 3}, {N, 3}},
+	{{3, 3}, {N, 3}},
+	{{N, N}, {3, N}},
+	{{3, N}, {3, N}},
+	{{N, 3}, {3, N}},
+	{{3, 3}, {3, N}},
+	{{N, N}, {3, 3}},
+	{{3, N}, {3, 3}},
+	{{N, 3}, {3, 3}},
+	{{3, 3}, {3, 3}},
+	{{1, N}, {1, N}},
+	{{1, 3}, {1, N}},
+	{{1, N}, {1, 3}},
+	{{1, 3}, {1, 3}},
+	{{2, 2}, {N, N}},
+	{{2, 2}, {N, 3}},
+	{{2, 2}, {3, N}},
+	{{2, 2}, {3, 3}},
+	{{N, 1}, {N, 1}},
+	{{N, 1}, {3, 1}},
+	{{3, 1}, {N, 1}},
+	{{3, 1}, {3, 1}},
+	{{N, N}, {2, 2}},
+	{{3, N}, {2, 2}},
+	{{N, 3}, {2, 2}},
+	{{3, 3}, {2, 2}},
+	{{1, 1}, {1, 1}},
+	{{2, 2}, {2, 2}},
+	{{0, 2}, {1, N}},
+	{{0, 2}, {1, 3}},
+	{{2, 0}, {N, 1}},
+	{{2, 0}, {3, 1}},
+	{{N, 1}, {2, 0}},
+	{{3, 1}, {2, 0}},
+	{{1, N}, {0, 2}},
+	{{1, 3}, {0, 2}},
+	{{0, 0}, {1, 1}},
+	{{0, 2}, {0, 2}},
+	{{1, 1}, {0, 0}},
+	{{2, 0}, {2, 0}},
+	{{0, 0}, {0, 0}}
+#undef N
+};
+
+// [tile-id][row][col][x/y]
+static constexpr uint8_t BlockD_Subtiles_IDS[50][2][2][2] = {
+//     T-L     T-R       B-L     B-R
+    {{{1, 2}, {1, 2}}, {{1, 2}, {1, 2}}},
+    {{{2, 0}, {1, 2}}, {{1, 2}, {1, 2}}},
+    {{{1, 2}, {2, 0}}, {{1, 2}, {1, 2}}},
+    {{{2, 0}, {2, 0}}, {{1, 2}, {1, 2}}},
+    {{{1, 2}, {1, 2}}, {{1, 2}, {2, 0}}},
+    {{{2, 0}, {1, 2}}, {{1, 2}, {2, 0}}},
+    {{{1, 2}, {2, 0}}, {{1, 2}, {2, 0}}},
+    {{{2, 0}, {2, 0}}, {{1, 2}, {2, 0}}},
+    {{{1, 2}, {1, 2}}, {{2, 0}, {1, 2}}},
+    {{{2, 0}, {1, 2}}, {{2, 0}, {1, 2}}},
+    {{{1, 2}, {2, 0}}, {{2, 0}, {1, 2}}},
+    {{{2, 0}, {2, 0}}, {{2, 0}, {1, 2}}},
+    {{{1, 2}, {1, 2}}, {{2, 0}, {2, 0}}},
+    {{{2, 0}, {1, 2}}, {{2, 0}, {2, 0}}},
+    {{{1, 2}, {2, 0}}, {{2, 0}, {2, 0}}},
+    {{{2, 0}, {2, 0}}, {{2, 0}, {2, 0}}},
+    {{{0, 2}, {0, 2}}, {{0, 2}, {0, 2}}},
+    {{{0, 2}, {2, 0}}, {{0, 2}, {0, 2}}},
+    {{{0, 2}, {0, 2}}, {{0, 2}, {2, 0}}},
+    {{{0, 2}, {2, 0}}, {{0, 2}, {2, 0}}},
+    {{{1, 1}, {1, 1}}, {{1, 1}, {1, 1}}},
+    {{{1, 1}, {1, 1}}, {{1, 1}, {2, 0}}},
+    {{{1, 1}, {1, 1}}, {{2, 0}, {1, 1}}},
+    {{{1, 1}, {1, 1}}, {{2, 0}, {2, 0}}},
+    {{{2, 2}, {2, 2}}, {{2, 2}, {2, 2}}},
+    {{{2, 2}, {2, 2}}, {{2, 0}, {2, 2}}},
+    {{{2, 0}, {2, 2}}, {{2, 2}, {2, 2}}},
+    {{{2, 0}, {2, 2}}, {{2, 0}, {2, 2}}},
+    {{{1, 3}, {1, 3}}, {{1, 3}, {1, 3}}},
+    {{{2, 0}, {1, 3}}, {{1, 3}, {1, 3}}},
+    {{{1, 3}, {2, 0}}, {{1, 3}, {1, 3}}},
+    {{{2, 0}, {2, 0}}, {{1, 3}, {1, 3}}},
+    {{{0, 2}, {2, 2}}, {{0, 2}, {2, 2}}},
+    {{{1, 1}, {1, 1}}, {{1, 3}, {1, 3}}},
+    {{{0, 1}, {0, 1}}, {{0, 1}, {0, 1}}},
+    {{{0, 1}, {0, 1}}, {{0, 1}, {2, 0}}},
+    {{{2, 1}, {2, 1}}, {{2, 1}, {2, 1}}},
+    {{{2, 1}, {2, 1}}, {{2, 0}, {2, 1}}},
+    {{{2, 3}, {2, 3}}, {{2, 3}, {2, 3}}},
+    {{{2, 0}, {2, 3}}, {{2, 3}, {2, 3}}},
+    {{{0, 3}, {0, 3}}, {{0, 3}, {0, 3}}},
+    {{{0, 3}, {2, 0}}, {{0, 3}, {0, 3}}},
+    {{{0, 1}, {2, 1}}, {{0, 1}, {2, 1}}},
+    {{{0, 1}, {0, 1}}, {{0, 3}, {0, 3}}},
+    {{{0, 3}, {2, 3}}, {{0, 3}, {2, 3}}},
+    {{{2, 1}, {2, 1}}, {{2, 3}, {2, 3}}},
+    {{{0, 1}, {2, 1}}, {{0, 3}, {2, 3}}},
+    {{{1, 2}, {1, 2}}, {{1, 2}, {1, 2}}},
+    {{{1, 2}, {1, 2}}, {{1, 2}, {1, 2}}},
+    {{{0, 0}, {0, 0}}, {{0, 0}, {0, 0}}}
+};
+
+// Number of tone effects kept per atlas
+static constexpr int max_tone_effects = 4;
+
+// Atlas rows allocated for the first tile
+static constexpr int min_rows = 4;
+
+AutotileAtlas::AutotileAtlas(BitmapRef chipset) :
+	chipset(std::move(chipset))
+{
+	id = ToString(this->chipset->GetId());
+}
+
+void AutotileAtlas::SetChipset(BitmapRef nchipset) {
+	chipset = std::move(nchipset);
+}
+
+AutotileAtlas::TileXY AutotileAtlas::GenerateAB(int ID, int animID) {
+	// Calculate the block to use
+	//	1: A1 + Upper B (Grass + Coast)
+	//	2: A2 + Upper B (Snow + Coast)
+	//	3: A1 + Lower B (Grass + Ocean/Deep water)
+	const int block = ID / 1000;
+
+	// Calculate the B block combination
+	const int b_subtile = (ID - block * 1000) / 50;
+
+	// Calculate the A block combination
+	const int a_subtile = ID - block * 1000 - b_subtile * 50;
+
+	if (ID < 0 || block >= 3 || b_subtile >= 16 || a_subtile >= 47 || animID < 0 || animID >= 3) {
+		if (invalid_ids.insert(ID).second) {
+			Output::Warning("Invalid AB autotile ID: {} (b_subtile = {}, a_subtile = {})",
+					ID, b_subtile, a_subtile);
+		}
+		return {};
+	}
+
+	uint8_t quarters[2][2][2];
+
+	// Determine block B subtiles
+	for (int j = 0; j < 2; j++) {
+		for (int i = 0; i < 2; i++) {
+			// Skip the subtile if it will be used one from A block instead
+			if (BlockA_Subtiles_IDS[a_subtile][j][i] != -1) continue;
+
+			// Get the block B subtiles ids and get their coordinates on the chipset
+			int t = (b_subtile >> (j * 2 + i)) & 1;
+			if (block == 2) t ^= 3;
+
+			quarters[j][i][0] = animID;
+			quarters[j][i][1] = 4 + t;
+		}
+	}
+
+	// Determine block A subtiles
+	for (int j = 0; j < 2; j++) {
+		for (int i = 0; i < 2; i++) {
+			// Skip the subtile if it was used one from B block
+			if (BlockA_Subtiles_IDS[a_subtile][j][i] == -1) continue;
+
+			// Get the block A subtiles ids and get their coordinates on the chipset
+			quarters[j][i][0] = animID + (block == 1 ? 3 : 0);
+			quarters[j][i][1] = BlockA_Subtiles_IDS[a_subtile][j][i];
+		}
+	}
+
+	// Determine block B subtiles when combining A and B
+	if (b_subtile != 0 && a_subtile != 0) {
+		for (int j = 0; j < 2; j++) {
+			for (int i = 0; i < 2; i++) {
+				// calculate tile (row 0..3)
+				int t = (b_subtile >> (j * 2 + i)) & 1;
+				if (block == 2) t *= 2;
+
+				// Skip the subtile if not used
+				if (t == 0) continue;
+
+				// Get the coordinates on the chipset
+				quarters[j][i][0] = animID;
+				quarters[j][i][1] = 4 + t;
+			}
+		}
+	}
+
+	// pack the quarters data into a word
+	uint32_t quarters_hash = 0;
+	for (int j = 0; j < 2; j++)
+		for (int i = 0; i < 2; i++)
+			for (int k = 0; k < 2; k++) {
+				quarters_hash <<= 4;
+				quarters_hash |= quarters[j][i][k];
+			}
+
+	auto tile_xy = AddTile(autotiles_ab_screen, autotiles_ab_map, quarters_hash);
+	autotiles_ab[animID][block][b_subtile][a_subtile] = tile_xy;
+	return tile_xy;
+}
+
+AutotileAtlas::TileXY AutotileAtlas::GenerateD(int ID) {
+	// Calculate the D block id
+	const int block = (ID - 4000) / 50;
+
+	// Calculate the D block combination
+	const int subtile = ID - 4000 - block * 50;
+
+	if (block >= 12 || subtile >= 50 || block < 0 || subtile < 0) {
+		if (invalid_ids.insert(ID).second) {
+			Output::Warning("Tilemap index out of range: {} {}", block, subtile);
+		}
+		return {};
+	}
+
+	uint8_t quarters[2][2][2];
+
+	// Get Block chipset coords
+	int block_x, block_y;
+	if (block < 4) {
+		// If from first column
+		block_x = (block % 2) * 3;
+		block_y = 8 + (block / 2) * 4;
+	} else {
+		// If from second column
+		block_x = 6 + (block % 2) * 3;
+		block_y = ((block - 4) / 2) * 4;
+	}
+
+	// Calculate D block subtiles
+	for (int j = 0; j < 2; j++) {
+		for (int i = 0; i < 2; i++) {
+			// Get the block D subtiles ids and get their coordinates on the chipset
+			quarters[j][i][0] = block_x + BlockD_Subtiles_IDS[subtile][j][i][0];
+			quarters[j][i][1] = block_y + BlockD_Subtiles_IDS[subtile][j][i][1];
+		}
+	}
+
+	// pack the quarters data into a word
+	uint32_t quarters_hash = 0;
+	for (int j = 0; j < 2; j++)
+		for (int i = 0; i < 2; i++)
+			for (int k = 0; k < 2; k++) {
+				quarters_hash <<= 4;//multiply 16
+				quarters_hash |= quarters[j][i][k];
+			}
+
+	auto tile_xy = AddTile(autotiles_d_screen, autotiles_d_map, quarters_hash);
+	autotiles_d[block][subtile] = tile_xy;
+	return tile_xy;
+}
+
+AutotileAtlas::TileXY AutotileAtlas::AddTile(BitmapRef& atlas, std::unordered_map<uint32_t, TileXY>& map, uint32_t quarters_hash) {
+	// check whether we have already generated this tile
+	auto it = map.find(quarters_hash);
+	if (it != map.end()) {
+		return it->second;
+	}
+
+	const int tile_id = static_cast<int>(map.size());
+	TileXY tile_xy(tile_id % TILES_PER_ROW, tile_id / TILES_PER_ROW);
+
+	// Grow the atlas, the tiles keep their position
+	const int rows = atlas ? atlas->height() / TILE_SIZE : 0;
+	if (tile_xy.y >= rows) {
+		BitmapRef tiles = Bitmap::Create(TILES_PER_ROW * TILE_SIZE, std::max(rows * 2, min_rows) * TILE_SIZE);
+		tiles->Clear();
+		if (atlas) {
+			tiles->BlitFast(0, 0, *atlas, atlas->GetRect(), 255);
+		}
+		// Not read only, the image opacity would not include the tiles composed later
+		tiles->CheckPixels(Bitmap::Flag_Chipset);
+		atlas = tiles;
+
+		// The tone effects have the size of the old atlas
+		tone_effects.clear();
+	}
+
+	// unpack the quarters data
+	Rect rect(0, 0, TILE_SIZE/2, TILE_SIZE/2);
+	uint32_t hash = quarters_hash;
+	for (int j = 0; j < 2; j++) {
+		for (int i = 0; i < 2; i++) {
+			constexpr int mask = ~(0xFu << 28);
+
+			int x = hash >> 28;
+			hash &= mask;
+			hash <<= 4;
+
+			int y = hash >> 28;
+			hash &= mask;
+			hash <<= 4;
+
+			rect.x = (x * 2 + i) * (TILE_SIZE/2);
+			rect.y = (y * 2 + j) * (TILE_SIZE/2);
+
+			atlas->BlitFast((tile_xy.x * 2 + i) * (TILE_SIZE / 2), (tile_xy.y * 2 + j) * (TILE_SIZE / 2), *chipset, rect, 255);
+		}
+	}
+	atlas->CheckTileOpacity(tile_xy.x, tile_xy.y);
+
+	map[quarters_hash] = tile_xy;
+	return tile_xy;
+}
+
+AutotileAtlas::ToneEffect& AutotileAtlas::GetToneEffect(const Tone& tone) {
+	auto it = std::find_if(tone_effects.begin(), tone_effects.end(), [&](auto& effect) {
+		return effect.tone == tone;
+	});
+
+	if (it == tone_effects.begin() && it != tone_effects.end()) {
+		return tone_effects.front();
+	}
+
+	if (it != tone_effects.end()) {
+		std::rotate(tone_effects.begin(), it, it + 1);
+		return tone_effects.front();
+	}
+
+	if (static_cast<int>(tone_effects.size()) >= max_tone_effects) {
+		tone_effects.pop_back();
+	}
+
+	ToneEffect effect;
+	effect.tone = tone;
+	if (autotiles_ab_screen) {
+		effect.ab = Bitmap::Create(autotiles_ab_screen->width(), autotiles_ab_screen->height());
+	}
+	if (autotiles_d_screen) {
+		effect.d = Bitmap::Create(autotiles_d_screen->width(), autotiles_d_screen->height());
+	}
+	tone_effects.insert(tone_effects.begin(), std::move(effect));
+	return tone_effects.front();
+}
@@ -0,0 +1,185 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_AUTOTILE_ATLAS_H
+#define EP_AUTOTILE_ATLAS_H
+
+// Headers
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "memory_management.h"
+#include "tone.h"
+
+/**
+ * Atlas of the autotile variants (blocks A, B and D) of a chipset.
+ *
+ * A variant is composed from the quarters of the chipset when it is
+ * requested for the first time. Variants made of the same quarters share
+ * one atlas tile.
+ *
+ * One atlas is shared by all maps using the same chipset, see
+ * Cache::Autotiles.
+ */
+class AutotileAtlas {
+public:
+	static constexpr int TILES_PER_ROW = 64;
+
+	struct TileXY {
+		uint8_t x;
+		uint8_t y;
+		bool valid;
+		TileXY() : x(0), y(0), valid(false) {}
+		TileXY(uint8_t x, uint8_t y) : x(x), y(y), valid(true) {}
+	};
+
+	/** Tone changed copies of the atlas tiles */
+	struct ToneEffect {
+		Tone tone;
+		BitmapRef ab;
+		BitmapRef d;
+		/** Atlas tiles already tone changed */
+		std::unordered_set<uint32_t> tiles_ab;
+		std::unordered_set<uint32_t> tiles_d;
+	};
+
+	/**
+	 * @param chipset chipset the autotiles are composed from
+	 */
+	explicit AutotileAtlas(BitmapRef chipset);
+
+	/** @return id of the chipset */
+	const std::string& GetId() const;
+
+	/**
+	 * Replaces the chipset, e.g. when it was loaded again.
+	 * Tiles already in the atlas are kept.
+	 *
+	 * @param chipset chipset with the same content
+	 */
+	void SetChipset(BitmapRef chipset);
+
+	/**
+	 * Gets the atlas tile of a block A or B autotile, composing it on first use.
+	 *
+	 * @param ID tile id
+	 * @param animID animation step (0 - 2)
+	 * @return atlas position, invalid for invalid tile ids
+	 */
+	TileXY GetAB(int ID, int animID);
+
+	/**
+	 * Gets the atlas tile of a block D autotile, composing it on first use.
+	 *
+	 * @param ID tile id
+	 * @return atlas position, invalid for invalid tile ids
+	 */
+	TileXY GetD(int ID);
+
+	/** @return atlas of the block A and B autotiles, nullptr when empty */
+	const BitmapRef& GetBitmapAB() const;
+
+	/** @return atlas of the block D autotiles, nullptr when empty */
+	const BitmapRef& GetBitmapD() const;
+
+	/**
+	 * Gets the tone changed copies of the atlas. The last few tones are kept.
+	 * The returned reference is valid until the atlas grows.
+	 *
+	 * @param tone tone
+	 * @return tone effect
+	 */
+	ToneEffect& GetToneEffect(const Tone& tone);
+
+	/** @return number of composed block A and B tiles */
+	int GetCountAB() const;
+
+	/** @return number of composed block D tiles */
+	int GetCountD() const;
+
+private:
+	TileXY GenerateAB(int ID, int animID);
+	TileXY GenerateD(int ID);
+	TileXY AddTile(BitmapRef& atlas, std::unordered_map<uint32_t, TileXY>& map, uint32_t quarters_hash);
+
+	BitmapRef chipset;
+	std::string id;
+
+	BitmapRef autotiles_ab_screen;
+	BitmapRef autotiles_d_screen;
+
+	TileXY autotiles_ab[3][3][16][47] = {};
+	TileXY autotiles_d[12][50] = {};
+
+	std::unordered_map<uint32_t, TileXY> autotiles_ab_map;
+	std::unordered_map<uint32_t, TileXY> autotiles_d_map;
+
+	/** Most recently used first */
+	std::vector<ToneEffect> tone_effects;
+
+	/** Invalid tile ids already reported */
+	std::unordered_set<int> invalid_ids;
+};
+
+inline const std::string& AutotileAtlas::GetId() const {
+	return id;
+}
+
+inline AutotileAtlas::TileXY AutotileAtlas::GetAB(int ID, int animID) {
+	const int block = ID / 1000;
+	const int b_subtile = (ID - block * 1000) / 50;
+	const int a_subtile = ID - block * 1000 - b_subtile * 50;
+	if (ID >= 0 && block < 3 && b_subtile < 16 && a_subtile < 47 && animID >= 0 && animID < 3) {
+		const auto& tile = autotiles_ab[animID][block][b_subtile][a_subtile];
+		if (tile.valid) {
+			return tile;
+		}
+	}
+	return GenerateAB(ID, animID);
+}
+
+inline AutotileAtlas::TileXY AutotileAtlas::GetD(int ID) {
+	const int block = (ID - 4000) / 50;
+	const int subtile = ID - 4000 - block * 50;
+	if (block >= 0 && block < 12 && subtile >= 0 && subtile < 50) {
+		const auto& tile = autotiles_d[block][subtile];
+		if (tile.valid) {
+			return tile;
+		}
+	}
+	return GenerateD(ID);
+}
+
+inline const BitmapRef& AutotileAtlas::GetBitmapAB() const {
+	return autotiles_ab_screen;
+}
+
+inline const BitmapRef& AutotileAtlas::GetBitmapD() const {
+	return autotiles_d_screen;
+}
+
+inline int AutotileAtlas::GetCountAB() const {
+	return static_cast<int>(autotiles_ab_map.size());
+}
+
+inline int AutotileAtlas::GetCountD() const {
+	return static_cast<int>(autotiles_d_map.size());
+}
+
+#endif
@@ -0,0 +1,373 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "battle_simulator.h"
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "system.h"
+#include "autobattle.h"
+#include "enemyai.h"
+#include "game_actor.h"
+#include "game_battle.h"
+#include "game_battlealgorithm.h"
+#include "game_enemy.h"
+#include "game_enemyparty.h"
+#include "game_party.h"
+#include "game_switches.h"
+#include "game_system.h"
+#include "game_variables.h"
+#include "main_data.h"
+#include "output.h"
+#include "player.h"
+#include "rand.h"
+#include <lcf/data.h>
+#include <lcf/reader_util.h>
+
+BattleSimulator::Stats& BattleSimulator::Stats::operator+=(const Stats& o) {
+	battles += o.battles;
+	victories += o.victories;
+	defeats += o.defeats;
+	draws += o.draws;
+	turns += o.turns;
+	party_hp += o.party_hp;
+	party_max_hp += o.party_max_hp;
+	return *this;
+}
+
+namespace {
+
+/**
+ * Saves the global state touched by a battle and restores it on destruction.
+ * Battles are started from this state.
+ */
+class StateContext {
+public:
+	explicit StateContext(lcf::rpg::System::BattleCondition condition);
+	~StateContext();
+
+	StateContext(const StateContext&) = delete;
+	StateContext& operator=(const StateContext&) = delete;
+
+	/** Resets the party, inventory, switches and variables to the saved state */
+	void Reset();
+
+private:
+	std::vector<std::pair<Game_Actor*, lcf::rpg::SaveActor>> actors;
+	lcf::rpg::SaveInventory inventory;
+	Game_Switches::Switches_t switches;
+	Game_Variables::Variables_t variables;
+	Rand::RNG rng;
+	bool battle_running;
+	bool se_muted;
+	lcf::rpg::System::BattleCondition condition;
+};
+
+StateContext::StateContext(lcf::rpg::System::BattleCondition cond) {
+	for (auto* actor: Main_Data::game_party->GetActors()) {
+		actors.emplace_back(actor, actor->GetSaveData());
+	}
+	inventory = Main_Data::game_party->GetSaveData();
+	switches = Main_Data::game_switches->GetData();
+	variables = Main_Data::game_variables->GetData();
+	rng = Rand::GetRNG();
+	battle_running = Game_Battle::battle_running;
+	se_muted = Main_Data::game_system->IsSeMuted();
+	condition = Game_Battle::GetBattleCondition();
+
+	Game_Battle::SetBattleCondition(cond);
+	// e.g. switch and teleport skills play their sound when used
+	Main_Data::game_system->SetSeMuted(true);
+}
+
+StateContext::~StateContext() {
+	Main_Data::game_enemyparty->ResetBattle(0);
+	Reset();
+	for (auto& actor: actors) {
+		actor.first->ResetBattle();
+	}
+	Main_Data::game_party->ResetTurns();
+
+	Game_Battle::battle_running = battle_running;
+	Game_Battle::SetBattleCondition(condition);
+	Main_Data::game_system->SetSeMuted(se_muted);
+	Rand::GetRNG() = rng;
+}
+
+void StateContext::Reset() {
+	for (auto& actor: actors) {
+		actor.first->SetSaveData(actor.second);
+	}
+	Main_Data::game_party->SetupFromSave(inventory);
+	Main_Data::game_switches->SetData(switches);
+	Main_Data::game_variables->SetData(variables);
+}
+
+/** Resolves battles like Scene_Battle_Rpg2k, without messages and animations */
+class Simulation {
+public:
+	Simulation();
+
+	/**
+	 * Resolves one battle.
+	 *
+	 * @param troop_id troop to fight against
+	 * @param max_turns turn limit
+	 * @param stats outcome is added to it
+	 */
+	void RunBattle(int troop_id, int max_turns, BattleSimulator::Stats& stats);
+
+private:
+	void SelectActions();
+	void ExecuteAction(Game_Battler& battler);
+	bool IsFinished() const;
+
+	std::vector<std::unique_ptr<AutoBattle::AlgorithmBase>> autobattle_algos;
+	std::vector<std::unique_ptr<EnemyAi::AlgorithmBase>> enemyai_algos;
+	int default_autobattle_algo = 0;
+	int default_enemyai_algo = 0;
+
+	std::vector<Game_Battler*> battle_actions;
+};
+
+Simulation::Simulation() {
+	autobattle_algos.push_back(AutoBattle::CreateAlgorithm(AutoBattle::RpgRtCompat::name));
+	autobattle_algos.push_back(AutoBattle::CreateAlgorithm(AutoBattle::RpgRtImproved::name));
+	autobattle_algos.push_back(AutoBattle::CreateAlgorithm(AutoBattle::AttackOnly::name));
+	enemyai_algos.push_back(EnemyAi::CreateAlgorithm(EnemyAi::RpgRtCompat::name));
+	enemyai_algos.push_back(EnemyAi::CreateAlgorithm(EnemyAi::RpgRtImproved::name));
+
+	if (lcf::Data::system.easyrpg_default_actorai == -1) {
+		for (auto& algo : autobattle_algos) {
+			if (algo->GetName() == Player::player_config.autobattle_algo.Get()) {
+				default_autobattle_algo = algo->GetId();
+				break;
+			}
+		}
+	} else {
+		default_autobattle_algo = lcf::Data::system.easyrpg_default_actorai;
+	}
+	if (lcf::Data::system.easyrpg_default_enemyai == -1) {
+		for (auto& algo : enemyai_algos) {
+			if (algo->GetName() == Player::player_config.enemyai_algo.Get()) {
+				default_enemyai_algo = algo->GetId();
+				break;
+			}
+		}
+	} else {
+		default_enemyai_algo = lcf::Data::system.easyrpg_default_enemyai;
+	}
+}
+
+bool Simulation::IsFinished() const {
+	return Game_Battle::CheckWin() || Game_Battle::CheckLose();
+}
+
+void Simulation::SelectActions() {
+	battle_actions.clear();
+
+	// See Scene_Battle_Rpg2k::SelectNextActor
+	for (auto* actor: Main_Data::game_party->GetActors()) {
+		battle_actions.push_back(actor);
+
+		if (!actor->CanAct()) {
+			actor->SetBattleAlgorithm(std::make_shared<Game_BattleAlgorithm::None>(actor));
+			continue;
+		}
+
+		Game_Battler* random_target = nullptr;
+		switch (actor->GetSignificantRestriction()) {
+			case lcf::rpg::State::Restriction_attack_ally:
+				random_target = Main_Data::game_party->GetRandomActiveBattler();
+				break;
+			case lcf::rpg::State::Restriction_attack_enemy:
+				random_target = Main_Data::game_enemyparty->GetRandomActiveBattler();
+				break;
+			default:
+				break;
+		}
+
+		if (random_target) {
+			actor->SetBattleAlgorithm(std::make_shared<Game_BattleAlgorithm::Normal>(actor, random_target));
+		} else {
+			int algo = actor->GetActorAi() == -1 ? default_autobattle_algo : actor->GetActorAi();
+			autobattle_algos[algo]->SetAutoBattleAction(*actor);
+		}
+	}
+
+	for (auto* enemy: Main_Data::game_enemyparty->GetEnemies()) {
+		if (enemy->IsHidden()) {
+			continue;
+		}
+
+		if (!EnemyAi::SetStateRestrictedAction(*enemy)) {
+			int algo = enemy->GetEnemyAi() == -1 ? default_enemyai_algo : enemy->GetEnemyAi();
+			enemyai_algos[algo]->SetEnemyAiAction(*enemy);
+		}
+		battle_actions.push_back(enemy);
+	}
+
+	// See Scene_Battle_Rpg2k::CreateExecutionOrder
+	for (auto* battler: battle_actions) {
+		int battle_order = battler->GetAgi() + Rand::GetRandomNumber(0, battler->GetAgi() / 4 + 3);
+		if (battler->GetBattleAlgorithm()->GetType() == Game_BattleAlgorithm::Type::Normal && battler->HasPreemptiveAttack()) {
+			battle_order += 9999;
+		}
+		battler->SetBattleOrderAgi(battle_order);
+	}
+	std::stable_sort(battle_actions.begin(), battle_actions.end(), [](Game_Battler* l, Game_Battler* r) {
+		return l->GetBattleOrderAgi() > r->GetBattleOrderAgi();
+	});
+}
+
+void Simulation::ExecuteAction(Game_Battler& battler) {
+	// See Scene_Battle::PrepareBattleAction
+	if (!battler.CanAct()) {
+		battler.SetBattleAlgorithm(std::make_shared<Game_BattleAlgorithm::None>(&battler));
+	} else if (battler.GetSignificantRestriction() == lcf::rpg::State::Restriction_attack_ally) {
+		Game_Battler* target = battler.GetType() == Game_Battler::Type_Enemy
+			? Main_Data::game_enemyparty->GetRandomActiveBattler()
+			: Main_Data::game_party->GetRandomActiveBattler();
+		battler.SetBattleAlgorithm(std::make_shared<Game_BattleAlgorithm::Normal>(&battler, target));
+	} else if (battler.GetSignificantRestriction() == lcf::rpg::State::Restriction_attack_enemy) {
+		Game_Battler* target = battler.GetType() == Game_Battler::Type_Ally
+			? Main_Data::game_enemyparty->GetRandomActiveBattler()
+			: Main_Data::game_party->GetRandomActiveBattler();
+		battler.SetBattleAlgorithm(std::make_shared<Game_BattleAlgorithm::Normal>(&battler, target));
+	} else if (!battler.GetBattleAlgorithm()->ActionIsPossible()) {
+		battler.SetBattleAlgorithm(std::make_shared<Game_BattleAlgorithm::None>(&battler));
+	}
+
+	auto action = battler.GetBattleAlgorithm();
+
+	battler.NextBattleTurn();
+	battler.BattleStateHeal();
+	battler.ApplyConditions();
+
+	if (action->GetType() != Game_BattleAlgorithm::Type::None) {
+		action->Start();
+		action->ReflectTargets();
+		do {
+			action->Execute();
+			action->ApplyAll();
+		} while (action->RepeatNext(true) || action->TargetNext());
+		action->ProcessPostActionSwitches();
+	}
+
+	battler.SetBattleAlgorithm(nullptr);
+}
+
+void Simulation::RunBattle(int troop_id, int max_turns, BattleSimulator::Stats& stats) {
+	// See Game_Battle::Init, without the interpreter and sprites
+	Main_Data::game_party->ResetTurns();
+	Main_Data::game_enemyparty->ResetBattle(troop_id);
+	for (auto* actor: Main_Data::game_party->GetActors()) {
+		actor->ResetBattle();
+		actor->ResetEquipmentStates(true);
+	}
+
+	int turn = 0;
+	while (!IsFinished() && turn < max_turns) {
+		++turn;
+		Main_Data::game_party->IncTurns();
+
+		SelectActions();
+		for (auto* battler: battle_actions) {
+			if (IsFinished()) {
+				break;
+			}
+			if (battler->Exists()) {
+				ExecuteAction(*battler);
+			} else {
+				battler->SetBattleAlgorithm(nullptr);
+			}
+		}
+		// Actions of battlers that did not act because the battle ended
+		for (auto* battler: battle_actions) {
+			battler->SetBattleAlgorithm(nullptr);
+		}
+	}
+
+	++stats.battles;
+	stats.turns += turn;
+	if (Game_Battle::CheckWin()) {
+		++stats.victories;
+		for (auto* actor: Main_Data::game_party->GetActors()) {
+			stats.party_hp += actor->GetHp();
+			stats.party_max_hp += actor->GetMaxHp();
+		}
+	} else if (Game_Battle::CheckLose()) {
+		++stats.defeats;
+	} else {
+		++stats.draws;
+	}
+}
+
+BattleSimulator::Stats RunBattles(const BattleSimulator::Config& cfg) {
+	BattleSimulator::Stats stats;
+
+	StateContext context(cfg.condition);
+	Simulation sim;
+
+	Game_Battle::battle_running = true;
+	for (int i = 0; i < cfg.battles; ++i) {
+		context.Reset();
+		Rand::SeedRandomNumberGenerator(static_cast<int32_t>(cfg.seed + static_cast<uint32_t>(i)));
+		sim.RunBattle(cfg.troop_id, cfg.max_turns, stats);
+	}
+
+	return stats;
+}
+
+
+} // namespace
+
+BattleSimulator::Stats BattleSimulator::Run(const Config& cfg) {
+	if (!lcf::ReaderUtil::GetElement(lcf::Data::troops, cfg.troop_id)) {
+		Output::Warning("BattleSimulator: Invalid troop ID {}", cfg.troop_id);
+		return {};
+	}
+
+	if (cfg.battles <= 0) {
+		return {};
+	}
+
+	return RunBattles(cfg);
+}
+
+void BattleSimulator::PrintStats(const Config& cfg, const Stats& stats) {
+	auto* troop = lcf::ReaderUtil::GetElement(lcf::Data::troops, cfg.troop_id);
+	if (!troop || stats.battles == 0) {
+		Output::Info("BattleSimulator: No battles were simulated");
+		return;
+	}
+
+	auto percent = [&](int n) {
+		return 100.0 * n / stats.battles;
+	};
+
+	Output::Info("Troop {} ({}): {} battles, seed {}", cfg.troop_id, troop->name, stats.battles, cfg.seed);
+	Output::Info("Victories: {} ({:.2f}%)", stats.victories, percent(stats.victories));
+	Output::Info("Defeats: {} ({:.2f}%)", stats.defeats, percent(stats.defeats));
+	Output::Info("Draws after {} turns: {} ({:.2f}%)", cfg.max_turns, stats.draws, percent(stats.draws));
+	Output::Info("Average turns: {:.2f}", static_cast<double>(stats.turns) / stats.battles);
+	if (stats.party_max_hp > 0) {
+		Output::Info("Party HP left after victories: {:.2f}%", 100.0 * stats.party_hp / stats.party_max_hp);
+	}
+}
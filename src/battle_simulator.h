@@ -0,0 +1,92 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_BATTLE_SIMULATOR_H
+#define EP_BATTLE_SIMULATOR_H
+
+#include <cstdint>
+#include <lcf/rpg/system.h>
+
+/**
+ * Headless battle simulation for balance testing.
+ *
+ * Battles of a troop against the current party are resolved without a scene,
+ * sprites, messages or waiting. Actors use their auto battle algorithm and
+ * enemies their enemy AI. Every battle is seeded with its own seed, the
+ * outcome of a battle does not depend on the other battles.
+ *
+ * Turns are resolved like in the RPG Maker 2000 battle system, also for
+ * RPG Maker 2003 games (the ATB gauge is not simulated). Battle events of
+ * the troop are not executed.
+ *
+ * The battles run one after another on the calling thread: the game state
+ * is global, so it cannot be shared by several battles at once.
+ */
+namespace BattleSimulator {
+
+struct Config {
+	/** Troop to fight against */
+	int troop_id = 0;
+	/** Number of battles */
+	int battles = 1;
+	/** Seed of the first battle, battle i uses seed + i */
+	uint32_t seed = 0;
+	/** Battles lasting longer are counted as draws */
+	int max_turns = 100;
+	lcf::rpg::System::BattleCondition condition = lcf::rpg::System::BattleCondition_none;
+};
+
+/** Accumulated outcome of several battles */
+struct Stats {
+	int battles = 0;
+	int victories = 0;
+	int defeats = 0;
+	/** Battles that hit the turn limit */
+	int draws = 0;
+	/** Sum of turns of all battles */
+	int64_t turns = 0;
+	/** Sum of the party HP left after all victories */
+	int64_t party_hp = 0;
+	/** Sum of the party max HP for all victories */
+	int64_t party_max_hp = 0;
+
+	Stats& operator+=(const Stats& o);
+};
+
+/**
+ * Simulates the battles described by cfg.
+ *
+ * Requires a loaded database and game objects. The party, actors, inventory,
+ * switches, variables and the random number generator are restored
+ * afterwards. Sound effects are muted while the battles run.
+ *
+ * @param cfg simulation settings
+ * @return accumulated outcome
+ */
+Stats Run(const Config& cfg);
+
+/**
+ * Writes a summary of the stats to the log.
+ *
+ * @param cfg settings the stats were created with
+ * @param stats outcome of Run
+ */
+void PrintStats(const Config& cfg, const Stats& stats);
+
+} // namespace BattleSimulator
+
+#endif
@@ -284,6 +284,11 @@ void Bitmap::CheckPixels(uint32_t flags) {
 	}
 }
 
+void Bitmap::CheckTileOpacity(int x, int y) {
+	Rect rect(x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+	tile_opacity.Set(x, y, ComputeImageOpacity(rect));
+}
+
 Color Bitmap::GetColorAt(int x, int y) const {
 	if (x < 0 || x >= width() || y < 0 || y >= height()) {
 		return {};
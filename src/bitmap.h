@@ -242,6 +242,15 @@ public:
 
 	void CheckPixels(uint32_t flags);
 
+	/**
+	 * Updates the opacity information of a single tile after it was drawn
+	 * into a bitmap checked with Flag_Chipset.
+	 *
+	 * @param x tile x coordinate
+	 * @param y tile y coordinate
+	 */
+	void CheckTileOpacity(int x, int y);
+
 	/**
 	 * @param x x-coordinate
 	 * @param y y-coordinate
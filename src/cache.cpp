@@ -20,12 +20,14 @@
 #  pragma warning(disable: 4003)
 #endif
 
+#include <algorithm>
 #include <map>
 #include <tuple>
 #include <chrono>
 #include <cassert>
 
 #include "async_handler.h"
+#include "autotile_atlas.h"
 #include "cache.h"
 #include "filefinder.h"
 #include "exfont.h"
@@ -85,6 +87,10 @@ namespace {
 	using effect_key_type = std::tuple<std::string, bool, Rect, bool, bool, Tone, Color>;
 	std::map<effect_key_type, std::weak_ptr<Bitmap>> cache_effects;
 
+	// Most recently used first
+	std::vector<std::shared_ptr<AutotileAtlas>> cache_autotiles;
+	constexpr int cache_autotiles_limit = 4;
+
 	std::string system_name;
 
 	std::string system2_name;
@@ -521,8 +527,34 @@ BitmapRef Cache::SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, boo
 	} else { return it->second.lock(); }
 }
 
+std::shared_ptr<AutotileAtlas> Cache::Autotiles(const BitmapRef& chipset) {
+	if (chipset->GetId().empty()) {
+		// Generated chipset, e.g. the placeholder of a map without chipset
+		return std::make_shared<AutotileAtlas>(chipset);
+	}
+
+	auto it = std::find_if(cache_autotiles.begin(), cache_autotiles.end(), [&](auto& atlas) {
+		return StringView(atlas->GetId()) == chipset->GetId();
+	});
+
+	if (it != cache_autotiles.end()) {
+		std::rotate(cache_autotiles.begin(), it, it + 1);
+		// The chipset is reloaded when it was freed from the bitmap cache
+		cache_autotiles.front()->SetChipset(chipset);
+		return cache_autotiles.front();
+	}
+
+	if (static_cast<int>(cache_autotiles.size()) >= cache_autotiles_limit) {
+		cache_autotiles.pop_back();
+	}
+
+	cache_autotiles.insert(cache_autotiles.begin(), std::make_shared<AutotileAtlas>(chipset));
+	return cache_autotiles.front();
+}
+
 void Cache::Clear() {
 	cache_effects.clear();
+	cache_autotiles.clear();
 	cache.clear();
 	cache_size = 0;
 
@@ -29,6 +29,7 @@
 
 #define CACHE_DEFAULT_BITMAP "\x01"
 
+class AutotileAtlas;
 class Color;
 class Rect;
 class Tone;
@@ -58,6 +59,16 @@ namespace Cache {
 	BitmapRef Tile(StringView filename, int tile_id);
 	BitmapRef SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, bool flip_x, bool flip_y, const Tone& tone, const Color& blend);
 
+	/**
+	 * Gets the autotile atlas of a chipset. The atlases of the last few
+	 * chipsets are kept, so maps sharing a chipset do not compose the
+	 * autotiles again.
+	 *
+	 * @param chipset chipset bitmap
+	 * @return autotile atlas
+	 */
+	std::shared_ptr<AutotileAtlas> Autotiles(const BitmapRef& chipset);
+
 	void Clear();
 	void ClearAll();
 
@@ -54,7 +54,13 @@ drwav_bool32 seek_func(void* userdata, int offset, drwav_seek_origin origin) {
 
 bool DrWavDecoder::Open(Filesystem_Stream::InputStream stream_) {
 	this->stream = std::move(stream_);
-	init = drwav_init_ex(&handle, read_func, seek_func, nullptr, &this->stream, nullptr, DRWAV_SEQUENTIAL, nullptr) == DRWAV_TRUE;
+	auto data = this->stream.GetData();
+	if (!data.empty()) {
+		// Memory backed streams (e.g. memory mapped files) are decoded in place
+		init = drwav_init_memory_ex(&handle, data.data(), data.size(), nullptr, nullptr, DRWAV_SEQUENTIAL, nullptr) == DRWAV_TRUE;
+	} else {
+		init = drwav_init_ex(&handle, read_func, seek_func, nullptr, &this->stream, nullptr, DRWAV_SEQUENTIAL, nullptr) == DRWAV_TRUE;
+	}
 	return init;
 }
 
@@ -29,6 +29,7 @@
 FmMidiDecoder::FmMidiDecoder() {
 	note_factory.reset(new midisynth::fm_note_factory());
 	synth.reset(new midisynth::synthesizer(note_factory.get()));
+	synth->set_max_polyphony(EP_FMMIDI_POLYPHONY);
 
 	load_programs();
 }
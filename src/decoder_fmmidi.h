@@ -25,6 +25,12 @@
 #include "midisequencer.h"
 #include "midisynth.h"
 
+#if defined(__wii__) || defined(__3DS__)
+#  define EP_FMMIDI_POLYPHONY 32
+#else
+#  define EP_FMMIDI_POLYPHONY 128
+#endif
+
 /**
  * Audio decoder for MIDI powered by FM MIDI
  */
@@ -37,8 +43,9 @@ public:
 	void SendMidiMessage(uint32_t message) override;
 	void SendSysExMessage(const uint8_t* data, size_t size) override;
 
-	std::unique_ptr<midisynth::synthesizer> synth;
+	// The factory recycles the notes of the synth and must be destroyed last
 	std::unique_ptr<midisynth::fm_note_factory> note_factory;
+	std::unique_ptr<midisynth::synthesizer> synth;
 	midisynth::DRUMPARAMETER p;
 	void load_programs();
 
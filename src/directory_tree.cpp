@@ -21,6 +21,9 @@
 #include "output.h"
 #include "platform.h"
 #include "player.h"
+#include <ctime>
+#include <istream>
+#include <ostream>
 #include <lcf/reader_util.h>
 
 //#define EP_DEBUG_DIRECTORYTREE
@@ -38,6 +41,52 @@ namespace {
 	std::string make_key(StringView n) {
 		return lcf::ReaderUtil::Normalize(n);
 	};
+
+	constexpr char index_magic[] = "EasyRPG DirIndex";
+	constexpr uint32_t index_version = 1;
+	// Limits to detect corrupted files before allocating memory
+	constexpr uint64_t index_max_string = 4096;
+	constexpr uint64_t index_max_count = 1 << 20;
+
+	// Directories modified within the last seconds can change again without
+	// a visible difference in the stamp, they are not indexed
+	bool IsStableStamp(const DirectoryTree::Stamp& stamp) {
+		return stamp.mtime >= 0 && stamp.mtime + 2 < static_cast<int64_t>(std::time(nullptr));
+	}
+
+	void WriteUInt(std::ostream& os, uint64_t value, int bytes) {
+		char buf[8];
+		for (int i = 0; i < bytes; ++i) {
+			buf[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+		}
+		os.write(buf, bytes);
+	}
+
+	void WriteString(std::ostream& os, StringView str) {
+		WriteUInt(os, str.size(), 4);
+		os.write(str.data(), str.size());
+	}
+
+	bool ReadUInt(std::istream& is, uint64_t& value, int bytes) {
+		unsigned char buf[8];
+		if (!is.read(reinterpret_cast<char*>(buf), bytes)) {
+			return false;
+		}
+		value = 0;
+		for (int i = 0; i < bytes; ++i) {
+			value |= static_cast<uint64_t>(buf[i]) << (8 * i);
+		}
+		return true;
+	}
+
+	bool ReadString(std::istream& is, std::string& str) {
+		uint64_t len;
+		if (!ReadUInt(is, len, 4) || len > index_max_string) {
+			return false;
+		}
+		str.resize(len);
+		return len == 0 || is.read(&str[0], len);
+	}
 }
 
 std::unique_ptr<DirectoryTree> DirectoryTree::Create() {
@@ -102,13 +151,19 @@ DirectoryTree::DirectoryListType* DirectoryTree::ListDirectory(StringView path)
 		return &file_it->second;
 	}
 
-	auto dir_missing_it = std::find(dir_missing_cache.begin(), dir_missing_cache.end(), dir_key);
-	if (dir_missing_it != dir_missing_cache.end()) {
+	if (dir_missing_cache.find(dir_key) != dir_missing_cache.end()) {
 		// Cached and known to be missing
 		DebugLog("ListDirectory Cache Hit Dir Missing: {}", dir_key);
 		return nullptr;
 	}
 
+	if (index_enabled) {
+		auto* indexed_entries = ListIndexedDirectory(dir_key);
+		if (indexed_entries) {
+			return indexed_entries;
+		}
+	}
+
 	assert(Find(fs_cache, dir_key) == fs_cache.end());
 
 	if (!fs->Exists(fs_path)) {
@@ -118,7 +173,7 @@ DirectoryTree::DirectoryListType* DirectoryTree::ListDirectory(StringView path)
 		if (parent_dir == fs_path) {
 			// When the path stays we are in a non-existant root -> give up
 			DebugLog("ListDirectory Bad root: {} | {}", fs_path, parent_dir);
-			dir_missing_cache.push_back(make_key(parent_dir));
+			dir_missing_cache.insert(make_key(parent_dir));
 			return nullptr;
 		}
 
@@ -126,7 +181,7 @@ DirectoryTree::DirectoryListType* DirectoryTree::ListDirectory(StringView path)
 		auto* parent_tree = ListDirectory(parent_dir);
 		if (!parent_tree) {
 			DebugLog("ListDirectory No parent: {} | {}", fs_path, parent_dir);
-			dir_missing_cache.push_back(make_key(parent_dir));
+			dir_missing_cache.insert(make_key(parent_dir));
 			return nullptr;
 		}
 
@@ -140,14 +195,18 @@ DirectoryTree::DirectoryListType* DirectoryTree::ListDirectory(StringView path)
 			fs_path = FileFinder::MakePath(parent_it->second, child_it->second.name);
 		} else {
 			DebugLog("ListDirectory Child not in Parent: {} | {} | {}", fs_path, parent_dir, child_dir);
-			dir_missing_cache.push_back(FileFinder::MakePath(parent_key, child_key));
+			dir_missing_cache.insert(FileFinder::MakePath(parent_key, child_key));
 			return nullptr;
 		}
 	}
 
+	// The stamp is taken first, changes during the enumeration invalidate it
+	Stamp stamp;
+	bool has_stamp = index_enabled && fs->GetDirectoryStamp(fs_path, stamp) && IsStableStamp(stamp);
+
 	if (!fs->GetDirectoryContent(fs_path, entries)) {
 		DebugLog("ListDirectory GetDirectoryContent Failed: {}", fs_path);
-		dir_missing_cache.push_back(make_key(fs_path));
+		dir_missing_cache.insert(make_key(fs_path));
 		return nullptr;
 	}
 
@@ -187,6 +246,37 @@ DirectoryTree::DirectoryListType* DirectoryTree::ListDirectory(StringView path)
 
 	InsertSorted(fs_cache, dir_key, std::move(fs_cache_entry));
 
+	if (has_stamp) {
+		InsertSorted(stamp_cache, dir_key, stamp);
+		index_modified = true;
+	}
+
+	return &Find(fs_cache, dir_key)->second;
+}
+
+DirectoryTree::DirectoryListType* DirectoryTree::ListIndexedDirectory(const std::string& dir_key) const {
+	auto index_it = Find(index_cache, dir_key);
+	if (index_it == index_cache.end()) {
+		return nullptr;
+	}
+
+	// Validated only once, afterwards the directory is handled by the normal cache
+	IndexEntry entry = std::move(index_it->second);
+	index_cache.erase(index_it);
+
+	Stamp stamp;
+	if (!fs->GetDirectoryStamp(entry.dir, stamp) || stamp.mtime != entry.stamp.mtime || stamp.size != entry.stamp.size) {
+		DebugLog("ListDirectory Index Outdated: {}", dir_key);
+		index_modified = true;
+		return nullptr;
+	}
+
+	DebugLog("ListDirectory Index Hit: {}", dir_key);
+
+	InsertSorted(dir_cache, dir_key, std::move(entry.dir));
+	InsertSorted(stamp_cache, dir_key, stamp);
+	InsertSorted(fs_cache, dir_key, std::move(entry.entries));
+
 	return &Find(fs_cache, dir_key)->second;
 }
 
@@ -209,9 +299,118 @@ void DirectoryTree::ClearCache(StringView path) const {
 	if (dir_it != dir_cache.end()) {
 		dir_cache.erase(dir_it);
 	}
-	dir_missing_cache.erase(std::remove_if(dir_missing_cache.begin(), dir_missing_cache.end(), [&path] (const auto& dir) {
-		return StringView(dir).starts_with(path);
-	}), dir_missing_cache.end());
+	auto stamp_it = Find(stamp_cache, dir_key);
+	if (stamp_it != stamp_cache.end()) {
+		stamp_cache.erase(stamp_it);
+	}
+	for (auto it = dir_missing_cache.begin(); it != dir_missing_cache.end();) {
+		if (StringView(*it).starts_with(path)) {
+			it = dir_missing_cache.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+bool DirectoryTree::LoadIndex(std::istream& is) const {
+	index_enabled = true;
+	index_cache.clear();
+
+	if (!is) {
+		return false;
+	}
+
+	char magic[sizeof(index_magic) - 1];
+	uint64_t version, count;
+	if (!is.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), index_magic)
+			|| !ReadUInt(is, version, 4) || version != index_version) {
+		Output::Debug("Directory index: Unsupported format");
+		index_modified = true;
+		return false;
+	}
+
+	bool valid = ReadUInt(is, count, 4) && count <= index_max_count;
+	for (uint64_t i = 0; valid && i < count; ++i) {
+		std::string key;
+		IndexEntry entry;
+		uint64_t mtime, size, num_entries;
+		valid = ReadString(is, key) && ReadString(is, entry.dir)
+			&& ReadUInt(is, mtime, 8) && ReadUInt(is, size, 8)
+			&& ReadUInt(is, num_entries, 4) && num_entries <= index_max_count;
+		entry.stamp.mtime = static_cast<int64_t>(mtime);
+		entry.stamp.size = static_cast<int64_t>(size);
+
+		for (uint64_t j = 0; valid && j < num_entries; ++j) {
+			std::string entry_key, name;
+			uint64_t type;
+			valid = ReadString(is, entry_key) && ReadString(is, name) && ReadUInt(is, type, 1)
+				&& type <= static_cast<uint64_t>(FileType::Other);
+			if (valid) {
+				entry.entries.emplace_back(std::move(entry_key), Entry(std::move(name), static_cast<FileType>(type)));
+			}
+		}
+
+		if (valid) {
+			index_cache.emplace_back(std::move(key), std::move(entry));
+		}
+	}
+
+	if (!valid) {
+		Output::Debug("Directory index: File is corrupted");
+		index_cache.clear();
+		index_modified = true;
+		return false;
+	}
+
+	std::sort(index_cache.begin(), index_cache.end(), [](const auto& left, const auto& right) {
+		return left.first < right.first;
+	});
+	index_cache.erase(std::unique(index_cache.begin(), index_cache.end(), [](const auto& left, const auto& right) {
+		return left.first == right.first;
+	}), index_cache.end());
+
+	return true;
+}
+
+bool DirectoryTree::SaveIndex(std::ostream& os) const {
+	if (!index_enabled || !index_modified) {
+		return false;
+	}
+
+	auto write_dir = [&os](StringView key, StringView dir, const Stamp& stamp, const DirectoryListType& entries) {
+		WriteString(os, key);
+		WriteString(os, dir);
+		WriteUInt(os, static_cast<uint64_t>(stamp.mtime), 8);
+		WriteUInt(os, static_cast<uint64_t>(stamp.size), 8);
+		WriteUInt(os, entries.size(), 4);
+		for (const auto& entry : entries) {
+			WriteString(os, entry.first);
+			WriteString(os, entry.second.name);
+			WriteUInt(os, static_cast<uint64_t>(entry.second.type), 1);
+		}
+	};
+
+	os.write(index_magic, sizeof(index_magic) - 1);
+	WriteUInt(os, index_version, 4);
+
+	// Accessed directories are removed from the index cache, both lists are disjoint
+	WriteUInt(os, stamp_cache.size() + index_cache.size(), 4);
+	for (const auto& stamp : stamp_cache) {
+		auto dir_it = Find(dir_cache, stamp.first);
+		auto fs_it = Find(fs_cache, stamp.first);
+		assert(dir_it != dir_cache.end() && fs_it != fs_cache.end());
+		write_dir(stamp.first, dir_it->second, stamp.second, fs_it->second);
+	}
+	for (const auto& index : index_cache) {
+		write_dir(index.first, index.second.dir, index.second.stamp, index.second.entries);
+	}
+
+	if (!os) {
+		return false;
+	}
+
+	index_modified = false;
+	return true;
 }
 
 std::string DirectoryTree::FindFile(StringView filename, const Span<const StringView> exts) const {
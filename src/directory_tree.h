@@ -18,10 +18,13 @@
 #ifndef EP_DIRECTORY_TREE_H
 #define EP_DIRECTORY_TREE_H
 
+#include <cstdint>
+#include <iosfwd>
 #include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "span.h"
 #include "string_view.h"
@@ -57,6 +60,14 @@ public:
 		Entry(std::string name, FileType type) : name(std::move(name)), type(type) {}
 	};
 
+	/** Modification stamp of a directory, used to validate the directory index */
+	struct Stamp {
+		/** Modification time in seconds */
+		int64_t mtime = -1;
+		/** Size of the directory as reported by the OS */
+		int64_t size = -1;
+	};
+
 	/** Argument struct for more complex find operations */
 	struct Args {
 		/** File relative to the current tree to search */
@@ -132,11 +143,30 @@ public:
 
 	void ClearCache(StringView path) const;
 
+	/**
+	 * Loads a directory index written by SaveIndex and enables recording of
+	 * directory stamps.
+	 * Indexed directories are not enumerated again when their stamp did not
+	 * change. The stamp is checked on first access of the directory.
+	 *
+	 * @param is stream to read the index from, can be invalid for an empty index
+	 * @return true when an index was loaded
+	 */
+	bool LoadIndex(std::istream& is) const;
+
+	/**
+	 * Writes all enumerated directories that have a stamp to the index.
+	 * Directories of the loaded index that were not accessed are kept.
+	 *
+	 * @param os stream to write the index to
+	 * @return true when the index was written, false when it did not change
+	 */
+	bool SaveIndex(std::ostream& os) const;
+
 private:
 	Filesystem* fs = nullptr;
 
 	// Cache vectors are sorted for a binary search
-	// Except dir_missing_cache as this vector will be (almost) empty usually
 
 	/** lowered dir (full path from root) -> <list of> lowered file -> Entry */
 	using fs_cache_pair = std::pair<std::string, DirectoryListType>;
@@ -147,7 +177,28 @@ private:
 	mutable std::vector<dir_cache_pair> dir_cache;
 
 	/** lowered dir (full path from root) of missing directories */
-	mutable std::vector<std::string> dir_missing_cache;
+	mutable std::unordered_set<std::string> dir_missing_cache;
+
+	/** A directory of the persistent index */
+	struct IndexEntry {
+		/** real dir (full path from root) */
+		std::string dir;
+		Stamp stamp;
+		DirectoryListType entries;
+	};
+
+	/** lowered dir -> directories of the loaded index that were not validated yet */
+	using index_cache_pair = std::pair<std::string, IndexEntry>;
+	mutable std::vector<index_cache_pair> index_cache;
+
+	/** lowered dir -> stamp of the enumerated directories (only when the index is enabled) */
+	using stamp_cache_pair = std::pair<std::string, Stamp>;
+	mutable std::vector<stamp_cache_pair> stamp_cache;
+
+	mutable bool index_enabled = false;
+	mutable bool index_modified = false;
+
+	DirectoryListType* ListIndexedDirectory(const std::string& dir_key) const;
 
 	static bool WildcardMatch(const StringView& pattern, const StringView& text);
 
@@ -41,6 +41,7 @@
 #include "filesystem.h"
 #include "filesystem_root.h"
 #include "fileext_guesser.h"
+#include "game_clock.h"
 #include "output.h"
 #include "player.h"
 #include "registry.h"
@@ -61,6 +62,8 @@ namespace {
 	std::shared_ptr<Filesystem> root_fs;
 	FilesystemView game_fs;
 	FilesystemView save_fs;
+
+	constexpr const StringView DIRECTORY_INDEX_NAME = "directory_index.bin";
 }
 
 FilesystemView FileFinder::Game() {
@@ -138,6 +141,42 @@ FilesystemView FileFinder::Root() {
 	return root_fs->Subtree("");
 }
 
+void FileFinder::LoadDirectoryIndex(const FilesystemView& fs) {
+	auto start = Game_Clock::now();
+
+	Root();
+
+	Filesystem_Stream::InputStream is;
+	if (fs) {
+		is = fs.OpenInputStream(DIRECTORY_INDEX_NAME);
+	}
+
+	// An invalid stream enables the index without loading anything
+	if (root_fs->LoadDirectoryIndex(is)) {
+		Output::Debug("Directory index: Loaded {} ({}ms)", is.GetName(),
+			std::chrono::duration_cast<std::chrono::milliseconds>(Game_Clock::now() - start).count());
+	}
+}
+
+void FileFinder::SaveDirectoryIndex(const FilesystemView& fs) {
+	if (!root_fs || !fs) {
+		return;
+	}
+
+	// Serialized into memory first to not truncate the index when nothing changed
+	std::stringstream ss;
+	if (!root_fs->SaveDirectoryIndex(ss)) {
+		return;
+	}
+
+	auto os = fs.OpenOutputStream(DIRECTORY_INDEX_NAME);
+	if (!os) {
+		Output::Debug("Directory index: Cannot write {}", fs.GetFullPath());
+		return;
+	}
+	os << ss.rdbuf();
+}
+
 std::string FileFinder::MakePath(StringView dir, StringView name) {
 	std::string str;
 	if (dir.empty()) {
@@ -102,6 +102,24 @@ namespace FileFinder {
 	/** @return A filesystem handle for arbitrary file access inside the host filesystem */
 	FilesystemView Root();
 
+	/**
+	 * Loads the persistent directory index of the host filesystem.
+	 * Folders in the index are not read again when their modification time
+	 * and size did not change.
+	 *
+	 * @param fs Folder containing the index file
+	 */
+	void LoadDirectoryIndex(const FilesystemView& fs);
+
+	/**
+	 * Writes the directory index of the host filesystem when folders were
+	 * read since the index was loaded.
+	 * Does nothing when LoadDirectoryIndex was not called.
+	 *
+	 * @param fs Folder to write the index file to
+	 */
+	void SaveDirectoryIndex(const FilesystemView& fs);
+
 	/** @return A filesystem handle for file access inside the game directory */
 	FilesystemView Game();
 
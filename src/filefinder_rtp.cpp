@@ -233,18 +233,17 @@ void FileFinder_RTP::ReadRegistry(StringView company, StringView product, String
 #endif
 }
 
-Filesystem_Stream::InputStream FileFinder_RTP::LookupInternal(StringView dir, StringView name, const Span<const StringView> exts, bool& is_rtp_asset) const {
+FileFinder_RTP::Resolution FileFinder_RTP::LookupInternal(StringView dir, StringView name, const Span<const StringView> exts) const {
 	int version = Player::EngineVersion();
 
 	auto normal_search = [&]() {
-		is_rtp_asset = false;
 		for (const auto& path : search_paths) {
-			const std::string ret = path.FindFile(dir, name, exts);
+			std::string ret = path.FindFile(dir, name, exts);
 			if (!ret.empty()) {
-				return path.OpenInputStream(ret);
+				return Resolution{ path, std::move(ret), false };
 			}
 		}
-		return Filesystem_Stream::InputStream();
+		return Resolution();
 	};
 
 	// Detect the RTP version the game uses, when only one candidate is left the RTP is known
@@ -284,19 +283,17 @@ Filesystem_Stream::InputStream FileFinder_RTP::LookupInternal(StringView dir, St
 	if (game_rtp.empty()) {
 		// The game RTP is currently unknown because all requested assets by now were not in any RTP
 		// -> fallback to direct search
-		is_rtp_asset = false;
 		return normal_search();
 	}
 
 	// Search across all RTP
 	for (const auto& rtp : detected_rtp) {
 		for (RTP::Type grtp : game_rtp) {
-			std::string rtp_entry = RTP::LookupRtpToRtp(dir, name, grtp, rtp.type, &is_rtp_asset);
+			std::string rtp_entry = RTP::LookupRtpToRtp(dir, name, grtp, rtp.type);
 			if (!rtp_entry.empty()) {
 				std::string ret = rtp.tree.FindFile(dir, rtp_entry, exts);
 				if (!ret.empty()) {
-					is_rtp_asset = true;
-					return rtp.tree.OpenInputStream(ret);
+					return { rtp.tree, std::move(ret), true };
 				}
 			}
 		}
@@ -308,13 +305,31 @@ Filesystem_Stream::InputStream FileFinder_RTP::LookupInternal(StringView dir, St
 
 Filesystem_Stream::InputStream FileFinder_RTP::Lookup(StringView dir, StringView name, const Span<const StringView> exts) const {
 	if (!disable_rtp) {
-		bool is_rtp_asset;
-		auto is = LookupInternal(lcf::ReaderUtil::Normalize(dir), lcf::ReaderUtil::Normalize(name), exts, is_rtp_asset);
-
 		std::string lcase = lcf::ReaderUtil::Normalize(dir);
+		std::string name_normalized = lcf::ReaderUtil::Normalize(name);
+
+		std::string key = lcase + '/' + name_normalized;
+		for (const auto& ext : exts) {
+			key += '\0';
+			key.append(ext.data(), ext.size());
+		}
+
+		Resolution res;
+		auto cache_it = resolution_cache.find(key);
+		if (cache_it != resolution_cache.end()) {
+			res = cache_it->second;
+		} else {
+			res = LookupInternal(lcase, name_normalized, exts);
+			if (game_rtp.size() == 1) {
+				resolution_cache.emplace(std::move(key), res);
+			}
+		}
+
+		auto is = res.fs ? res.fs.OpenInputStream(res.path) : Filesystem_Stream::InputStream();
+
 		bool is_audio_asset = lcase == "music" || lcase == "sound";
 
-		if (is_rtp_asset) {
+		if (res.is_rtp_asset) {
 			if (is && game_has_full_package_flag && !warning_broken_rtp_game_shown && !is_audio_asset) {
 				warning_broken_rtp_game_shown = true;
 				Output::Warning("This game claims it does not need the RTP, but actually uses files from it!");
@@ -18,6 +18,7 @@
 #ifndef EP_FILEFINDER_RTP_H
 #define EP_FILEFINDER_RTP_H
 
+#include <unordered_map>
 #include "directory_tree.h"
 #include "rtp.h"
 #include "string_view.h"
@@ -44,9 +45,18 @@ public:
 	 Filesystem_Stream::InputStream Lookup(StringView dir, StringView name, const Span<const StringView> exts) const;
 
 private:
+	/** Result of a RTP lookup */
+	struct Resolution {
+		/** Filesystem containing the file, invalid when not found */
+		FilesystemView fs;
+		/** Path of the file in fs */
+		std::string path;
+		bool is_rtp_asset = false;
+	};
+
 	void AddPath(StringView p);
 	void ReadRegistry(StringView company, StringView product, StringView key);
-	Filesystem_Stream::InputStream LookupInternal(StringView dir, StringView name, const Span<const StringView> exts, bool& is_rtp_asset) const;
+	Resolution LookupInternal(StringView dir, StringView name, const Span<const StringView> exts) const;
 
 	using search_path_list = std::vector<FilesystemView>;
 
@@ -62,6 +72,12 @@ private:
 	std::vector<RTP::RtpHitInfo> detected_rtp;
 	/** the RTP the game uses, when only one left the RTP of the game is known */
 	mutable std::vector<RTP::Type> game_rtp;
+	/**
+	 * Lookup results by category, name and extensions.
+	 * Filled once the RTP of the game is known because until then every
+	 * lookup can change the result of later lookups.
+	 */
+	mutable std::unordered_map<std::string, Resolution> resolution_cache;
 };
 
 #endif
@@ -84,6 +84,14 @@ void Filesystem::ClearCache(StringView path) const {
 	tree->ClearCache(path);
 }
 
+bool Filesystem::LoadDirectoryIndex(std::istream& is) const {
+	return tree->LoadIndex(is);
+}
+
+bool Filesystem::SaveDirectoryIndex(std::ostream& os) const {
+	return tree->SaveIndex(os);
+}
+
 FilesystemView Filesystem::Create(StringView path) const {
 	// Determine the proper file system to use
 
@@ -179,6 +187,14 @@ bool Filesystem::MakeDirectory(StringView, bool) const {
 	return false;
 }
 
+bool Filesystem::RenameFile(StringView, StringView) const {
+	return false;
+}
+
+bool Filesystem::GetDirectoryStamp(StringView, DirectoryTree::Stamp&) const {
+	return false;
+}
+
 bool Filesystem::IsValid() const {
 	// FIXME: better way to do this?
 	return Exists("");
@@ -372,6 +388,18 @@ bool FilesystemView::MakeDirectory(StringView dir, bool follow_symlinks) const {
 	return fs->MakeDirectory(MakePath(dir), follow_symlinks);
 }
 
+bool FilesystemView::RenameFile(StringView from, StringView to) const {
+	assert(fs);
+	auto from_path = MakePath(from);
+	auto to_path = MakePath(to);
+	if (!fs->RenameFile(from_path, to_path)) {
+		return false;
+	}
+	fs->ClearCache(std::get<0>(FileFinder::GetPathAndFilename(from_path)));
+	fs->ClearCache(std::get<0>(FileFinder::GetPathAndFilename(to_path)));
+	return true;
+}
+
 bool FilesystemView::IsFeatureSupported(Filesystem::Feature f) const {
 	assert(fs);
 	return fs->IsFeatureSupported(f);
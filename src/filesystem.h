@@ -46,7 +46,9 @@ public:
 	/** Features provided by the filesystem */
 	enum class Feature {
 		/** Filesystem supports Write operations */
-		Write = 1
+		Write = 1,
+		/** Filesystem supports replacing a file by renaming another one */
+		Rename = 2
 	};
 
 	virtual ~Filesystem() = default;
@@ -127,6 +129,24 @@ public:
 	 */
 	void ClearCache(StringView path) const;
 
+	/**
+	 * Loads a persistent index of the directory tree.
+	 *
+	 * @see DirectoryTree::LoadIndex
+	 * @param is stream to read the index from
+	 * @return true when an index was loaded
+	 */
+	virtual bool LoadDirectoryIndex(std::istream& is) const;
+
+	/**
+	 * Writes a persistent index of the directory tree.
+	 *
+	 * @see DirectoryTree::SaveIndex
+	 * @param os stream to write the index to
+	 * @return true when the index was written, false when it did not change
+	 */
+	virtual bool SaveDirectoryIndex(std::ostream& os) const;
+
 	/**
 	 * Creates a new appropriate filesystem from the specified path.
 	 * The path is processed to initialize the proper virtual filesystem handler.
@@ -220,6 +240,7 @@ public:
 	virtual bool Exists(StringView path) const = 0;
 	virtual int64_t GetFilesize(StringView path) const = 0;
 	virtual bool MakeDirectory(StringView dir, bool follow_symlinks) const;
+	virtual bool RenameFile(StringView from, StringView to) const;
 	virtual bool IsFeatureSupported(Feature f) const;
 	virtual std::string Describe() const = 0;
 	/** @} */
@@ -232,6 +253,8 @@ protected:
 	virtual bool GetDirectoryContent(StringView path, std::vector<DirectoryTree::Entry>& entries) const = 0;
 	virtual std::streambuf* CreateInputStreambuffer(StringView path, std::ios_base::openmode mode) const = 0;
 	virtual std::streambuf* CreateOutputStreambuffer(StringView path, std::ios_base::openmode mode) const;
+	/** @return false when the filesystem cannot detect directory changes (default) */
+	virtual bool GetDirectoryStamp(StringView path, DirectoryTree::Stamp& stamp) const;
 	/** @} */
 
 	/**
@@ -461,6 +484,16 @@ public:
 	 */
 	bool MakeDirectory(StringView dir, bool follow_symlinks) const;
 
+	/**
+	 * Renames a file, an existing file at the target is replaced.
+	 * Not all filesystems support renaming.
+	 *
+	 * @param from File to rename
+	 * @param to New name of the file
+	 * @return true when the file was renamed
+	 */
+	bool RenameFile(StringView from, StringView to) const;
+
 	/**
 	 * @param f Filesystem feature to check
 	 * @return true when the feature is supported.
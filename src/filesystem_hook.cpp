@@ -106,6 +106,10 @@ bool HookFilesystem::MakeDirectory(StringView dir, bool follow_symlinks) const {
 	return GetParent().MakeDirectory(dir, follow_symlinks);
 }
 
+bool HookFilesystem::RenameFile(StringView from, StringView to) const {
+	return GetParent().RenameFile(from, to);
+}
+
 bool HookFilesystem::IsFeatureSupported(Feature f) const {
 	return GetParent().IsFeatureSupported(f);
 }
@@ -44,6 +44,7 @@ public:
 	bool Exists(StringView path) const override;
 	int64_t GetFilesize(StringView path) const override;
 	bool MakeDirectory(StringView dir, bool follow_symlinks) const override;
+	bool RenameFile(StringView from, StringView to) const override;
 	bool IsFeatureSupported(Feature f) const override;
 	std::string Describe() const override;
 	/** @} */
@@ -74,6 +74,178 @@ static LHAInputStreamType vio = {
 	nullptr // close not supported by istream interface
 };
 
+static uint32_t streaming_threshold = 1024 * 1024;
+static size_t cache_limit = 8 * 1024 * 1024;
+
+namespace {
+	/** Streambuf on a decompressed entry that is shared with the entry cache */
+	class LzhCachedStreamBuf : public Filesystem_Stream::InputMemoryStreamBufView {
+	public:
+		explicit LzhCachedStreamBuf(std::shared_ptr<std::vector<uint8_t>> data) :
+			InputMemoryStreamBufView(*data), data(std::move(data)) {}
+
+	private:
+		std::shared_ptr<std::vector<uint8_t>> data;
+	};
+
+	/**
+	 * Streambuf that reads a LZH entry through its own file handle.
+	 * The data is decoded window by window while reading.
+	 * Seeking backwards restarts decoding from the beginning of the entry.
+	 */
+	class LzhEntryStreamBuf : public std::streambuf {
+	public:
+		LzhEntryStreamBuf(Filesystem_Stream::InputStream is, std::streamoff data_offset,
+			LHADecoderType* decoder_type, size_t uncompressed_size, std::string name);
+
+		LzhEntryStreamBuf(const LzhEntryStreamBuf&) = delete;
+		LzhEntryStreamBuf& operator=(const LzhEntryStreamBuf&) = delete;
+
+	protected:
+		int_type underflow() override;
+		pos_type seekoff(off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) override;
+		pos_type seekpos(pos_type pos, std::ios_base::openmode mode) override;
+
+	private:
+		struct DecoderDeleter {
+			void operator()(LHADecoder* o) const {
+				lha_decoder_free(o);
+			}
+		};
+
+		static constexpr size_t window_size = 64 * 1024;
+
+		bool Fill();
+		bool Restart();
+		bool Seek(size_t pos);
+		size_t WindowStart() const;
+
+		Filesystem_Stream::InputStream is;
+		std::streamoff data_offset;
+		LHADecoderType* decoder_type;
+		size_t uncompressed_size;
+		std::string name;
+
+		std::unique_ptr<LHADecoder, DecoderDeleter> decoder;
+		/** Uncompressed position of the end of the window */
+		size_t out_pos = 0;
+		/** Seeks outside of the window are deferred until the next read */
+		size_t seek_pos = 0;
+		bool seek_pending = false;
+		std::vector<char> out_buf;
+	};
+
+	LzhEntryStreamBuf::LzhEntryStreamBuf(Filesystem_Stream::InputStream is, std::streamoff data_offset,
+			LHADecoderType* decoder_type, size_t uncompressed_size, std::string name) :
+		is(std::move(is)), data_offset(data_offset), decoder_type(decoder_type),
+		uncompressed_size(uncompressed_size), name(std::move(name)),
+		out_buf(std::min<size_t>(window_size, std::max<size_t>(uncompressed_size, 1))) {
+		Restart();
+	}
+
+	size_t LzhEntryStreamBuf::WindowStart() const {
+		return out_pos - static_cast<size_t>(egptr() - eback());
+	}
+
+	bool LzhEntryStreamBuf::Restart() {
+		// lhasa decoders cannot be rewound: Create a new one
+		is.clear();
+		is.seekg(data_offset);
+		decoder.reset(lha_decoder_new(decoder_type, vio_read_dec_func, &is, uncompressed_size));
+		out_pos = 0;
+		setg(out_buf.data(), out_buf.data(), out_buf.data());
+		return decoder && is;
+	}
+
+	bool LzhEntryStreamBuf::Fill() {
+		if (!decoder) {
+			return false;
+		}
+
+		char* window = out_buf.data();
+		size_t window_len = std::min<size_t>(out_buf.size(), uncompressed_size - out_pos);
+		size_t produced = lha_decoder_read(decoder.get(), reinterpret_cast<uint8_t*>(window), window_len);
+		if (produced < window_len) {
+			Output::Warning("LzhFS: Less data compressed than expected ({})", name);
+		}
+
+		out_pos += produced;
+		setg(window, window, window + produced);
+		return produced > 0;
+	}
+
+	bool LzhEntryStreamBuf::Seek(size_t pos) {
+		if (pos < WindowStart() && !Restart()) {
+			return false;
+		}
+
+		// Decode until the target is in the window
+		while (out_pos <= pos) {
+			if (!Fill()) {
+				return false;
+			}
+		}
+		setg(eback(), eback() + (pos - WindowStart()), egptr());
+		return true;
+	}
+
+	LzhEntryStreamBuf::int_type LzhEntryStreamBuf::underflow() {
+		if (seek_pending) {
+			if (seek_pos >= uncompressed_size) {
+				return traits_type::eof();
+			}
+			seek_pending = false;
+			if (!Seek(seek_pos)) {
+				return traits_type::eof();
+			}
+		}
+		if (gptr() < egptr()) {
+			return traits_type::to_int_type(*gptr());
+		}
+		if (out_pos >= uncompressed_size || !Fill()) {
+			return traits_type::eof();
+		}
+		return traits_type::to_int_type(*gptr());
+	}
+
+	std::streambuf::pos_type LzhEntryStreamBuf::seekoff(off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) {
+		if (!(mode & std::ios_base::in)) {
+			return -1;
+		}
+
+		size_t window_start = WindowStart();
+		off_type target;
+		if (dir == std::ios_base::beg) {
+			target = offset;
+		} else if (dir == std::ios_base::cur) {
+			target = static_cast<off_type>(seek_pending ? seek_pos : window_start + (gptr() - eback())) + offset;
+		} else {
+			target = static_cast<off_type>(uncompressed_size) + offset;
+		}
+
+		if (target < 0 || target > static_cast<off_type>(uncompressed_size)) {
+			return -1;
+		}
+
+		auto pos = static_cast<size_t>(target);
+		if (pos >= window_start && pos <= out_pos) {
+			// Inside of the current window
+			seek_pending = false;
+			setg(eback(), eback() + (pos - window_start), egptr());
+		} else {
+			// Determining the size by seeking to the end must not decode the whole entry
+			seek_pending = true;
+			seek_pos = pos;
+			setg(eback(), egptr(), egptr());
+		}
+		return target;
+	}
+
+	std::streambuf::pos_type LzhEntryStreamBuf::seekpos(pos_type pos, std::ios_base::openmode mode) {
+		return seekoff(pos, std::ios_base::beg, mode);
+	}
+}
+
 LzhFilesystem::LzhFilesystem(std::string base_path, FilesystemView parent_fs, StringView enc) :
 	Filesystem(base_path, parent_fs) {
 	is = parent_fs.OpenInputStream(GetPath());
@@ -275,39 +447,94 @@ int64_t LzhFilesystem::GetFilesize(StringView path) const {
 	return 0;
 }
 
+void LzhFilesystem::SetStreamingThreshold(uint32_t size) {
+	streaming_threshold = size;
+}
+
+void LzhFilesystem::SetCacheLimit(size_t size) {
+	cache_limit = size;
+}
+
 std::streambuf* LzhFilesystem::CreateInputStreambuffer(StringView path, std::ios_base::openmode) const {
 	std::string path_normalized = normalize_path(path);
 	auto entry = Find(path);
-	if (entry && !entry->is_directory) {
-		// Determine compression method
-		auto* decoder_type = lha_decoder_for_name(const_cast<char*>(entry->compress_method.c_str()));
+	if (!entry || entry->is_directory) {
+		return nullptr;
+	}
 
-		if (!decoder_type) {
-			Output::Warning("LzhFS: Unsupported compression method {} for {}", entry->compress_method, path_normalized);
+	// Determine compression method
+	auto* decoder_type = lha_decoder_for_name(const_cast<char*>(entry->compress_method.c_str()));
+
+	if (!decoder_type) {
+		Output::Warning("LzhFS: Unsupported compression method {} for {}", entry->compress_method, path_normalized);
+		return nullptr;
+	}
+
+	// Large entries are streamed through an own handle, this also allows reading them in parallel
+	if (entry->uncompressed_size >= streaming_threshold) {
+		Filesystem_Stream::InputStream stream_is;
+#ifdef USE_MMAP
+		auto* lzh_map = dynamic_cast<Filesystem_Stream::InputMappedStreamBuf*>(is.rdbuf());
+		if (lzh_map) {
+			stream_is = Filesystem_Stream::InputStream(lzh_map->CreateSubView(0, lzh_map->GetData().size()), GetPath());
+		} else
+#endif
+		{
+			stream_is = GetParent().OpenInputStream(GetPath());
+		}
+		if (!stream_is) {
+			Output::Warning("LzhFS: Cannot open {} for streaming {}", GetPath(), path_normalized);
 			return nullptr;
 		}
+		return new LzhEntryStreamBuf(std::move(stream_is), entry->fileoffset, decoder_type, entry->uncompressed_size, path_normalized);
+	}
 
-		// Seek to the compressed data
-		is.clear();
-		is.seekg(entry->fileoffset, std::ios_base::beg);
+	std::lock_guard<std::mutex> lock(is_mutex);
 
-		// Create a suitable decoder for the compression method
-		std::unique_ptr<LHADecoder, LhasaDeleter> decoder;
-		decoder.reset(lha_decoder_new(decoder_type, vio_read_dec_func, &is, entry->uncompressed_size));
+	auto cache_it = entry_cache.find(entry);
+	if (cache_it != entry_cache.end()) {
+		cache_it->second.last_use = ++entry_cache_uses;
+		return new LzhCachedStreamBuf(cache_it->second.data);
+	}
 
-		// Decompress
-		auto dec_buf = std::vector<uint8_t>(entry->uncompressed_size);
-		size_t res = lha_decoder_read(decoder.get(), dec_buf.data(), dec_buf.size());
+	// Seek to the compressed data
+	is.clear();
+	is.seekg(entry->fileoffset, std::ios_base::beg);
 
-		if (res != entry->uncompressed_size) {
-			Output::Warning("LzhFS: Less data compressed than expected ({})", path_normalized);
-			return nullptr;
-		}
+	// Create a suitable decoder for the compression method
+	std::unique_ptr<LHADecoder, LhasaDeleter> decoder;
+	decoder.reset(lha_decoder_new(decoder_type, vio_read_dec_func, &is, entry->uncompressed_size));
 
-		return new Filesystem_Stream::InputMemoryStreamBuf(std::move(dec_buf));
+	// Decompress
+	auto dec_buf = std::make_shared<std::vector<uint8_t>>(entry->uncompressed_size);
+	size_t res = lha_decoder_read(decoder.get(), dec_buf->data(), dec_buf->size());
+
+	if (res != entry->uncompressed_size) {
+		Output::Warning("LzhFS: Less data compressed than expected ({})", path_normalized);
+		return nullptr;
 	}
 
-	return nullptr;
+	AddToCache(entry, dec_buf);
+
+	return new LzhCachedStreamBuf(std::move(dec_buf));
+}
+
+void LzhFilesystem::AddToCache(const LzhEntry* entry, std::shared_ptr<std::vector<uint8_t>> data) const {
+	if (data->size() > cache_limit) {
+		return;
+	}
+
+	// Evict the least recently used entries. Streams keep their data alive.
+	while (!entry_cache.empty() && entry_cache_size + data->size() > cache_limit) {
+		auto oldest = std::min_element(entry_cache.begin(), entry_cache.end(), [](const auto& a, const auto& b) {
+			return a.second.last_use < b.second.last_use;
+		});
+		entry_cache_size -= oldest->second.data->size();
+		entry_cache.erase(oldest);
+	}
+
+	entry_cache_size += data->size();
+	entry_cache[entry] = { std::move(data), ++entry_cache_uses };
 }
 
 bool LzhFilesystem::GetDirectoryContent(StringView path, std::vector<DirectoryTree::Entry>& entries) const {
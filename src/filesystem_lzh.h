@@ -26,6 +26,7 @@
 #include "filesystem_stream.h"
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -45,6 +46,23 @@ public:
 	 */
 	LzhFilesystem(std::string base_path, FilesystemView parent_fs, StringView encoding = "");
 
+	/**
+	 * Entries of at least this uncompressed size are decoded lazily while
+	 * reading through an own file handle instead of being loaded into memory.
+	 *
+	 * @param size threshold in bytes (default: 1 MiB)
+	 */
+	static void SetStreamingThreshold(uint32_t size);
+
+	/**
+	 * Decompressed entries below the streaming threshold are kept in memory
+	 * and shared by all streams opened on them until this limit is exceeded.
+	 * The least recently opened entries are evicted first.
+	 *
+	 * @param size limit in bytes per archive (default: 8 MiB), 0 disables the cache
+	 */
+	static void SetCacheLimit(size_t size);
+
 protected:
 	/**
  	 * Implementation of abstract methods
@@ -68,7 +86,13 @@ private:
 		bool is_directory;
 	};
 
+	struct CachedEntry {
+		std::shared_ptr<std::vector<uint8_t>> data;
+		uint64_t last_use;
+	};
+
 	const LzhEntry* Find(StringView what) const;
+	void AddToCache(const LzhEntry* entry, std::shared_ptr<std::vector<uint8_t>> data) const;
 
 	std::vector<std::pair<std::string, LzhEntry>> lzh_entries;
 	std::string encoding;
@@ -91,6 +115,12 @@ private:
 	mutable Filesystem_Stream::InputStream is;
 	mutable std::unique_ptr<LHAInputStream, LhasaDeleter> lha_is;
 	mutable std::unique_ptr<LHAReader, LhasaDeleter> lha_reader;
+	/** Protects is and the entry cache, streamed entries use their own handle */
+	mutable std::mutex is_mutex;
+
+	mutable std::unordered_map<const LzhEntry*, CachedEntry> entry_cache;
+	mutable size_t entry_cache_size = 0;
+	mutable uint64_t entry_cache_uses = 0;
 };
 
 #endif
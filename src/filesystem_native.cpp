@@ -30,11 +30,48 @@
 #include "output.h"
 #include "platform.h"
 
-#ifdef USE_CUSTOM_FILEBUF
+#if defined(USE_CUSTOM_FILEBUF) || defined(USE_MMAP)
 #  include <sys/stat.h>
 #  include <fcntl.h>
 #endif
 
+#ifdef USE_MMAP
+#  include <unistd.h>
+
+namespace {
+	/** Files smaller than this are read into memory at once, larger files are mapped */
+	constexpr off_t mmap_threshold = 64 * 1024;
+
+	std::streambuf* CreateMemoryStreambuffer(int fd) {
+		struct stat st;
+		if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+			return nullptr;
+		}
+
+		if (st.st_size >= mmap_threshold) {
+			return Filesystem_Stream::InputMappedStreamBuf::Create(fd, static_cast<size_t>(st.st_size));
+		}
+
+		std::vector<uint8_t> buffer(static_cast<size_t>(st.st_size));
+		size_t pos = 0;
+		while (pos < buffer.size()) {
+			ssize_t res = read(fd, buffer.data() + pos, buffer.size() - pos);
+			if (res < 0 && errno == EINTR) {
+				continue;
+			} else if (res < 0) {
+				return nullptr;
+			} else if (res == 0) {
+				break;
+			}
+			pos += static_cast<size_t>(res);
+		}
+		buffer.resize(pos);
+
+		return new Filesystem_Stream::InputMemoryStreamBuf(std::move(buffer));
+	}
+}
+#endif
+
 NativeFilesystem::NativeFilesystem(std::string base_path, FilesystemView parent_fs) : Filesystem(std::move(base_path), parent_fs) {
 }
 
@@ -55,6 +92,20 @@ int64_t NativeFilesystem::GetFilesize(StringView path) const {
 }
 
 std::streambuf* NativeFilesystem::CreateInputStreambuffer(StringView path, std::ios_base::openmode mode) const {
+#ifdef USE_MMAP
+	int fd = open(ToString(path).c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return nullptr;
+	}
+
+	auto* mem_buf = CreateMemoryStreambuffer(fd);
+	close(fd);
+	if (mem_buf) {
+		return mem_buf;
+	}
+	// Not a regular file or mapping failed: Use a file stream
+#endif
+
 #ifdef USE_CUSTOM_FILEBUF
 	(void)mode;
 	int fd = open(ToString(path).c_str(), O_RDONLY);
@@ -152,8 +203,19 @@ bool NativeFilesystem::MakeDirectory(StringView path, bool follow_symlinks) cons
 	return Platform::File(ToString(path)).MakeDirectory(follow_symlinks);
 }
 
+bool NativeFilesystem::GetDirectoryStamp(StringView path, DirectoryTree::Stamp& stamp) const {
+	Platform::File dir(ToString(path));
+	stamp.mtime = dir.GetModifiedTime();
+	stamp.size = dir.GetSize();
+	return stamp.mtime >= 0 && stamp.size >= 0;
+}
+
+bool NativeFilesystem::RenameFile(StringView from, StringView to) const {
+	return Platform::File(ToString(from)).Rename(ToString(to));
+}
+
 bool NativeFilesystem::IsFeatureSupported(Feature f) const {
-	return f == Filesystem::Feature::Write;
+	return f == Filesystem::Feature::Write || f == Filesystem::Feature::Rename;
 }
 
 std::string NativeFilesystem::Describe() const {
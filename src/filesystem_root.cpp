@@ -57,6 +57,14 @@ FilesystemView RootFilesystem::Create(StringView path) const {
 	return fs.Create(path);
 }
 
+bool RootFilesystem::LoadDirectoryIndex(std::istream& is) const {
+	return FilesystemForPath("").LoadDirectoryIndex(is);
+}
+
+bool RootFilesystem::SaveDirectoryIndex(std::ostream& os) const {
+	return FilesystemForPath("").SaveDirectoryIndex(os);
+}
+
 bool RootFilesystem::IsFile(StringView path) const {
 	return FilesystemForPath(path).IsFile(path);
 }
@@ -98,6 +106,10 @@ bool RootFilesystem::MakeDirectory(StringView path, bool follow_symlinks) const
 	return FilesystemForPath(path).MakeDirectory(path, follow_symlinks);
 }
 
+bool RootFilesystem::RenameFile(StringView from, StringView to) const {
+	return FilesystemForPath(from).RenameFile(from, to);
+}
+
 std::string RootFilesystem::Describe() const {
 	return "[Root]";
 }
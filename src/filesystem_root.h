@@ -55,6 +55,15 @@ public:
 	 */
 	FilesystemView Create(StringView path) const override;
 
+	/**
+	 * The index is handled by the NativeFilesystem because all non-prefixed
+	 * paths are forwarded to it.
+	 */
+	/** @{ */
+	bool LoadDirectoryIndex(std::istream& is) const override;
+	bool SaveDirectoryIndex(std::ostream& os) const override;
+	/** @} */
+
 protected:
 	/**
  	 * Implementation of abstract methods
@@ -68,6 +77,7 @@ protected:
 	std::streambuf* CreateOutputStreambuffer(StringView path, std::ios_base::openmode mode) const override;
 	bool GetDirectoryContent(StringView path, std::vector<DirectoryTree::Entry>& entries) const override;
 	bool MakeDirectory(StringView path, bool follow_symlinks) const override;
+	bool RenameFile(StringView from, StringView to) const override;
 	std::string Describe() const override;
 	/** @} */
 
@@ -23,6 +23,10 @@
 #  include <unistd.h>
 #endif
 
+#ifdef USE_MMAP
+#  include <sys/mman.h>
+#endif
+
 Filesystem_Stream::InputStream::InputStream(std::streambuf* sb, std::string name) :
 	std::istream(sb), name(std::move(name)) {}
 
@@ -59,6 +63,14 @@ std::streampos Filesystem_Stream::InputStream::GetSize() const {
 	return size;
 }
 
+Span<const uint8_t> Filesystem_Stream::InputStream::GetData() const {
+	auto* buf = dynamic_cast<InputMemoryStreamBufView*>(rdbuf());
+	if (!buf) {
+		return {};
+	}
+	return buf->GetRemainingData();
+}
+
 void Filesystem_Stream::InputStream::Close() {
 	delete rdbuf();
 	set_rdbuf(nullptr);
@@ -104,6 +116,14 @@ Filesystem_Stream::InputMemoryStreamBufView::InputMemoryStreamBufView(Span<uint8
 	setg(cbuffer, cbuffer, cbuffer + buffer_view.size());
 }
 
+Span<const uint8_t> Filesystem_Stream::InputMemoryStreamBufView::GetData() const {
+	return buffer_view;
+}
+
+Span<const uint8_t> Filesystem_Stream::InputMemoryStreamBufView::GetRemainingData() const {
+	return buffer_view.subspan(gptr() - eback());
+}
+
 std::streambuf::pos_type Filesystem_Stream::InputMemoryStreamBufView::seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) {
 	std::streambuf::pos_type off;
 	if (dir == std::ios_base::beg) {
@@ -127,6 +147,39 @@ Filesystem_Stream::InputMemoryStreamBuf::InputMemoryStreamBuf(std::vector<uint8_
 
 }
 
+#ifdef USE_MMAP
+
+Filesystem_Stream::InputMappedStreamBuf::Mapping::~Mapping() {
+	munmap(addr, size);
+}
+
+Filesystem_Stream::InputMappedStreamBuf* Filesystem_Stream::InputMappedStreamBuf::Create(int fd, size_t size) {
+	if (size == 0) {
+		return nullptr;
+	}
+
+	void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (addr == MAP_FAILED) {
+		return nullptr;
+	}
+
+	return new InputMappedStreamBuf(std::make_shared<Mapping>(addr, size), 0, size);
+}
+
+Filesystem_Stream::InputMappedStreamBuf* Filesystem_Stream::InputMappedStreamBuf::CreateSubView(size_t sub_offset, size_t size) const {
+	size_t view_size = GetData().size();
+	if (sub_offset > view_size || size > view_size - sub_offset) {
+		return nullptr;
+	}
+	return new InputMappedStreamBuf(mapping, offset + sub_offset, size);
+}
+
+Filesystem_Stream::InputMappedStreamBuf::InputMappedStreamBuf(std::shared_ptr<Mapping> mapping, size_t offset, size_t size)
+		: InputMemoryStreamBufView(Span<uint8_t>(static_cast<uint8_t*>(mapping->addr) + offset, size)), mapping(std::move(mapping)), offset(offset) {
+}
+
+#endif
+
 #ifdef USE_CUSTOM_FILEBUF
 
 Filesystem_Stream::FdStreamBuf::FdStreamBuf(int fd, bool is_read) : fd(fd), is_read(is_read) {
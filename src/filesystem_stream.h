@@ -41,6 +41,18 @@ namespace Filesystem_Stream {
 		std::streampos GetSize() const;
 		void Close();
 
+		/**
+		 * Provides direct access to the content when the stream is backed by
+		 * memory (in-memory buffers and memory mapped files).
+		 * The data starts at the current read position and is valid as long
+		 * as the stream is open. Reading through the span does not advance
+		 * the read position.
+		 *
+		 * @return remaining content of the stream or an empty span when not
+		 * memory backed
+		 */
+		Span<const uint8_t> GetData() const;
+
 		template <typename T>
 		bool ReadIntoObj(T& obj);
 
@@ -78,6 +90,12 @@ namespace Filesystem_Stream {
 		InputMemoryStreamBufView(InputMemoryStreamBufView const& other) = delete;
 		InputMemoryStreamBufView const& operator=(InputMemoryStreamBufView const& other) = delete;
 
+		/** @return the whole buffer */
+		Span<const uint8_t> GetData() const;
+
+		/** @return the buffer from the current read position on */
+		Span<const uint8_t> GetRemainingData() const;
+
 	protected:
 		std::streambuf::pos_type seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) override;
 		std::streambuf::pos_type seekpos(std::streambuf::pos_type pos, std::ios_base::openmode mode) override;
@@ -97,6 +115,50 @@ namespace Filesystem_Stream {
 		std::vector<uint8_t> buffer;
 	};
 
+#ifdef USE_MMAP
+	/**
+	 * Streambuf interface for a read-only memory mapped file.
+	 * Sub views share the mapping, it is unmapped when the last view is deleted.
+	 */
+	class InputMappedStreamBuf : public InputMemoryStreamBufView {
+	public:
+		/**
+		 * Maps the whole file.
+		 * The file descriptor is not needed anymore afterwards and can be closed.
+		 *
+		 * @param fd file descriptor opened for reading
+		 * @param size size of the file
+		 * @return streambuf or nullptr when mapping failed
+		 */
+		static InputMappedStreamBuf* Create(int fd, size_t size);
+
+		/**
+		 * Creates a streambuf for a part of the mapping without copying.
+		 *
+		 * @param offset start of the view
+		 * @param size size of the view
+		 * @return streambuf or nullptr when the range is out of bounds
+		 */
+		InputMappedStreamBuf* CreateSubView(size_t offset, size_t size) const;
+
+	private:
+		struct Mapping {
+			Mapping(void* addr, size_t size) : addr(addr), size(size) {}
+			Mapping(Mapping const& other) = delete;
+			Mapping const& operator=(Mapping const& other) = delete;
+			~Mapping();
+
+			void* addr;
+			size_t size;
+		};
+
+		InputMappedStreamBuf(std::shared_ptr<Mapping> mapping, size_t offset, size_t size);
+
+		std::shared_ptr<Mapping> mapping;
+		size_t offset;
+	};
+#endif
+
 #ifdef USE_CUSTOM_FILEBUF
 	class FdStreamBuf : public std::streambuf {
 	public:
@@ -37,6 +37,261 @@ constexpr uint32_t central_directory_entry = 0x02014b50;
 constexpr uint32_t local_header = 0x04034b50;
 constexpr uint32_t local_header_size = 30;
 
+static uint32_t streaming_threshold = 1024 * 1024;
+
+namespace {
+	/**
+	 * Streambuf that reads a ZIP entry through its own file handle.
+	 * Deflate data is inflated window by window while reading.
+	 * Seeking backwards restarts inflating from the closest checkpoint.
+	 */
+	class ZipEntryStreamBuf : public std::streambuf {
+	public:
+		ZipEntryStreamBuf(Filesystem_Stream::InputStream is, std::streamoff data_offset,
+			uint32_t compressed_size, uint32_t uncompressed_size, bool deflate, std::string name);
+		~ZipEntryStreamBuf() override;
+
+		ZipEntryStreamBuf(const ZipEntryStreamBuf&) = delete;
+		ZipEntryStreamBuf& operator=(const ZipEntryStreamBuf&) = delete;
+
+	protected:
+		int_type underflow() override;
+		pos_type seekoff(off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) override;
+		pos_type seekpos(pos_type pos, std::ios_base::openmode mode) override;
+
+	private:
+		/** Inflater state at a deflate block boundary */
+		struct Checkpoint {
+			uint32_t in;
+			uint32_t out;
+			int bits;
+			std::vector<uint8_t> dictionary;
+		};
+
+		static constexpr size_t window_size = 64 * 1024;
+		static constexpr size_t input_size = 16 * 1024;
+		/** Minimum uncompressed distance between two checkpoints */
+		static constexpr uint32_t checkpoint_span = 1024 * 1024;
+
+		bool Fill();
+		bool Restart(const Checkpoint& cp);
+		bool Seek(uint32_t pos);
+		uint32_t WindowStart() const;
+
+		Filesystem_Stream::InputStream is;
+		std::streamoff data_offset;
+		uint32_t compressed_size;
+		uint32_t uncompressed_size;
+		bool deflate;
+		std::string name;
+
+		z_stream zlib_stream = {};
+		/** Compressed bytes read from the file */
+		uint32_t in_pos = 0;
+		/** Uncompressed position of the end of the window */
+		uint32_t out_pos = 0;
+		/** Seeks outside of the window are deferred until the next read */
+		uint32_t seek_pos = 0;
+		bool seek_pending = false;
+		std::vector<char> in_buf;
+		std::vector<char> out_buf;
+		std::vector<Checkpoint> checkpoints;
+	};
+
+	ZipEntryStreamBuf::ZipEntryStreamBuf(Filesystem_Stream::InputStream is, std::streamoff data_offset,
+			uint32_t compressed_size, uint32_t uncompressed_size, bool deflate, std::string name) :
+		is(std::move(is)), data_offset(data_offset), compressed_size(compressed_size),
+		uncompressed_size(uncompressed_size), deflate(deflate), name(std::move(name)),
+		out_buf(std::min<size_t>(window_size, std::max<uint32_t>(uncompressed_size, 1))) {
+		if (deflate) {
+			in_buf.resize(input_size);
+			inflateInit2(&zlib_stream, -MAX_WBITS);
+			checkpoints.push_back({0, 0, 0, {}});
+		}
+		this->is.seekg(data_offset);
+		setg(out_buf.data(), out_buf.data(), out_buf.data());
+	}
+
+	ZipEntryStreamBuf::~ZipEntryStreamBuf() {
+		if (deflate) {
+			inflateEnd(&zlib_stream);
+		}
+	}
+
+	uint32_t ZipEntryStreamBuf::WindowStart() const {
+		return out_pos - static_cast<uint32_t>(egptr() - eback());
+	}
+
+	bool ZipEntryStreamBuf::Fill() {
+		char* window = out_buf.data();
+		uint32_t window_len = std::min<uint32_t>(out_buf.size(), uncompressed_size - out_pos);
+		uint32_t produced = 0;
+
+		if (!deflate) {
+			is.read(window, window_len);
+			produced = static_cast<uint32_t>(is.gcount());
+		} else {
+			zlib_stream.next_out = reinterpret_cast<Bytef*>(window);
+			zlib_stream.avail_out = window_len;
+
+			while (zlib_stream.avail_out > 0) {
+				if (zlib_stream.avail_in == 0) {
+					uint32_t len = std::min<uint32_t>(in_buf.size(), compressed_size - in_pos);
+					is.read(in_buf.data(), len);
+					len = static_cast<uint32_t>(is.gcount());
+					if (len == 0) {
+						Output::Warning("ZipFS: Unexpected end of data in {} (Archive corrupted?)", name);
+						break;
+					}
+					in_pos += len;
+					zlib_stream.next_in = reinterpret_cast<Bytef*>(in_buf.data());
+					zlib_stream.avail_in = len;
+				}
+
+				// Z_BLOCK stops at block boundaries where checkpoints can be taken
+				int zlib_error = inflate(&zlib_stream, Z_BLOCK);
+				if (zlib_error == Z_STREAM_END) {
+					break;
+				}
+				if (zlib_error != Z_OK) {
+					Output::Warning("ZipFS: zlib failed for {}: {} ({})", name, zlib_error, zlib_stream.msg ? zlib_stream.msg : "No error message");
+					break;
+				}
+
+				uint32_t total_out = out_pos + (window_len - zlib_stream.avail_out);
+				bool block_boundary = (zlib_stream.data_type & 128) && !(zlib_stream.data_type & 64);
+				// After a restart the region is re-inflated, only add checkpoints for new data
+				if (block_boundary && total_out >= checkpoints.back().out + checkpoint_span) {
+#if ZLIB_VERNUM >= 0x1271
+					Checkpoint cp;
+					cp.in = in_pos - zlib_stream.avail_in;
+					cp.out = total_out;
+					cp.bits = zlib_stream.data_type & 7;
+					cp.dictionary.resize(32768);
+					uInt dict_len = 0;
+					inflateGetDictionary(&zlib_stream, cp.dictionary.data(), &dict_len);
+					cp.dictionary.resize(dict_len);
+					checkpoints.push_back(std::move(cp));
+#endif
+				}
+			}
+			produced = window_len - zlib_stream.avail_out;
+		}
+
+		out_pos += produced;
+		setg(window, window, window + produced);
+		return produced > 0;
+	}
+
+	bool ZipEntryStreamBuf::Restart(const Checkpoint& cp) {
+		inflateReset(&zlib_stream);
+		zlib_stream.avail_in = 0;
+		in_pos = cp.in;
+		out_pos = cp.out;
+		setg(out_buf.data(), out_buf.data(), out_buf.data());
+
+		is.clear();
+		if (cp.bits > 0) {
+			// The block starts inside of a byte: Feed the remaining bits
+			is.seekg(data_offset + cp.in - 1);
+			int byte = is.get();
+			if (byte == EOF) {
+				return false;
+			}
+			inflatePrime(&zlib_stream, cp.bits, byte >> (8 - cp.bits));
+		} else {
+			is.seekg(data_offset + cp.in);
+		}
+		if (!cp.dictionary.empty()) {
+			inflateSetDictionary(&zlib_stream, cp.dictionary.data(), static_cast<uInt>(cp.dictionary.size()));
+		}
+		return static_cast<bool>(is);
+	}
+
+	bool ZipEntryStreamBuf::Seek(uint32_t pos) {
+		if (!deflate) {
+			is.clear();
+			is.seekg(data_offset + pos);
+			out_pos = pos;
+			return Fill();
+		}
+
+		// Restart from the last checkpoint before the target when seeking backwards
+		// or when the checkpoint is behind the inflated data
+		auto cp = std::upper_bound(checkpoints.begin(), checkpoints.end(), pos, [](uint32_t p, const Checkpoint& c) {
+			return p < c.out;
+		}) - 1;
+		if ((pos < WindowStart() || cp->out > out_pos) && !Restart(*cp)) {
+			return false;
+		}
+
+		// Inflate until the target is in the window
+		while (out_pos <= pos) {
+			if (!Fill()) {
+				return false;
+			}
+		}
+		setg(eback(), eback() + (pos - WindowStart()), egptr());
+		return true;
+	}
+
+	ZipEntryStreamBuf::int_type ZipEntryStreamBuf::underflow() {
+		if (seek_pending) {
+			if (seek_pos >= uncompressed_size) {
+				return traits_type::eof();
+			}
+			seek_pending = false;
+			if (!Seek(seek_pos)) {
+				return traits_type::eof();
+			}
+		}
+		if (gptr() < egptr()) {
+			return traits_type::to_int_type(*gptr());
+		}
+		if (out_pos >= uncompressed_size || !Fill()) {
+			return traits_type::eof();
+		}
+		return traits_type::to_int_type(*gptr());
+	}
+
+	std::streambuf::pos_type ZipEntryStreamBuf::seekoff(off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) {
+		if (!(mode & std::ios_base::in)) {
+			return -1;
+		}
+
+		uint32_t window_start = WindowStart();
+		off_type target;
+		if (dir == std::ios_base::beg) {
+			target = offset;
+		} else if (dir == std::ios_base::cur) {
+			target = (seek_pending ? seek_pos : window_start + (gptr() - eback())) + offset;
+		} else {
+			target = uncompressed_size + offset;
+		}
+
+		if (target < 0 || target > uncompressed_size) {
+			return -1;
+		}
+
+		auto pos = static_cast<uint32_t>(target);
+		if (pos >= window_start && pos <= out_pos) {
+			// Inside of the current window
+			seek_pending = false;
+			setg(eback(), eback() + (pos - window_start), egptr());
+		} else {
+			// Determining the size by seeking to the end must not inflate the whole entry
+			seek_pending = true;
+			seek_pos = pos;
+			setg(eback(), egptr(), egptr());
+		}
+		return target;
+	}
+
+	std::streambuf::pos_type ZipEntryStreamBuf::seekpos(pos_type pos, std::ios_base::openmode mode) {
+		return seekoff(pos, std::ios_base::beg, mode);
+	}
+}
+
 static std::string normalize_path(StringView path) {
 	if (path == "." || path == "/" || path.empty()) {
 		return "";
@@ -207,6 +462,10 @@ ZipFilesystem::ZipFilesystem(std::string base_path, FilesystemView parent_fs, St
 	zip_entries_cp437.erase(zip_entries_cp437.begin(), entries_del_it.base());
 }
 
+void ZipFilesystem::SetStreamingThreshold(uint32_t size) {
+	streaming_threshold = size;
+}
+
 bool ZipFilesystem::FindCentralDirectory(std::istream& zipfile, uint32_t& offset, uint32_t& size, uint16_t& num_entries) const {
 	uint32_t magic = 0;
 	bool found = false;
@@ -365,72 +624,136 @@ int64_t ZipFilesystem::GetFilesize(StringView path) const {
 std::streambuf* ZipFilesystem::CreateInputStreambuffer(StringView path, std::ios_base::openmode) const {
 	std::string path_normalized = normalize_path(path);
 	auto central_entry = Find(path);
-	if (central_entry && !central_entry->is_directory) {
-		zip_is.clear();
-		zip_is.seekg(central_entry->fileoffset);
-		StorageMethod method;
-		ZipEntry local_entry = {};
-		if (ReadLocalHeader(zip_is, method, local_entry)) {
-			if (central_entry->compressed_size != local_entry.compressed_size) {
-				if (local_entry.compressed_size == 0) {
-					local_entry.compressed_size = central_entry->compressed_size;
-				} else {
-					Output::Warning("ZipFS: Compressed size mismatch {}: {} != {}", path_normalized, central_entry->compressed_size, local_entry.compressed_size);
-					return nullptr;
-				}
-			}
+	if (!central_entry || central_entry->is_directory) {
+		return nullptr;
+	}
 
-			if (central_entry->uncompressed_size != local_entry.uncompressed_size) {
-				if (local_entry.uncompressed_size == 0) {
-					local_entry.uncompressed_size = central_entry->uncompressed_size;
-				} else {
-					Output::Warning("ZipFS: Uncompressed size mismatch {}: {} != {}", path_normalized, central_entry->uncompressed_size, local_entry.uncompressed_size);
-					return nullptr;
-				}
-			}
+	bool streaming = central_entry->uncompressed_size >= streaming_threshold;
+
+	// Large entries are streamed through an own handle, this also allows reading them in parallel.
+	// Small entries are loaded into memory through the shared handle.
+	// A memory mapped archive is always accessed through an own view of the mapping.
+	Filesystem_Stream::InputStream stream_is;
+	std::unique_lock<std::mutex> lock(zip_is_mutex, std::defer_lock);
+#ifdef USE_MMAP
+	auto* zip_map = dynamic_cast<Filesystem_Stream::InputMappedStreamBuf*>(zip_is.rdbuf());
+	if (zip_map) {
+		stream_is = Filesystem_Stream::InputStream(zip_map->CreateSubView(0, zip_map->GetData().size()), GetPath());
+	} else
+#endif
+	if (streaming) {
+		stream_is = GetParent().OpenInputStream(GetPath());
+		if (!stream_is) {
+			Output::Warning("ZipFS: Cannot open {} for streaming {}", GetPath(), path_normalized);
+			return nullptr;
+		}
+	} else {
+		lock.lock();
+	}
+	std::istream& zipfile = lock.owns_lock() ? static_cast<std::istream&>(zip_is) : static_cast<std::istream&>(stream_is);
 
-			if (local_entry.compressed_size == 0xffffffff || local_entry.uncompressed_size == 0xffffffff) {
-				Output::Warning("ZipFS: Zip64 is not supported {}", path_normalized);
-				return nullptr;
-			}
+	zipfile.clear();
+	zipfile.seekg(central_entry->fileoffset);
+	StorageMethod method;
+	ZipEntry local_entry = {};
+	if (!ReadLocalHeader(zipfile, method, local_entry)) {
+		return nullptr;
+	}
 
-			zip_is.seekg(central_entry->fileoffset + local_entry.fileoffset);
-			if (method == StorageMethod::Plain) {
-				auto data = std::vector<uint8_t>(local_entry.uncompressed_size);
-				zip_is.read(reinterpret_cast<char*>(data.data()), data.size());
-				return new Filesystem_Stream::InputMemoryStreamBuf(std::move(data));
-			} else if (method == StorageMethod::Deflate) {
-				std::vector<uint8_t> comp_buf;
-				comp_buf.resize(local_entry.compressed_size);
-				zip_is.read(reinterpret_cast<char*>(comp_buf.data()), comp_buf.size());
-				auto dec_buf = std::vector<uint8_t>(local_entry.uncompressed_size);
-				z_stream zlib_stream = {};
-				zlib_stream.next_in = reinterpret_cast<Bytef*>(comp_buf.data());
-				zlib_stream.avail_in = static_cast<uInt>(comp_buf.size());
-				zlib_stream.next_out = reinterpret_cast<Bytef*>(dec_buf.data());
-				zlib_stream.avail_out = static_cast<uInt>(dec_buf.size());
-				inflateInit2(&zlib_stream, -MAX_WBITS);
-				auto inflate_sg = lcf::makeScopeGuard([&]() {
-					inflateEnd(&zlib_stream);
-				});
-
-				int zlib_error = inflate(&zlib_stream, Z_NO_FLUSH);
-				if (zlib_error == Z_OK) {
-					Output::Warning("ZipFS: zlib failed for {}: More data available (Archive corrupted?)", path_normalized);
-					return nullptr;
-				}
-				else if (zlib_error != Z_STREAM_END) {
-					Output::Warning("ZipFS: zlib failed for {}: {} ({})", path_normalized, zlib_error, zlib_stream.msg ? zlib_stream.msg : "No error message");
-					return nullptr;
-				}
-				return new Filesystem_Stream::InputMemoryStreamBuf(std::move(dec_buf));
-			} else {
-				Output::Warning("ZipFS: {} has unsupported compression format. Only Deflate is supported", path_normalized);
-				return nullptr;
-			}
+	if (central_entry->compressed_size != local_entry.compressed_size) {
+		if (local_entry.compressed_size == 0) {
+			local_entry.compressed_size = central_entry->compressed_size;
+		} else {
+			Output::Warning("ZipFS: Compressed size mismatch {}: {} != {}", path_normalized, central_entry->compressed_size, local_entry.compressed_size);
+			return nullptr;
 		}
 	}
-	return nullptr;
+
+	if (central_entry->uncompressed_size != local_entry.uncompressed_size) {
+		if (local_entry.uncompressed_size == 0) {
+			local_entry.uncompressed_size = central_entry->uncompressed_size;
+		} else {
+			Output::Warning("ZipFS: Uncompressed size mismatch {}: {} != {}", path_normalized, central_entry->uncompressed_size, local_entry.uncompressed_size);
+			return nullptr;
+		}
+	}
+
+	if (local_entry.compressed_size == 0xffffffff || local_entry.uncompressed_size == 0xffffffff) {
+		Output::Warning("ZipFS: Zip64 is not supported {}", path_normalized);
+		return nullptr;
+	}
+
+	if (method == StorageMethod::Unknown) {
+		Output::Warning("ZipFS: {} has unsupported compression format. Only Deflate is supported", path_normalized);
+		return nullptr;
+	}
+
+	std::streamoff data_offset = central_entry->fileoffset + local_entry.fileoffset;
+	if (streaming) {
+		return new ZipEntryStreamBuf(std::move(stream_is), data_offset, local_entry.compressed_size,
+			local_entry.uncompressed_size, method == StorageMethod::Deflate, path_normalized);
+	}
+
+	// Memory backed archives are accessed directly without copying the compressed data
+	Filesystem_Stream::InputStream& zip_stream = lock.owns_lock() ? zip_is : stream_is;
+	zip_stream.seekg(0);
+	Span<const uint8_t> comp_data = zip_stream.GetData();
+	if (!comp_data.empty()) {
+		if (static_cast<size_t>(data_offset) > comp_data.size() || comp_data.size() - static_cast<size_t>(data_offset) < local_entry.compressed_size) {
+			Output::Warning("ZipFS: {} exceeds the archive size (Archive corrupted?)", path_normalized);
+			return nullptr;
+		}
+		comp_data = comp_data.subspan(data_offset, local_entry.compressed_size);
+	}
+
+	if (method == StorageMethod::Plain) {
+#ifdef USE_MMAP
+		if (zip_map) {
+			return zip_map->CreateSubView(data_offset, local_entry.uncompressed_size);
+		}
+#endif
+		auto data = std::vector<uint8_t>(local_entry.uncompressed_size);
+		if (comp_data.empty()) {
+			zipfile.seekg(data_offset);
+			zipfile.read(reinterpret_cast<char*>(data.data()), data.size());
+		} else {
+			std::copy_n(comp_data.begin(), std::min<size_t>(comp_data.size(), data.size()), data.begin());
+		}
+		return new Filesystem_Stream::InputMemoryStreamBuf(std::move(data));
+	}
+
+	std::vector<uint8_t> comp_buf;
+	if (comp_data.empty()) {
+		comp_buf.resize(local_entry.compressed_size);
+		zipfile.seekg(data_offset);
+		zipfile.read(reinterpret_cast<char*>(comp_buf.data()), comp_buf.size());
+		comp_data = comp_buf;
+	}
+	if (lock.owns_lock()) {
+		lock.unlock();
+	}
+
+	auto dec_buf = std::vector<uint8_t>(local_entry.uncompressed_size);
+	z_stream zlib_stream = {};
+	zlib_stream.next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(comp_data.data()));
+	zlib_stream.avail_in = static_cast<uInt>(comp_data.size());
+	zlib_stream.next_out = reinterpret_cast<Bytef*>(dec_buf.data());
+	zlib_stream.avail_out = static_cast<uInt>(dec_buf.size());
+	inflateInit2(&zlib_stream, -MAX_WBITS);
+	auto inflate_sg = lcf::makeScopeGuard([&]() {
+		inflateEnd(&zlib_stream);
+	});
+
+	int zlib_error = inflate(&zlib_stream, Z_NO_FLUSH);
+	if (zlib_error == Z_OK) {
+		Output::Warning("ZipFS: zlib failed for {}: More data available (Archive corrupted?)", path_normalized);
+		return nullptr;
+	}
+	else if (zlib_error != Z_STREAM_END) {
+		Output::Warning("ZipFS: zlib failed for {}: {} ({})", path_normalized, zlib_error, zlib_stream.msg ? zlib_stream.msg : "No error message");
+		return nullptr;
+	}
+	return new Filesystem_Stream::InputMemoryStreamBuf(std::move(dec_buf));
 }
 
 bool ZipFilesystem::GetDirectoryContent(StringView path, std::vector<DirectoryTree::Entry>& entries) const {
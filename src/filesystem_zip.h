@@ -22,6 +22,7 @@
 #include "filesystem_stream.h"
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -39,6 +40,14 @@ public:
 	 */
 	ZipFilesystem(std::string base_path, FilesystemView parent_fs, StringView encoding = "");
 
+	/**
+	 * Entries of at least this uncompressed size are inflated lazily while
+	 * reading through an own file handle instead of being loaded into memory.
+	 *
+	 * @param size threshold in bytes (default: 1 MiB)
+	 */
+	static void SetStreamingThreshold(uint32_t size);
+
 protected:
 	/**
  	 * Implementation of abstract methods
@@ -71,6 +80,8 @@ private:
 	std::vector<std::pair<std::string, ZipEntry>> zip_entries_cp437;
 	std::string encoding;
 	mutable Filesystem_Stream::InputStream zip_is;
+	/** Protects zip_is, streamed entries use their own handle */
+	mutable std::mutex zip_is_mutex;
 	mutable std::vector<char> filename_buffer;
 };
 
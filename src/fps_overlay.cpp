@@ -24,6 +24,7 @@
 #include "input.h"
 #include "font.h"
 #include "drawable_mgr.h"
+#include "instrumentation.h"
 
 using namespace std::chrono_literals;
 
@@ -41,6 +42,16 @@ void FpsOverlay::UpdateText() {
 	auto fps = Utils::RoundTo<int>(Game_Clock::GetFPS());
 	text = "FPS: " + std::to_string(fps);
 	fps_dirty = true;
+
+	const auto& stats = Instrumentation::GetAudioStats();
+	auto to_ms = [](std::chrono::microseconds us) { return us.count() / 1000.0; };
+	audio_text = fmt::format("Mix {:.1f}/{:.1f} of {:.1f}ms U:{} SE:{}/{}",
+		to_ms(stats.decode_time_avg), to_ms(stats.decode_time_max), to_ms(stats.buffer_time),
+		stats.underruns_total, stats.se_channels_peak, stats.se_channels_capacity);
+	if (stats.se_dropped > 0) {
+		audio_text += fmt::format(" ({} lost)", stats.se_dropped);
+	}
+	audio_dirty = true;
 }
 
 bool FpsOverlay::Update() {
@@ -84,6 +95,28 @@ void FpsOverlay::Draw(Bitmap& dst) {
 		dst.Blit(1, 2, *fps_bitmap, fps_rect, 255);
 	}
 
+	if (draw_audio) {
+		if (audio_dirty) {
+			Rect rect = Text::GetSize(*Font::DefaultBitmapFont(), audio_text);
+
+			if (!audio_bitmap || audio_bitmap->GetWidth() < rect.width + 1) {
+				// Height never changes
+				audio_bitmap = Bitmap::Create(rect.width + 1, rect.height - 1, true);
+			}
+			audio_bitmap->Clear();
+			audio_bitmap->Fill(Color(0, 0, 0, 128));
+			Text::Draw(*audio_bitmap, 1, 0, *Font::DefaultBitmapFont(), Color(255, 255, 255, 255), audio_text);
+
+			audio_rect = Rect(0, 0, rect.width + 1, rect.height - 1);
+
+			audio_dirty = false;
+		}
+
+		// Below the FPS line when it is shown
+		int y = draw_fps ? 2 + fps_rect.height + 1 : 2;
+		dst.Blit(1, y, *audio_bitmap, audio_rect, 255);
+	}
+
 	// Always drawn when speedup is on independent of FPS
 	if (last_speed_mod > 1) {
 		if (speedup_dirty) {
@@ -28,6 +28,7 @@
 /**
  * FpsOverlay class.
  * Shows current FPS and the speedup indicator.
+ * While SHOW_AUDIO_STATS is held the audio mixer telemetry is shown below.
  */
 class FpsOverlay : public Drawable {
 public:
@@ -56,29 +57,45 @@ public:
 	 */
 	void SetDrawFps(bool value);
 
+	/**
+	 * Set whether we will render the audio mixer telemetry.
+	 *
+	 * @param value true if we want to draw to screen
+	 */
+	void SetDrawAudio(bool value);
+
 private:
 	void UpdateText();
 
 	BitmapRef fps_bitmap;
 	BitmapRef speedup_bitmap;
+	BitmapRef audio_bitmap;
 	Game_Clock::time_point last_refresh_time;
 
 	/** Rect to draw on screen */
 	Rect fps_rect;
 	Rect speedup_rect;
+	Rect audio_rect;
 
 	std::string text;
+	std::string audio_text;
 
 	int last_speed_mod = 1;
 	bool speedup_dirty = true;
 	bool fps_dirty = true;
+	bool audio_dirty = true;
 	bool draw_fps = true;
+	bool draw_audio = false;
 };
 
 inline std::string FpsOverlay::GetFpsString() const {
 	return text;
 }
 
+inline void FpsOverlay::SetDrawAudio(bool value) {
+	draw_audio = value;
+}
+
 inline void FpsOverlay::SetDrawFps(bool value) {
 	draw_fps = value;
 }
@@ -166,6 +166,8 @@ lcf::rpg::SaveActor Game_Actor::GetSaveData() const {
 void Game_Actor::Fixup() {
 	RemoveInvalidData();
 	ResetEquipmentStates(false);
+	// The actor data was replaced
+	InvalidateStatCache();
 }
 
 bool Game_Actor::UseItem(int item_id, const Game_Battler* source) {
@@ -347,6 +349,7 @@ int Game_Actor::SetEquipment(int equip_type, int new_item_id) {
 	}
 
 	data.equipped[equip_type - 1] = (short)new_item_id;
+	InvalidateStatCache();
 
 	AdjustEquipmentStates(old_item, false, false);
 	AdjustEquipmentStates(new_item, true, false);
@@ -784,6 +787,7 @@ void Game_Actor::ChangeExp(int exp, PendingMessage* pm) {
 
 void Game_Actor::SetLevel(int _level) {
 	data.level = Utils::Clamp(_level, 1, GetMaxLevel());
+	InvalidateStatCache();
 	// Ensure current HP/SP remain clamped if new Max HP/SP is less.
 	SetHp(GetHp());
 	SetSp(GetSp());
@@ -1060,6 +1064,7 @@ void Game_Actor::ChangeClass(int new_class_id,
 	data.agility_mod = 0;
 
 	data.class_id = new_class_id;
+	InvalidateStatCache();
 	data.changed_battle_commands = true; // Any change counts as a battle commands change.
 
 	// The class settings are not applied when the actor has a class on startup
@@ -1193,21 +1198,25 @@ int Game_Actor::SetSp(int sp) {
 void Game_Actor::SetBaseAtk(int atk) {
 	int new_attack_mod = data.attack_mod + (atk - GetBaseAtk());
 	data.attack_mod = ClampStatMod(new_attack_mod, this);
+	InvalidateStatCache();
 }
 
 void Game_Actor::SetBaseDef(int def) {
 	int new_defense_mod = data.defense_mod + (def - GetBaseDef());
 	data.defense_mod = ClampStatMod(new_defense_mod, this);
+	InvalidateStatCache();
 }
 
 void Game_Actor::SetBaseSpi(int spi) {
 	int new_spirit_mod = data.spirit_mod + (spi - GetBaseSpi());
 	data.spirit_mod = ClampStatMod(new_spirit_mod, this);
+	InvalidateStatCache();
 }
 
 void Game_Actor::SetBaseAgi(int agi) {
 	int new_agility_mod = data.agility_mod + (agi - GetBaseAgi());
 	data.agility_mod = ClampStatMod(new_agility_mod, this);
+	InvalidateStatCache();
 }
 
 Game_Actor::RowType Game_Actor::GetBattleRow() const {
@@ -327,6 +327,8 @@ int Game_Battler::CalculateSkillHpCost(int skill_id) const {
 
 bool Game_Battler::AddState(int state_id, bool allow_battle_states) {
 	auto was_added = State::Add(state_id, GetStates(), GetPermanentStates(), allow_battle_states);
+	// Adding a state can remove other states even when it fails
+	InvalidateStatCache();
 
 	if (!was_added) {
 		return was_added;
@@ -389,6 +391,8 @@ bool RemoveStates(Game_Battler& battler, F&& f) {
 	bool is_dead = check_dead();
 	bool was_removed = f();
 	if (was_removed) {
+		battler.InvalidateStatCache();
+
 		if (is_dead != check_dead()) {
 			// Was revived
 			battler.SetHp(1);
@@ -559,20 +563,43 @@ int Game_Battler::CalcValueAfterAgiStates(int value) const {
 	return AdjustParam(value, 0, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_agility);
 }
 
+template <typename F>
+int Game_Battler::GetCachedStat(StatCacheIndex index, Weapon weapon, F&& calc) const {
+	const int slot = weapon - WeaponAll;
+	if (slot < 0 || slot >= stat_cache_weapons) {
+		return calc();
+	}
+
+	const auto bit = static_cast<uint16_t>(1 << (index * stat_cache_weapons + slot));
+	if (!(stat_cache_valid & bit)) {
+		stat_cache[index][slot] = calc();
+		stat_cache_valid |= bit;
+	}
+	return stat_cache[index][slot];
+}
+
 int Game_Battler::GetAtk(Weapon weapon) const {
-	return AdjustParam(GetBaseAtk(weapon), atk_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_attack);
+	return GetCachedStat(StatCache_Atk, weapon, [&]() {
+		return AdjustParam(GetBaseAtk(weapon), atk_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_attack);
+	});
 }
 
 int Game_Battler::GetDef(Weapon weapon) const {
-	return AdjustParam(GetBaseDef(weapon), def_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_defense);
+	return GetCachedStat(StatCache_Def, weapon, [&]() {
+		return AdjustParam(GetBaseDef(weapon), def_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_defense);
+	});
 }
 
 int Game_Battler::GetSpi(Weapon weapon) const {
-	return AdjustParam(GetBaseSpi(weapon), spi_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_spirit);
+	return GetCachedStat(StatCache_Spi, weapon, [&]() {
+		return AdjustParam(GetBaseSpi(weapon), spi_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_spirit);
+	});
 }
 
 int Game_Battler::GetAgi(Weapon weapon) const {
-	return AdjustParam(GetBaseAgi(weapon), agi_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_agility);
+	return GetCachedStat(StatCache_Agi, weapon, [&]() {
+		return AdjustParam(GetBaseAgi(weapon), agi_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_agility);
+	});
 }
 
 int Game_Battler::GetDisplayX() const {
@@ -657,6 +684,7 @@ void Game_Battler::ResetBattle() {
 	def_modifier = 0;
 	spi_modifier = 0;
 	agi_modifier = 0;
+	InvalidateStatCache();
 	frame_counter = Rand::GetRandomNumber(0, 63);
 	battle_combo_command_id = -1;
 	battle_combo_times = 1;
@@ -382,6 +382,14 @@ public:
 	 */
 	int GetAgi(Weapon weapon = Game_Battler::WeaponAll) const;
 
+	/**
+	 * Discards the cached results of GetAtk, GetDef, GetSpi and GetAgi.
+	 * Changes of states, modifiers, equipment, level and class invalidate
+	 * the cache automatically. Must be called after modifying the database
+	 * entries the battler reads its parameters from.
+	 */
+	void InvalidateStatCache();
+
 	/**
 	 * Gets the maximum HP for the current level.
 	 *
@@ -949,6 +957,25 @@ protected:
 	int def_modifier = 0;
 	int spi_modifier = 0;
 	int agi_modifier = 0;
+
+	enum StatCacheIndex {
+		StatCache_Atk,
+		StatCache_Def,
+		StatCache_Spi,
+		StatCache_Agi,
+		StatCache_Count
+	};
+	/** Number of Weapon values from WeaponAll to WeaponSecondary */
+	static constexpr int stat_cache_weapons = 4;
+
+	/** Results of GetAtk, GetDef, GetSpi and GetAgi, indexed by [index][weapon - WeaponAll] */
+	mutable int stat_cache[StatCache_Count][stat_cache_weapons] = {};
+	/** Bit (index * stat_cache_weapons + weapon - WeaponAll) is set when the entry is valid */
+	mutable uint16_t stat_cache_valid = 0;
+
+	template <typename F>
+	int GetCachedStat(StatCacheIndex index, Weapon weapon, F&& calc) const;
+
 	int battle_turn = 0;
 	int frame_counter = 0;
 	int last_battle_action = -1;
@@ -1001,20 +1028,28 @@ inline bool Game_Battler::Exists() const {
 	return !IsHidden() && !IsDead() && IsInParty();
 }
 
+inline void Game_Battler::InvalidateStatCache() {
+	stat_cache_valid = 0;
+}
+
 inline void Game_Battler::SetAtkModifier(int modifier) {
 	atk_modifier = modifier;
+	InvalidateStatCache();
 }
 
 inline void Game_Battler::SetDefModifier(int modifier) {
 	def_modifier = modifier;
+	InvalidateStatCache();
 }
 
 inline void Game_Battler::SetSpiModifier(int modifier) {
 	spi_modifier = modifier;
+	InvalidateStatCache();
 }
 
 inline void Game_Battler::SetAgiModifier(int modifier) {
 	agi_modifier = modifier;
+	InvalidateStatCache();
 }
 
 inline bool Game_Battler::IsCharged() const {
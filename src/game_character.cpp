@@ -19,6 +19,7 @@
 #include "audio.h"
 #include "game_character.h"
 #include "game_map.h"
+#include "game_pathfinder.h"
 #include "game_player.h"
 #include "game_switches.h"
 #include "game_system.h"
@@ -41,6 +42,7 @@ Game_Character::Game_Character(Type type, lcf::rpg::SaveMapEventBase* d) :
 }
 
 void Game_Character::SanitizeData(StringView name) {
+	Game_Pathfinder::DecodeMoveRoute(data()->move_route);
 	SanitizeMoveRoute(name, data()->move_route, data()->move_route_index, "move_route_index");
 }
 
@@ -264,7 +266,40 @@ void Game_Character::UpdateMoveRoute(int32_t& current_index, const lcf::rpg::Mov
 		const auto saved_index = current_index;
 		const auto cmd = static_cast<Code>(move_command.command_id);
 
-		if (cmd >= Code::move_up && cmd <= Code::move_forward) {
+		if (move_command.command_id == Game_Pathfinder::move_command_walk_to && Player::HasEasyRpgExtensions()) {
+			// Parameter A, B: Target x, y
+			int dir = -1;
+			const auto result = Game_Pathfinder::NextStep(*this, move_command.parameter_a, move_command.parameter_b, dir);
+			if (result == Game_Pathfinder::Result::Deferred) {
+				// Search again in the next frame
+				return;
+			}
+			if (result == Game_Pathfinder::Result::Step) {
+				if (!Move(dir)) {
+					// A character moved into the path
+					Game_Pathfinder::ForgetPath(*this);
+					SetMoveFailureCount(GetMoveFailureCount() + 1);
+					return;
+				}
+				// This command continues after the step
+				SetMaxStopCountForStep();
+				SetMoveFailureCount(0);
+				return;
+			}
+			if (result == Game_Pathfinder::Result::NoPath) {
+				if (!current_route.skippable) {
+					// Search again after the time of a step
+					SetMaxStopCountForStep();
+					SetStopCount(0);
+					SetMoveFailureCount(GetMoveFailureCount() + 1);
+					return;
+				}
+			} else if (dir >= 0) {
+				// Arrived next to an occupied target
+				SetDirection(dir);
+				SetFacing(GetDirection());
+			}
+		} else if (cmd >= Code::move_up && cmd <= Code::move_forward) {
 			switch (cmd) {
 				case Code::move_up:
 				case Code::move_right:
@@ -415,6 +415,16 @@ void Game_Config::LoadFromArgs(CmdlineParser& cp) {
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 1, "--map-cache-size")) {
+			if (arg.ParseValue(0, li_value)) {
+				player.map_cache_size.Set(li_value);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, {"--directory-index", "--no-directory-index"})) {
+			player.directory_index.Set(arg.ArgIsOn());
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--soundfont-path")) {
 			if (arg.NumValues() > 0) {
 				soundfont_path = FileFinder::MakeCanonical(arg.Value(0), 0);
@@ -525,6 +535,8 @@ void Game_Config::LoadFromStream(Filesystem_Stream::InputStream& is) {
 	player.font1_size.FromIni(ini);
 	player.font2.FromIni(ini);
 	player.font2_size.FromIni(ini);
+	player.map_cache_size.FromIni(ini);
+	player.directory_index.FromIni(ini);
 }
 
 void Game_Config::WriteToStream(Filesystem_Stream::OutputStream& os) const {
@@ -610,6 +622,8 @@ void Game_Config::WriteToStream(Filesystem_Stream::OutputStream& os) const {
 	player.font1_size.ToIni(os);
 	player.font2.ToIni(os);
 	player.font2_size.ToIni(os);
+	player.map_cache_size.ToIni(os);
+	player.directory_index.ToIni(os);
 
 	os << "\n";
 }
@@ -89,6 +89,8 @@ struct Game_ConfigPlayer {
 	RangeConfigParam<int> font1_size { "Font 1 Size", "", "Player", "Font1Size", 12, 6, 16};
 	PathConfigParam font2 { "Font 2", "The game chooses whether it wants font 1 or 2", "Player", "Font2", "" };
 	RangeConfigParam<int> font2_size { "Font 2 Size", "", "Player", "Font2Size", 12, 6, 16};
+	RangeConfigParam<int> map_cache_size { "Map Cache Size", "Number of parsed maps kept in memory", "Player", "MapCacheSize", 8, 0, 64 };
+	BoolConfigParam directory_index { "Directory Index", "Remember folder contents between launches", "Player", "DirectoryIndex", false };
 
 	void Hide();
 };
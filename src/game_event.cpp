@@ -21,6 +21,7 @@
 #include "game_actors.h"
 #include "game_map.h"
 #include "game_message.h"
+#include "game_pathfinder.h"
 #include "game_party.h"
 #include "game_player.h"
 #include "game_switches.h"
@@ -96,6 +97,7 @@ void Game_Event::SetSaveData(lcf::rpg::SaveMapEvent save)
 
 lcf::rpg::SaveMapEvent Game_Event::GetSaveData() const {
 	auto save = *data();
+	Game_Pathfinder::EncodeMoveRoute(save.move_route);
 
 	lcf::rpg::SaveEventExecState state;
 	if (page && page->trigger == lcf::rpg::EventPage::Trigger_parallel) {
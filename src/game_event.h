@@ -219,6 +219,7 @@ private:
 	std::unique_ptr<Game_Interpreter_Map> interpreter;
 
 	friend class Scene_Debug;
+	friend class Game_EventBatch;
 };
 
 inline int Game_Event::GetNumPages() const {
@@ -0,0 +1,182 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "game_event_batch.h"
+#include "game_event.h"
+#include "game_interpreter_map.h"
+#include "game_map.h"
+#include "game_system.h"
+#include "main_data.h"
+#include "utils.h"
+
+namespace {
+	using EventPage = lcf::rpg::EventPage;
+
+	// Same as Game_Character::Get*AnimFrames, indexed by speed - 1
+	constexpr int32_t stationary_limits[] = { 12, 10, 8, 6, 5, 4 };
+	constexpr int32_t continuous_limits[] = { 16, 12, 10, 8, 7, 6 };
+	constexpr int32_t spin_limits[] = { 24, 16, 12, 8, 6, 4 };
+}
+
+bool Game_EventBatch::Add(Game_Event& ev) {
+	// See Game_Event::Update and Game_Character::Update
+	auto* d = ev.data();
+	const auto* page = ev.GetActivePage();
+	if (!d->active || page == nullptr) {
+		return true;
+	}
+
+	const auto trigger = page->trigger;
+	if (trigger == EventPage::Trigger_parallel && ev.interpreter) {
+		return false;
+	}
+
+	if (d->processed) {
+		return true;
+	}
+
+	// Moving, jumping or following a move route
+	if (d->remaining_step > 0 || d->jumping || d->move_route_overwrite) {
+		return false;
+	}
+
+	// Starts the event
+	if (trigger == EventPage::Trigger_auto_start || trigger == EventPage::Trigger_collision) {
+		return false;
+	}
+
+	if (d->flash_current_level > 0) {
+		return false;
+	}
+
+	// See Game_Event::UpdateNextMovementAction
+	const bool continue_events = Main_Data::game_system->GetMessageContinueEvents();
+	const bool interpreter_running = Game_Map::GetInterpreter().IsRunning();
+	if (page->move_type != EventPage::MoveType_stationary
+			&& !d->pause
+			&& d->stop_count >= d->max_stop_count
+			&& (continue_events || !interpreter_running)) {
+		return false;
+	}
+
+	d->processed = true;
+
+	Anim a;
+	const auto anim_type = d->animation_type;
+	if (anim_type == EventPage::AnimType_spin) {
+		a = Anim_Spin;
+	} else if (d->anim_paused) {
+		a = anim_type == EventPage::AnimType_fixed_graphic ? Anim_Reset : Anim_ResetFrame;
+	} else if (anim_type == EventPage::AnimType_fixed_graphic || anim_type == EventPage::AnimType_step_frame_fix) {
+		a = Anim_None;
+	} else if (anim_type == EventPage::AnimType_continuous || anim_type == EventPage::AnimType_fixed_continuous) {
+		a = Anim_Continuous;
+	} else {
+		a = Anim_Stepping;
+	}
+
+	data.push_back(d);
+	stop_count.push_back(d->stop_count);
+	anim_count.push_back(d->anim_count);
+	anim_frame.push_back(d->anim_frame);
+	facing.push_back(d->facing);
+	speed.push_back(static_cast<uint8_t>(Utils::Clamp<int>(d->move_speed, 1, 6) - 1));
+	anim.push_back(a);
+	count_stop.push_back((continue_events || !interpreter_running) && !d->pause);
+	return true;
+}
+
+void Game_EventBatch::Update() {
+	const size_t n = data.size();
+	if (n == 0) {
+		return;
+	}
+
+	int32_t* sc = stop_count.data();
+	int32_t* ac = anim_count.data();
+	int32_t* frame = anim_frame.data();
+	int32_t* dir = facing.data();
+	const uint8_t* spd = speed.data();
+	const uint8_t* an = anim.data();
+	const uint8_t* cs = count_stop.data();
+
+	for (size_t i = 0; i < n; ++i) {
+		sc[i] += (sc[i] == 0 || cs[i]) ? 1 : 0;
+	}
+
+	// See Game_Character::UpdateAnimation
+	for (size_t i = 0; i < n; ++i) {
+		switch (an[i]) {
+			case Anim_None:
+				break;
+			case Anim_Reset:
+				ac[i] = 0;
+				break;
+			case Anim_ResetFrame:
+				ac[i] = 0;
+				frame[i] = EventPage::Frame_middle;
+				break;
+			case Anim_Spin:
+				if (++ac[i] >= spin_limits[spd[i]]) {
+					dir[i] = (dir[i] + 1) % 4;
+					ac[i] = 0;
+				}
+				break;
+			case Anim_Stepping:
+			case Anim_Continuous: {
+				const int32_t stationary_limit = stationary_limits[spd[i]];
+				if (an[i] == Anim_Continuous
+						|| sc[i] == 0
+						|| frame[i] == EventPage::Frame_left || frame[i] == EventPage::Frame_right
+						|| ac[i] < stationary_limit - 1) {
+					++ac[i];
+				}
+				if (ac[i] >= continuous_limits[spd[i]] || (sc[i] == 0 && ac[i] >= stationary_limit)) {
+					frame[i] = (frame[i] + 1) % 4;
+					ac[i] = 0;
+				}
+				break;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < n; ++i) {
+		auto* d = data[i];
+		if (d->stop_count != sc[i]) {
+			d->stop_count = sc[i];
+		}
+		if (d->anim_count != ac[i]) {
+			d->anim_count = ac[i];
+		}
+		if (d->anim_frame != frame[i]) {
+			d->anim_frame = frame[i];
+		}
+		if (d->facing != dir[i]) {
+			d->facing = dir[i];
+		}
+	}
+
+	data.clear();
+	stop_count.clear();
+	anim_count.clear();
+	anim_frame.clear();
+	facing.clear();
+	speed.clear();
+	anim.clear();
+	count_stop.clear();
+}
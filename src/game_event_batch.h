@@ -0,0 +1,91 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_GAME_EVENT_BATCH_H
+#define EP_GAME_EVENT_BATCH_H
+
+// Headers
+#include <cstdint>
+#include <vector>
+
+class Game_Event;
+namespace lcf {
+namespace rpg {
+class SaveMapEvent;
+} // namespace rpg
+} // namespace lcf
+
+/**
+ * Batched update of map events that only advance their stop and animation
+ * counters this frame, e.g. decorative NPCs that stand still or wait
+ * between random steps.
+ *
+ * The counters of the queued events are copied into contiguous arrays,
+ * updated in tight loops and only written back when they changed.
+ *
+ * Events must be queued in update order and Update must be called before
+ * any other character is updated. The result is then identical to calling
+ * Game_Event::Update for every event.
+ */
+class Game_EventBatch {
+public:
+	/**
+	 * Queues the update of an event when the update only advances its
+	 * counters.
+	 *
+	 * @param ev event to update
+	 * @return true when the event was queued or has nothing to update,
+	 *         false when it must be updated with Game_Event::Update
+	 */
+	bool Add(Game_Event& ev);
+
+	/** Updates all queued events */
+	void Update();
+
+	/** @return number of queued events */
+	int GetSize() const;
+
+private:
+	enum Anim : uint8_t {
+		/** Animation is disabled */
+		Anim_None,
+		/** Animation is paused */
+		Anim_Reset,
+		/** Animation is paused and the pattern is reset */
+		Anim_ResetFrame,
+		Anim_Spin,
+		Anim_Stepping,
+		Anim_Continuous
+	};
+
+	std::vector<lcf::rpg::SaveMapEvent*> data;
+	std::vector<int32_t> stop_count;
+	std::vector<int32_t> anim_count;
+	std::vector<int32_t> anim_frame;
+	std::vector<int32_t> facing;
+	/** Index into the speed dependent frame limits */
+	std::vector<uint8_t> speed;
+	std::vector<uint8_t> anim;
+	/** Whether the stop count advances while it is not 0 */
+	std::vector<uint8_t> count_stop;
+};
+
+inline int Game_EventBatch::GetSize() const {
+	return static_cast<int>(data.size());
+}
+
+#endif
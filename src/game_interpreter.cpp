@@ -46,6 +46,7 @@
 #include "game_screen.h"
 #include "game_interpreter_control_variables.h"
 #include "game_windows.h"
+#include "interpreter_trace.h"
 #include "json_helper.h"
 #include "maniac_patch.h"
 #include "spriteset_map.h"
@@ -79,7 +80,10 @@ enum BranchSubcommand {
 };
 
 Game_Interpreter::Game_Interpreter(bool _main_flag) {
+	static int next_trace_id = 0;
+
 	main_flag = _main_flag;
+	trace_id = next_trace_id++;
 
 	Clear();
 }
@@ -92,6 +96,7 @@ void Game_Interpreter::Clear() {
 	_state = {};
 	_keyinput = {};
 	_async_op = {};
+	_wait_save = false;
 }
 
 // Is interpreter running.
@@ -442,6 +447,13 @@ void Game_Interpreter::Update(bool reset_loop_count) {
 			_state.wait_movement = false;
 		}
 
+		if (_wait_save) {
+			if (Scene_Save::IsSavePending()) {
+				break;
+			}
+			_wait_save = false;
+		}
+
 		if (_keyinput.wait) {
 			if (Game_Message::IsMessageActive()) {
 				break;
@@ -576,6 +588,12 @@ void Game_Interpreter::SkipToNextConditional(std::initializer_list<Cmd> codes, i
 bool Game_Interpreter::ExecuteCommand() {
 	auto& frame = GetFrame();
 	const auto& com = frame.commands[frame.current_command];
+	if (InterpreterTrace::IsActive()) {
+		InterpreterTrace::CommandBegin(trace_id, frame.event_id, frame.current_command, com.code);
+		bool result = ExecuteCommand(com);
+		InterpreterTrace::CommandEnd();
+		return result;
+	}
 	return ExecuteCommand(com);
 }
 
@@ -1053,7 +1071,7 @@ bool Game_Interpreter::CommandControlSwitches(lcf::rpg::EventCommand const& com)
 			} else {
 				Main_Data::game_switches->FlipRange(start, end);
 			}
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForSwitchRangeChange(start, end);
 		}
 	}
 	return true;
@@ -4271,6 +4289,7 @@ bool Game_Interpreter::CommandManiacGetSaveInfo(lcf::rpg::EventCommand const& co
 		return true;
 	}
 
+	Scene_Save::WaitForPendingSaves();
 	auto savefs = FileFinder::Save();
 	std::string save_name = Scene_Save::GetSaveFilename(savefs, save_number);
 	auto save_stream = FileFinder::Save().OpenInputStream(save_name);
@@ -4280,7 +4299,8 @@ bool Game_Interpreter::CommandManiacGetSaveInfo(lcf::rpg::EventCommand const& co
 		return true;
 	}
 
-	auto save = lcf::LSD_Reader::Load(save_stream, Player::encoding);
+	// Only the title is needed, this avoids parsing the whole savegame
+	auto save = Scene_File::LoadSaveTitle(save_stream);
 	if (!save) {
 		Output::Debug("ManiacGetSaveInfo: Save corrupted {}", save_number);
 		// Maniac Patch writes this for whatever reason
@@ -4349,6 +4369,8 @@ bool Game_Interpreter::CommandManiacSave(lcf::rpg::EventCommand const& com) {
 	// Maniac Patch saves directly and game data could be in an undefined state
 	// We yield first to the Update loop and then do a save.
 	_async_op = AsyncOp::MakeSave(slot, out_var);
+	// Saving finishes in the background, continue when the result is known
+	_wait_save = out_var > 0;
 
 	return true;
 }
@@ -4367,6 +4389,7 @@ bool Game_Interpreter::CommandManiacLoad(lcf::rpg::EventCommand const& com) {
 	// Not implemented (kinda useless feature):
 	// When com.parameters[2] is 1 the check whether the file exists is skipped
 	// When skipped and missing RPG_RT will crash
+	Scene_Save::WaitForPendingSaves();
 	auto savefs = FileFinder::Save();
 	std::string save_name = Scene_Save::GetSaveFilename(savefs, slot);
 	auto save_stream = FileFinder::Save().OpenInputStream(save_name);
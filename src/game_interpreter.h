@@ -133,6 +133,9 @@ protected:
 
 	bool main_flag;
 
+	/** Identifies the interpreter in the interpreter trace */
+	int trace_id = 0;
+
 	int loop_count = 0;
 
 	/**
@@ -347,6 +350,8 @@ protected:
 	lcf::rpg::SaveEventExecState _state;
 	KeyInputState _keyinput;
 	AsyncOp _async_op = {};
+	/** Waits for a Maniac save until its result variable is set */
+	bool _wait_save = false;
 
 	friend class Scene_Debug;
 };
@@ -26,6 +26,7 @@
 #include "feature.h"
 #include "game_map.h"
 #include "game_battle.h"
+#include "game_pathfinder.h"
 #include "game_event.h"
 #include "game_player.h"
 #include "game_switches.h"
@@ -241,6 +242,8 @@ bool Game_Interpreter_Map::ExecuteCommand(lcf::rpg::EventCommand const& com) {
 			return CommandEasyRpgTriggerEventAt(com);
 		case Cmd::EasyRpg_WaitForSingleMovement:
 			return CommandEasyRpgWaitForSingleMovement(com);
+		case static_cast<Cmd>(Game_Pathfinder::event_command_walk_to):
+			return CommandEasyRpgWalkTo(com);
 		default:
 			return Game_Interpreter::ExecuteCommand(com);
 	}
@@ -942,3 +945,66 @@ bool Game_Interpreter_Map::CommandEasyRpgWaitForSingleMovement(lcf::rpg::EventCo
 
 	return true;
 }
+
+bool Game_Interpreter_Map::CommandEasyRpgWalkTo(lcf::rpg::EventCommand const& com) {
+	if (!Player::HasEasyRpgExtensions()) {
+		return true;
+	}
+
+	_state.easyrpg_parameters.resize(1);
+
+	auto& event_id = _state.easyrpg_parameters[0];
+
+	auto get_character = [&]() {
+		Game_Character* chara = GetCharacter(event_id, "EasyRpgWalkTo");
+		// If the event is a vehicle in use, the player walks instead
+		if (chara && event_id >= Game_Character::CharBoat && event_id <= Game_Character::CharAirship
+				&& static_cast<Game_Vehicle*>(chara)->IsInUse()) {
+			chara = Main_Data::game_player.get();
+		}
+		return chara;
+	};
+
+	if (!_state.easyrpg_active) {
+		event_id = ValueOrVariable(com.parameters[0], com.parameters[1]);
+		int x = ValueOrVariable(com.parameters[2], com.parameters[3]);
+		int y = ValueOrVariable(com.parameters[4], com.parameters[5]);
+		int move_freq = com.parameters.size() > 6 ? com.parameters[6] : 0;
+		int flags = com.parameters.size() > 7 ? com.parameters[7] : 0;
+
+		Game_Character* chara = get_character();
+		if (chara == nullptr) {
+			return true;
+		}
+
+		if (move_freq <= 0 || move_freq > 8) {
+			move_freq = chara->GetMoveFrequency();
+		}
+
+		lcf::rpg::MoveCommand cmd;
+		cmd.command_id = Game_Pathfinder::move_command_walk_to;
+		cmd.parameter_a = x;
+		cmd.parameter_b = y;
+
+		lcf::rpg::MoveRoute route;
+		route.skippable = (flags & 1) != 0;
+		route.move_commands.push_back(cmd);
+
+		chara->ForceMoveRoute(route, move_freq);
+
+		// Wait until arrived
+		if ((flags & 2) == 0) {
+			return true;
+		}
+	}
+
+	_state.easyrpg_active = false;
+
+	Game_Character* chara = get_character();
+	if (chara != nullptr && chara->IsMoveRouteOverwritten() && !chara->IsMoveRouteFinished()) {
+		_state.easyrpg_active = true;
+		return false;
+	}
+
+	return true;
+}
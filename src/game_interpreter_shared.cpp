@@ -21,6 +21,7 @@
 #include "game_ineluki.h"
 #include "game_map.h"
 #include "game_party.h"
+#include "game_pathfinder.h"
 #include "game_player.h"
 #include "game_switches.h"
 #include "game_system.h"
@@ -233,6 +234,10 @@ lcf::rpg::MoveCommand Game_Interpreter_Shared::DecodeMove(lcf::DBArray<int32_t>:
 			cmd.parameter_b = DecodeInt(it);
 			cmd.parameter_c = DecodeInt(it);
 			break;
+		case Game_Pathfinder::move_command_walk_to:	// EasyRPG Walk To
+			cmd.parameter_a = DecodeInt(it);
+			cmd.parameter_b = DecodeInt(it);
+			break;
 	}
 
 	return cmd;
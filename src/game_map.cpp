@@ -24,14 +24,20 @@
 #include <climits>
 #include <numeric>
 #include <unordered_set>
+#include <list>
+#ifdef USE_THREADS
+#  include <future>
+#endif
 
 #include "async_handler.h"
 #include "options.h"
 #include "system.h"
 #include "game_battle.h"
 #include "game_battler.h"
+#include "game_event_batch.h"
 #include "game_map.h"
 #include "game_interpreter_map.h"
+#include "game_pathfinder.h"
 #include "game_switches.h"
 #include "game_player.h"
 #include "game_party.h"
@@ -56,6 +62,7 @@
 #include <lcf/rpg/save.h>
 #include "scene_gameover.h"
 #include "feature.h"
+#include "game_clock.h"
 
 namespace {
 	// Intended bad value, Game_Map::Init sets them correctly
@@ -72,6 +79,8 @@ namespace {
 	std::vector<unsigned char> passages_down;
 	std::vector<unsigned char> passages_up;
 	std::vector<Game_Event> events;
+	// Events that only advance their counters are updated together
+	Game_EventBatch event_batch;
 	std::vector<Game_CommonEvent> common_events;
 	std::unique_ptr<Game_Map::Caching::MapCache> map_cache;
 
@@ -91,6 +100,31 @@ namespace {
 
 	// Used when the current map is not in the maptree
 	const lcf::rpg::MapInfo empty_map_info;
+
+	struct MapFile {
+		int map_id = 0;
+		std::string map_name;
+		std::shared_ptr<const lcf::rpg::Map> map;
+		bool has_crc = false;
+		uint32_t crc = 0;
+	};
+
+	// Parsed map files, most recently used first
+	std::list<MapFile> map_file_cache;
+#ifdef USE_THREADS
+	struct MapFilePreload {
+		int map_id;
+		std::string map_name;
+		Filesystem_Stream::InputStream map_stream;
+		bool is_xml;
+		std::promise<MapFile> result;
+	};
+
+	// Map files that are parsed in the background
+	std::unordered_map<int, std::future<MapFile>> map_file_preloads;
+	// Background task parsing the preloads one after another
+	std::future<void> map_file_preload_task;
+#endif
 }
 
 namespace Game_Map {
@@ -142,6 +176,7 @@ void Game_Map::Quit() {
 	common_events.clear();
 	interpreter.reset();
 	map_cache.reset();
+	ClearMapFileCache();
 }
 
 int Game_Map::GetMapSaveCount() {
@@ -210,6 +245,8 @@ void Game_Map::Setup(std::unique_ptr<lcf::rpg::Map> map_in) {
 	// Update the save counts so that if the player saves the game
 	// events will properly resume upon loading.
 	Main_Data::game_player->UpdateSaveCounts(lcf::Data::system.save_count, GetMapSaveCount());
+
+	PreloadMapFiles();
 }
 
 void Game_Map::SetupFromSave(
@@ -283,56 +320,218 @@ void Game_Map::SetupFromSave(
 	// FIXME: RPG_RT compatibility bug: On async platforms, panorama async loading can
 	// cause panorama chunks to be out of sync.
 	Game_Map::Parallax::ChangeBG(GetParallaxParams());
-}
 
-std::unique_ptr<lcf::rpg::Map> Game_Map::LoadMapFile(int map_id) {
-	std::unique_ptr<lcf::rpg::Map> map;
+	PreloadMapFiles();
+}
 
+/** @return path of the map file or empty when the map was not found */
+static std::string OpenMapFile(int map_id, std::string& map_name, bool& is_xml, Filesystem_Stream::InputStream& map_stream) {
 	// Try loading EasyRPG map files first, then fallback to normal RPG Maker
-	// FIXME: Assert map was cached for async platforms
-	std::string map_name = Game_Map::ConstructMapName(map_id, true);
+	is_xml = true;
+	map_name = Game_Map::ConstructMapName(map_id, true);
 	std::string map_file = FileFinder::Game().FindFile(map_name);
 	if (map_file.empty()) {
+		is_xml = false;
 		map_name = Game_Map::ConstructMapName(map_id, false);
 		map_file = FileFinder::Game().FindFile(map_name);
+	}
 
-		if (map_file.empty()) {
-			Output::Error("Loading of Map {} failed.\nThe map was not found.", map_name);
-			return nullptr;
-		}
+	if (!map_file.empty()) {
+		map_stream = FileFinder::Game().OpenInputStream(map_file);
+	}
+	return map_file;
+}
 
-		auto map_stream = FileFinder::Game().OpenInputStream(map_file);
-		if (!map_stream) {
-			Output::Error("Loading of Map {} failed.\nMap not readable.", map_name);
-			return nullptr;
-		}
+/** Parses a map file. Runs on a background thread when preloading. */
+static MapFile ParseMapFile(int map_id, std::string map_name, Filesystem_Stream::InputStream map_stream, bool is_xml, StringView encoding, bool with_crc) {
+	MapFile file;
+	file.map_id = map_id;
+	file.map_name = std::move(map_name);
 
-		map = lcf::LMU_Reader::Load(map_stream, Player::encoding);
+	if (is_xml) {
+		file.map = lcf::LMU_Reader::LoadXml(map_stream);
+	} else {
+		file.map = lcf::LMU_Reader::Load(map_stream, encoding);
 
-		if (Input::IsRecording()) {
+		if (with_crc) {
 			map_stream.clear();
 			map_stream.seekg(0);
-			Input::AddRecordingData(Input::RecordingData::Hash,
-						   fmt::format("map{:04} {:#08x}", map_id, Utils::CRC32(map_stream)));
+			file.crc = Utils::CRC32(map_stream);
+			file.has_crc = true;
 		}
-	} else {
-		auto map_stream = FileFinder::Game().OpenInputStream(map_file);
+	}
+
+	return file;
+}
+
+static void AddMapFileToCache(MapFile file, bool most_recent) {
+	int capacity = Player::player_config.map_cache_size.Get();
+	if (!file.map || capacity <= 0) {
+		return;
+	}
+
+	map_file_cache.remove_if([&](const MapFile& f) { return f.map_id == file.map_id; });
+
+	if (most_recent) {
+		map_file_cache.push_front(std::move(file));
+	} else if (static_cast<int>(map_file_cache.size()) < capacity) {
+		map_file_cache.push_back(std::move(file));
+	}
+
+	while (static_cast<int>(map_file_cache.size()) > capacity) {
+		map_file_cache.pop_back();
+	}
+}
+
+#ifdef USE_THREADS
+static void WaitForMapFilePreloads() {
+	if (map_file_preload_task.valid()) {
+		map_file_preload_task.get();
+	}
+}
+#endif
+
+std::unique_ptr<lcf::rpg::Map> Game_Map::LoadMapFile(int map_id) {
+	// FIXME: Assert map was cached for async platforms
+	auto start_time = Game_Clock::now();
+	const char* source = "cached";
+	MapFile file;
+
+	auto it = std::find_if(map_file_cache.begin(), map_file_cache.end(), [&](const MapFile& f) { return f.map_id == map_id; });
+	if (it != map_file_cache.end()) {
+		map_file_cache.splice(map_file_cache.begin(), map_file_cache, it);
+		file = map_file_cache.front();
+	}
+
+#ifdef USE_THREADS
+	if (!file.map) {
+		auto preload_it = map_file_preloads.find(map_id);
+		if (preload_it != map_file_preloads.end()) {
+			source = "preloaded";
+			file = preload_it->second.get();
+			map_file_preloads.erase(preload_it);
+			AddMapFileToCache(file, true);
+		}
+	}
+#endif
+
+	if (!file.map) {
+		source = "parsed";
+
+#ifdef USE_THREADS
+		// Parsing is not done concurrently with the preloader
+		WaitForMapFilePreloads();
+#endif
+
+		bool is_xml;
+		Filesystem_Stream::InputStream map_stream;
+		if (OpenMapFile(map_id, file.map_name, is_xml, map_stream).empty()) {
+			Output::Error("Loading of Map {} failed.\nThe map was not found.", file.map_name);
+			return nullptr;
+		}
+
 		if (!map_stream) {
-			Output::Error("Loading of Map {} failed.\nMap not readable.", map_name);
+			Output::Error("Loading of Map {} failed.\nMap not readable.", file.map_name);
 			return nullptr;
 		}
-		map = lcf::LMU_Reader::LoadXml(map_stream);
-	}
 
-	Output::Debug("Loaded Map {}", map_name);
+		file = ParseMapFile(map_id, std::move(file.map_name), std::move(map_stream), is_xml, Player::encoding, Input::IsRecording());
+		AddMapFileToCache(file, true);
+	}
 
-	if (map.get() == NULL) {
+	if (!file.map) {
 		Output::ErrorStr(lcf::LcfReader::GetError());
+		return nullptr;
 	}
 
+	if (Input::IsRecording() && file.has_crc) {
+		Input::AddRecordingData(Input::RecordingData::Hash,
+					   fmt::format("map{:04} {:#08x}", map_id, file.crc));
+	}
+
+	// The cached map is shared, every setup works on an own copy
+	auto map = std::make_unique<lcf::rpg::Map>(*file.map);
+
+	Output::Debug("Loaded Map {} ({}, {}ms)", file.map_name, source,
+		std::chrono::duration_cast<std::chrono::milliseconds>(Game_Clock::now() - start_time).count());
+
 	return map;
 }
 
+void Game_Map::PreloadMapFiles() {
+#ifdef USE_THREADS
+	int capacity = Player::player_config.map_cache_size.Get();
+	if (!map || capacity <= 1 || !FileFinder::Game()) {
+		return;
+	}
+
+	if (map_file_preload_task.valid()) {
+		if (map_file_preload_task.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			return;
+		}
+		map_file_preload_task.get();
+	}
+
+	// Unused preloads of the previous map are kept when there is space left in the cache
+	for (auto& preload: map_file_preloads) {
+		AddMapFileToCache(preload.second.get(), false);
+	}
+	map_file_preloads.clear();
+
+	// Maps reachable through teleport events of the current map.
+	// The current map stays in the cache.
+	std::vector<MapFilePreload> preloads;
+	for (const auto& ev: map->events) {
+		for (const auto& page: ev.pages) {
+			for (const auto& cmd: page.event_commands) {
+				if (static_cast<lcf::rpg::EventCommand::Code>(cmd.code) != lcf::rpg::EventCommand::Code::Teleport || cmd.parameters.empty()) {
+					continue;
+				}
+
+				int map_id = cmd.parameters[0];
+				if (map_id <= 0 || map_id == GetMapId() || static_cast<int>(preloads.size()) >= capacity - 1) {
+					continue;
+				}
+
+				if (std::any_of(preloads.begin(), preloads.end(), [&](const MapFilePreload& p) { return p.map_id == map_id; }) ||
+						std::any_of(map_file_cache.begin(), map_file_cache.end(), [&](const MapFile& f) { return f.map_id == map_id; })) {
+					continue;
+				}
+
+				MapFilePreload preload;
+				preload.map_id = map_id;
+				if (OpenMapFile(map_id, preload.map_name, preload.is_xml, preload.map_stream).empty() || !preload.map_stream) {
+					continue;
+				}
+				map_file_preloads[map_id] = preload.result.get_future();
+				preloads.push_back(std::move(preload));
+			}
+		}
+	}
+
+	if (preloads.empty()) {
+		return;
+	}
+
+	Output::Debug("Preloading {} maps", preloads.size());
+
+	map_file_preload_task = std::async(std::launch::async, [](std::vector<MapFilePreload> preloads, std::string encoding, bool with_crc) {
+		for (auto& preload: preloads) {
+			preload.result.set_value(ParseMapFile(preload.map_id, std::move(preload.map_name),
+				std::move(preload.map_stream), preload.is_xml, encoding, with_crc));
+		}
+	}, std::move(preloads), Player::encoding, Input::IsRecording());
+#endif
+}
+
+void Game_Map::ClearMapFileCache() {
+#ifdef USE_THREADS
+	WaitForMapFilePreloads();
+	map_file_preloads.clear();
+#endif
+	map_file_cache.clear();
+}
+
 void Game_Map::SetupCommon() {
 	screen_width = (Player::screen_width / 16.0) * SCREEN_TILE_SIZE;
 	screen_height = (Player::screen_height / 16.0) * SCREEN_TILE_SIZE;
@@ -349,6 +548,7 @@ void Game_Map::SetupCommon() {
 	}
 
 	map_cache->Clear();
+	Game_Pathfinder::Invalidate();
 
 	CreateMapEvents();
 }
@@ -1211,6 +1411,7 @@ void Game_Map::Update(MapUpdateAsyncContext& actx, bool is_preupdate) {
 	if (!actx.IsActive()) {
 		//If not resuming from async op ...
 		UpdateProcessedFlags(is_preupdate);
+		Game_Pathfinder::ResetBudget();
 	}
 
 	if (!actx.IsActive() || actx.IsParallelCommonEvent()) {
@@ -1324,6 +1525,13 @@ bool Game_Map::UpdateMapEvents(MapUpdateAsyncContext& actx) {
 			}
 		}
 
+		if (!resume_async && event_batch.Add(ev)) {
+			continue;
+		}
+
+		// Keep the update order: Queued events before this one are updated first
+		event_batch.Update();
+
 		auto aop = ev.Update(resume_async);
 		if (aop.IsActive()) {
 			// Suspend due to this event ..
@@ -1332,6 +1540,8 @@ bool Game_Map::UpdateMapEvents(MapUpdateAsyncContext& actx) {
 		}
 	}
 
+	event_batch.Update();
+
 	actx = {};
 	return true;
 }
@@ -1724,6 +1934,13 @@ void Game_Map::SetNeedRefreshForVarChange(std::initializer_list<int> var_ids) {
 	}
 }
 
+void Game_Map::SetNeedRefreshForSwitchRangeChange(int first_id, int last_id) {
+	if (need_refresh)
+		return;
+	if (map_cache->GetNeedRefresh<Caching::ObservedVarOps::SwitchSet>(first_id, last_id))
+		SetNeedRefresh(true);
+}
+
 std::vector<unsigned char>& Game_Map::GetPassagesDown() {
 	return passages_down;
 }
@@ -1792,6 +2009,8 @@ void Game_Map::SetChipset(int id) {
 		passages_down.resize(162, (unsigned char) 0x0F);
 	if (passages_up.size() < 144)
 		passages_up.resize(144, (unsigned char) 0x0F);
+
+	Game_Pathfinder::Invalidate();
 }
 
 bool Game_Map::ReloadChipset() {
@@ -1874,6 +2093,9 @@ static int DoSubstitute(std::vector<uint8_t>& tiles, int old_id, int new_id) {
 			++num_subst;
 		}
 	}
+	if (num_subst > 0) {
+		Game_Pathfinder::Invalidate();
+	}
 	return num_subst;
 }
 
@@ -1889,6 +2111,7 @@ void Game_Map::ReplaceTileAt(int x, int y, int new_id, int layer) {
 	auto pos = x + y * map->width;
 	auto& layer_vec = layer >= 1 ? map->upper_layer : map->lower_layer;
 	layer_vec[pos] = static_cast<int16_t>(new_id);
+	Game_Pathfinder::Invalidate();
 }
 
 int Game_Map::GetTileIdAt(int x, int y, int layer, bool chip_id_or_index) {
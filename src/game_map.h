@@ -134,6 +134,19 @@ namespace Game_Map {
 	 */
 	std::unique_ptr<lcf::rpg::Map> LoadMapFile(int map_id);
 
+	/**
+	 * Parses the maps that are reachable through Teleport commands of the
+	 * current map in the background so that LoadMapFile can use them.
+	 * Does nothing on platforms without thread support.
+	 */
+	void PreloadMapFiles();
+
+	/**
+	 * Removes all parsed maps from the cache.
+	 * Waits for pending preloads.
+	 */
+	void ClearMapFileCache();
+
 	/**
 	 * Setups a new map.
 	 *
@@ -742,6 +755,10 @@ namespace Game_Map {
 			template <ObservedVarOps Op>
 			bool GetNeedRefresh(int var_id);
 
+			/** @return whether an event observes any id in [first_id, last_id] */
+			template <ObservedVarOps Op>
+			bool GetNeedRefresh(int first_id, int last_id);
+
 			void Clear();
 		private:
 			MapEventCacheData_t refresh_targets_by_varid[ObservedVarOps_END];
@@ -752,6 +769,7 @@ namespace Game_Map {
 	void SetNeedRefreshForVarChange(int var_id);
 	void SetNeedRefreshForSwitchChange(std::initializer_list<int> switch_ids);
 	void SetNeedRefreshForVarChange(std::initializer_list<int> var_ids);
+	void SetNeedRefreshForSwitchRangeChange(int first_id, int last_id);
 
 	namespace Parallax {
 		struct Params {
@@ -927,4 +945,31 @@ inline bool Game_Map::Caching::MapCache::GetNeedRefresh(int var_id) {
 	return events_cache.find(var_id) != events_cache.end();
 }
 
+template <Game_Map::Caching::ObservedVarOps Op>
+inline bool Game_Map::Caching::MapCache::GetNeedRefresh(int first_id, int last_id) {
+	static_assert(static_cast<int>(Op) >= 0 && Op < ObservedVarOps_END);
+
+	auto& events_cache = refresh_targets_by_varid[static_cast<int>(Op)];
+	if (first_id > last_id) {
+		return false;
+	}
+
+	// Large ranges touch more ids than there are observed ones
+	if (static_cast<size_t>(last_id - first_id) >= events_cache.size()) {
+		for (auto& it: events_cache) {
+			if (it.first >= first_id && it.first <= last_id) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	for (int id = first_id; id <= last_id; ++id) {
+		if (events_cache.find(id) != events_cache.end()) {
+			return true;
+		}
+	}
+	return false;
+}
+
 #endif
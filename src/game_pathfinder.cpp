@@ -0,0 +1,490 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <unordered_map>
+#include "game_pathfinder.h"
+#include "game_character.h"
+#include "game_map.h"
+#include "game_player.h"
+#include "main_data.h"
+#include "map_data.h"
+#include <lcf/rpg/moveroute.h>
+
+namespace {
+	using Result = Game_Pathfinder::Result;
+
+	// Passable bit of each direction, indexed by Game_Character::Direction
+	constexpr int dir_bits[] = { Passable::Up, Passable::Right, Passable::Down, Passable::Left };
+
+	// Occupancy flags, bits 0 to 2 are the layers of blocking characters
+	constexpr uint8_t occ_event = 1 << 3;
+	constexpr uint8_t occ_overlap_forbidden = 1 << 4;
+	constexpr uint8_t occ_airship = 1 << 5;
+	/** A below event with a tile graphic overrides the chipset passability */
+	constexpr uint8_t occ_tile_event = 1 << 6;
+
+	struct Node {
+		int f;
+		int h;
+		int index;
+
+		bool operator>(const Node& o) const {
+			if (f != o.f) return f > o.f;
+			if (h != o.h) return h > o.h;
+			return index > o.index;
+		}
+	};
+
+	struct Path {
+		int x;
+		int y;
+		int target_x;
+		int target_y;
+		/** Next step at the back */
+		std::vector<uint8_t> dirs;
+		/** The target was not reachable */
+		bool no_path = false;
+		/** Occupancy generation the search was done with */
+		uint32_t generation = 0;
+	};
+
+	int width = 0;
+	int height = 0;
+	bool grid_valid = false;
+	/** Per tile: bit d is set when the tile can be left or entered in direction d */
+	std::vector<uint8_t> passable;
+
+	bool occupancy_valid = false;
+	std::vector<uint8_t> occupancy;
+	std::vector<uint8_t> next_occupancy;
+	/** Incremented when the grid or the occupancy changes */
+	uint32_t generation = 0;
+
+	int budget = Game_Pathfinder::frame_budget;
+
+	uint32_t stamp = 0;
+	std::vector<uint32_t> seen;
+	std::vector<uint32_t> closed;
+	std::vector<int> cost;
+	std::vector<uint8_t> parent;
+	std::vector<Node> open;
+
+	std::unordered_map<const Game_Character*, Path> paths;
+}
+
+static void BuildGrid() {
+	width = Game_Map::GetTilesX();
+	height = Game_Map::GetTilesY();
+	passable.assign(width * height, 0);
+
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			uint8_t mask = 0;
+			for (int d = 0; d < 4; ++d) {
+				if (Game_Map::IsPassableTile(nullptr, dir_bits[d], x, y, false, true)) {
+					mask |= 1 << d;
+				}
+			}
+			passable[x + y * width] = mask;
+		}
+	}
+
+	seen.assign(width * height, 0);
+	closed.assign(width * height, 0);
+	cost.assign(width * height, 0);
+	parent.assign(width * height, 0);
+	stamp = 0;
+	grid_valid = true;
+	occupancy_valid = false;
+	occupancy.clear();
+	++generation;
+}
+
+static uint8_t GetBlockFlags(const Game_Character& ch) {
+	if (!ch.IsActive() || ch.GetThrough() || ch.IsFlying()) {
+		return 0;
+	}
+	return 1 << Utils::Clamp(ch.GetLayer(), 0, 2);
+}
+
+static void BuildOccupancy() {
+	next_occupancy.assign(width * height, 0);
+
+	auto mark = [](const Game_Character& ch, uint8_t flags) {
+		const int x = ch.GetX();
+		const int y = ch.GetY();
+		if (flags != 0 && Game_Map::IsValid(x, y)) {
+			next_occupancy[x + y * width] |= flags;
+		}
+	};
+
+	// See WouldCollide and IsPassableTile in game_map.cpp
+	for (auto& ev: Game_Map::GetEvents()) {
+		uint8_t flags = GetBlockFlags(ev);
+		if (flags != 0) {
+			flags |= occ_event;
+			if (ev.IsOverlapForbidden()) {
+				flags |= occ_overlap_forbidden;
+			}
+			if (ev.GetLayer() == lcf::rpg::EventPage::Layers_below && ev.GetTileId() > 0 && ev.GetActivePage() != nullptr) {
+				flags |= occ_tile_event;
+			}
+		}
+		mark(ev, flags);
+	}
+
+	auto& player = *Main_Data::game_player;
+	if (player.GetVehicleType() == Game_Vehicle::None) {
+		mark(player, GetBlockFlags(player));
+	}
+	for (auto vid: { Game_Vehicle::Boat, Game_Vehicle::Ship }) {
+		auto* vehicle = Game_Map::GetVehicle(vid);
+		if (vehicle && vehicle->IsInCurrentMap()) {
+			mark(*vehicle, GetBlockFlags(*vehicle));
+		}
+	}
+	auto* airship = Game_Map::GetVehicle(Game_Vehicle::Airship);
+	if (airship && airship->IsInCurrentMap() && GetBlockFlags(*airship) != 0) {
+		mark(*airship, occ_airship);
+	}
+
+	if (next_occupancy != occupancy) {
+		occupancy.swap(next_occupancy);
+		++generation;
+	}
+	occupancy_valid = true;
+}
+
+static void Prepare() {
+	if (!grid_valid || width != Game_Map::GetTilesX() || height != Game_Map::GetTilesY()) {
+		BuildGrid();
+	}
+	if (!occupancy_valid) {
+		BuildOccupancy();
+	}
+}
+
+static bool IsBlocked(const Game_Character& self, uint8_t occ) {
+	if (occ & (1 << Utils::Clamp(self.GetLayer(), 0, 2))) {
+		return true;
+	}
+	if (self.GetType() == Game_Character::Event
+			&& (occ & occ_event)
+			&& (self.IsOverlapForbidden() || (occ & occ_overlap_forbidden))) {
+		return true;
+	}
+	if (self.GetType() != Game_Character::Player
+			&& (occ & occ_airship)
+			&& self.GetLayer() == lcf::rpg::EventPage::Layers_same) {
+		return true;
+	}
+	return false;
+}
+
+/** Character whose passability is not covered by the grid, e.g. a vehicle */
+static const Game_Character* GetExactWalker(const Game_Character& self) {
+	if (self.GetType() == Game_Character::Vehicle) {
+		return &self;
+	}
+	if (self.GetType() == Game_Character::Player) {
+		auto& player = static_cast<const Game_Player&>(self);
+		if (player.IsAboard()) {
+			return player.GetVehicle();
+		}
+	}
+	return nullptr;
+}
+
+static bool CanStep(const Game_Character& self, const Game_Character* exact, int x, int y, int d, bool is_goal) {
+	const int raw_x = x + Game_Character::GetDxFromDirection(d);
+	const int raw_y = y + Game_Character::GetDyFromDirection(d);
+	const int nx = Game_Map::RoundX(raw_x);
+	const int ny = Game_Map::RoundY(raw_y);
+	if (!Game_Map::IsValid(nx, ny)) {
+		return false;
+	}
+
+	if (exact) {
+		return Game_Map::CheckWay(*exact, x, y, raw_x, raw_y, !is_goal, nullptr);
+	}
+
+	if (self.GetThrough()) {
+		return true;
+	}
+
+	const int from = x + y * width;
+	const int to = nx + ny * width;
+	const uint8_t occ_from = occupancy[from];
+	const uint8_t occ_to = occupancy[to];
+
+	if (!is_goal && !self.IsFlying() && IsBlocked(self, occ_to)) {
+		return false;
+	}
+
+	if (occ_from & occ_tile_event) {
+		if (!Game_Map::IsPassableTile(&self, dir_bits[d], x, y)) {
+			return false;
+		}
+	} else if ((passable[from] & (1 << d)) == 0) {
+		return false;
+	}
+
+	const int rd = Game_Character::ReverseDir(d);
+	if (occ_to & occ_tile_event) {
+		return Game_Map::IsPassableTile(&self, dir_bits[rd], nx, ny);
+	}
+	return (passable[to] & (1 << rd)) != 0;
+}
+
+static int Distance(int a, int b, int size, bool loop) {
+	const int d = std::abs(a - b);
+	return loop ? std::min(d, size - d) : d;
+}
+
+Result Game_Pathfinder::FindPath(const Game_Character& self, int x, int y, std::vector<int>& path) {
+	path.clear();
+
+	const int sx = Game_Map::RoundX(self.GetX());
+	const int sy = Game_Map::RoundY(self.GetY());
+	x = Game_Map::RoundX(x);
+	y = Game_Map::RoundY(y);
+
+	if (!Game_Map::IsValid(sx, sy) || !Game_Map::IsValid(x, y)) {
+		return Result::NoPath;
+	}
+
+	if (sx == x && sy == y) {
+		return Result::Arrived;
+	}
+
+	if (budget <= 0) {
+		return Result::Deferred;
+	}
+
+	Prepare();
+
+	if (++stamp == 0) {
+		std::fill(seen.begin(), seen.end(), 0);
+		std::fill(closed.begin(), closed.end(), 0);
+		stamp = 1;
+	}
+
+	const bool loop_h = Game_Map::LoopHorizontal();
+	const bool loop_v = Game_Map::LoopVertical();
+	const auto* exact = GetExactWalker(self);
+	const int limit = std::min(budget, search_budget);
+	const int start = sx + sy * width;
+	const int goal = x + y * width;
+
+	auto heuristic = [&](int tx, int ty) {
+		return Distance(tx, x, width, loop_h) + Distance(ty, y, height, loop_v);
+	};
+
+	open.clear();
+	seen[start] = stamp;
+	cost[start] = 0;
+	const int start_h = heuristic(sx, sy);
+	open.push_back({ start_h, start_h, start });
+
+	int expanded = 0;
+	while (!open.empty()) {
+		std::pop_heap(open.begin(), open.end(), std::greater<Node>());
+		const int index = open.back().index;
+		open.pop_back();
+
+		if (closed[index] == stamp) {
+			continue;
+		}
+		closed[index] = stamp;
+
+		if (index == goal) {
+			budget -= expanded;
+			for (int i = goal; i != start; ) {
+				const int d = parent[i];
+				path.push_back(d);
+				const int px = Game_Map::RoundX(i % width - Game_Character::GetDxFromDirection(d));
+				const int py = Game_Map::RoundY(i / width - Game_Character::GetDyFromDirection(d));
+				i = px + py * width;
+			}
+			std::reverse(path.begin(), path.end());
+			return Result::Step;
+		}
+
+		if (expanded >= limit) {
+			if (limit < search_budget) {
+				// Try again with the full share in the next frame
+				budget = 0;
+				return Result::Deferred;
+			}
+			// A search that does not fit into its share is given up
+			budget -= expanded;
+			return Result::NoPath;
+		}
+		++expanded;
+
+		const int cx = index % width;
+		const int cy = index / width;
+		const int g = cost[index] + 1;
+
+		for (int d = 0; d < 4; ++d) {
+			const int nx = Game_Map::RoundX(cx + Game_Character::GetDxFromDirection(d));
+			const int ny = Game_Map::RoundY(cy + Game_Character::GetDyFromDirection(d));
+			if (!Game_Map::IsValid(nx, ny)) {
+				continue;
+			}
+			const int next = nx + ny * width;
+			if (closed[next] == stamp || (seen[next] == stamp && cost[next] <= g)) {
+				continue;
+			}
+			if (!CanStep(self, exact, cx, cy, d, next == goal)) {
+				continue;
+			}
+			seen[next] = stamp;
+			cost[next] = g;
+			parent[next] = static_cast<uint8_t>(d);
+			const int h = heuristic(nx, ny);
+			open.push_back({ g + h, h, next });
+			std::push_heap(open.begin(), open.end(), std::greater<Node>());
+		}
+	}
+
+	budget -= expanded;
+	return Result::NoPath;
+}
+
+Result Game_Pathfinder::NextStep(const Game_Character& self, int x, int y, int& dir) {
+	dir = -1;
+
+	const int sx = Game_Map::RoundX(self.GetX());
+	const int sy = Game_Map::RoundY(self.GetY());
+	x = Game_Map::RoundX(x);
+	y = Game_Map::RoundY(y);
+
+	if (sx == x && sy == y) {
+		ForgetPath(self);
+		return Result::Arrived;
+	}
+
+	// Next to the target and it is occupied or cannot be entered
+	for (int d = 0; d < 4; ++d) {
+		const int raw_x = sx + Game_Character::GetDxFromDirection(d);
+		const int raw_y = sy + Game_Character::GetDyFromDirection(d);
+		if (Game_Map::RoundX(raw_x) == x && Game_Map::RoundY(raw_y) == y) {
+			if (!Game_Map::CheckWay(self, sx, sy, raw_x, raw_y)) {
+				ForgetPath(self);
+				dir = d;
+				return Result::Arrived;
+			}
+			break;
+		}
+	}
+
+	auto it = paths.find(&self);
+	if (it != paths.end()
+			&& (it->second.x != sx || it->second.y != sy
+			|| it->second.target_x != x || it->second.target_y != y)) {
+		paths.erase(it);
+		it = paths.end();
+	}
+
+	if (it != paths.end() && it->second.no_path) {
+		// Nothing changed since the target was found unreachable
+		Prepare();
+		if (it->second.generation == generation) {
+			return Result::NoPath;
+		}
+	}
+
+	if (it == paths.end() || it->second.dirs.empty()) {
+		std::vector<int> steps;
+		const auto result = FindPath(self, x, y, steps);
+		if (result == Result::Deferred) {
+			ForgetPath(self);
+			return result;
+		}
+
+		auto& path = paths[&self];
+		path.x = sx;
+		path.y = sy;
+		path.target_x = x;
+		path.target_y = y;
+		path.no_path = result != Result::Step;
+		path.generation = generation;
+		path.dirs.assign(steps.rbegin(), steps.rend());
+		if (path.no_path) {
+			return result;
+		}
+		it = paths.find(&self);
+	}
+
+	auto& path = it->second;
+	dir = path.dirs.back();
+	path.dirs.pop_back();
+	path.x = Game_Map::RoundX(sx + Game_Character::GetDxFromDirection(dir));
+	path.y = Game_Map::RoundY(sy + Game_Character::GetDyFromDirection(dir));
+	return Result::Step;
+}
+
+void Game_Pathfinder::ForgetPath(const Game_Character& self) {
+	paths.erase(&self);
+}
+
+void Game_Pathfinder::ResetBudget() {
+	budget = frame_budget;
+	occupancy_valid = false;
+}
+
+int Game_Pathfinder::GetBudget() {
+	return budget;
+}
+
+void Game_Pathfinder::Invalidate() {
+	grid_valid = false;
+	occupancy_valid = false;
+	paths.clear();
+}
+
+void Game_Pathfinder::EncodeMoveRoute(lcf::rpg::MoveRoute& route) {
+	for (auto& cmd: route.move_commands) {
+		if (cmd.command_id != move_command_walk_to) {
+			continue;
+		}
+		auto clamp = [](int value) {
+			return (value < 0 || value >= coordinate_limit) ? coordinate_limit - 1 : value;
+		};
+		cmd.command_id = move_command_walk_to_saved + clamp(cmd.parameter_b) * coordinate_limit + clamp(cmd.parameter_a);
+		cmd.parameter_a = 0;
+		cmd.parameter_b = 0;
+	}
+}
+
+void Game_Pathfinder::DecodeMoveRoute(lcf::rpg::MoveRoute& route) {
+	for (auto& cmd: route.move_commands) {
+		const int value = cmd.command_id - move_command_walk_to_saved;
+		if (value < 0 || value >= coordinate_limit * coordinate_limit) {
+			continue;
+		}
+		cmd.command_id = move_command_walk_to;
+		cmd.parameter_a = value % coordinate_limit;
+		cmd.parameter_b = value / coordinate_limit;
+	}
+}
@@ -0,0 +1,136 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_GAME_PATHFINDER_H
+#define EP_GAME_PATHFINDER_H
+
+// Headers
+#include <vector>
+
+class Game_Character;
+namespace lcf::rpg {
+	class MoveRoute;
+}
+
+/**
+ * A* path search on the current map for the EasyRPG "Walk To" command.
+ *
+ * The tile passability of the map is cached in a grid which is rebuilt
+ * when the map, the chipset or a tile changes. The positions of the other
+ * characters are collected once per frame when a search happens.
+ *
+ * All searches of one frame share a budget of expanded tiles. A search that
+ * does not fit into the remaining budget is retried in the next frame, which
+ * keeps the frame time stable when many characters search at once. A single
+ * search may only use a share of the budget, and a target found unreachable
+ * is not searched again until the map or the character positions change.
+ */
+namespace Game_Pathfinder {
+	/** Move route command id of "Walk To". Parameter A/B: Target x/y */
+	constexpr int move_command_walk_to = 64;
+
+	/**
+	 * Move route command ids of "Walk To" in savegames: The target is
+	 * encoded in the id because liblcf only saves the parameters of the
+	 * commands it knows. Id = base + y * coordinate_limit + x.
+	 */
+	constexpr int move_command_walk_to_saved = 0x1000000;
+
+	/** Targets are stored in savegames in the range 0 to coordinate_limit - 1 */
+	constexpr int coordinate_limit = 4096;
+
+	/** Event command code of the EasyRPG "Walk To" command */
+	constexpr int event_command_walk_to = 2060;
+
+	/** Number of tiles all searches of a frame may expand */
+	constexpr int frame_budget = 8192;
+
+	/** Number of tiles a single search may expand */
+	constexpr int search_budget = frame_budget / 2;
+
+	enum class Result {
+		/** The character shall move in the returned direction */
+		Step,
+		/** The character is on or next to the target */
+		Arrived,
+		/** The target is not reachable */
+		NoPath,
+		/** The budget of this frame is used up, try again in the next frame */
+		Deferred
+	};
+
+	/**
+	 * Searches a path from the position of a character to a target tile.
+	 *
+	 * Other characters block the path, except on the target tile.
+	 *
+	 * @param self character that walks
+	 * @param x target x position
+	 * @param y target y position
+	 * @param path receives the directions of the steps in walking order
+	 * @return Step when a path was found, Arrived when self is already
+	 *         on the target, NoPath or Deferred
+	 */
+	Result FindPath(const Game_Character& self, int x, int y, std::vector<int>& path);
+
+	/**
+	 * Returns the next step towards a target tile.
+	 * The path is searched once and remembered for the next steps.
+	 *
+	 * @param self character that walks
+	 * @param x target x position
+	 * @param y target y position
+	 * @param dir receives the direction of the step when Step is returned
+	 * @return see Result
+	 */
+	Result NextStep(const Game_Character& self, int x, int y, int& dir);
+
+	/**
+	 * Forgets the remembered path of a character, e.g. because a step
+	 * was blocked.
+	 *
+	 * @param self character
+	 */
+	void ForgetPath(const Game_Character& self);
+
+	/** Refills the search budget and drops the character positions. Called once per frame. */
+	void ResetBudget();
+
+	/** @return remaining search budget of this frame */
+	int GetBudget();
+
+	/** Drops the passability grid and all paths. Called when the map or its tiles change. */
+	void Invalidate();
+
+	/**
+	 * Stores the targets of the "Walk To" commands of a move route in the
+	 * command ids. Called on a copy of the route that is saved.
+	 * Targets outside of the saved range become a target outside of every map.
+	 *
+	 * @param route move route
+	 */
+	void EncodeMoveRoute(lcf::rpg::MoveRoute& route);
+
+	/**
+	 * Restores the "Walk To" commands of a move route loaded from a savegame.
+	 *
+	 * @param route move route
+	 */
+	void DecodeMoveRoute(lcf::rpg::MoveRoute& route);
+}
+
+#endif
@@ -21,6 +21,7 @@
 #include "game_actor.h"
 #include "game_map.h"
 #include "game_message.h"
+#include "game_pathfinder.h"
 #include "game_party.h"
 #include "game_system.h"
 #include "game_screen.h"
@@ -42,6 +43,7 @@
 #include <algorithm>
 #include <cmath>
 #include "scene_gameover.h"
+#include "game_clock.h"
 
 Game_Player::Game_Player(): Game_PlayerBase(Player)
 {
@@ -62,7 +64,9 @@ void Game_Player::SetSaveData(lcf::rpg::SavePartyLocation save)
 }
 
 lcf::rpg::SavePartyLocation Game_Player::GetSaveData() const {
-	return *data();
+	auto save = *data();
+	Game_Pathfinder::EncodeMoveRoute(save.move_route);
+	return save;
 }
 
 Drawable::Z_t Game_Player::GetScreenZ(int x_offset, int y_offset) const {
@@ -153,10 +157,13 @@ void Game_Player::MoveTo(int map_id, int x, int y) {
 
 		ResetAnimation();
 
+		auto start_time = Game_Clock::now();
 		auto map = Game_Map::LoadMapFile(GetMapId());
 
 		Game_Map::Setup(std::move(map));
 		Game_Map::PlayBgm();
+		Output::Debug("Map transition to {} took {}ms", GetMapId(),
+			std::chrono::duration_cast<std::chrono::milliseconds>(Game_Clock::now() - start_time).count());
 
 		// This Fixes an RPG_RT bug where the jumping flag doesn't get reset
 		// if you change maps during a jump
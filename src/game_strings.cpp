@@ -16,6 +16,8 @@
  */
 
  // Headers
+#include <list>
+#include <map>
 #include <regex>
 #include <lcf/encoder.h>
 #include "async_handler.h"
@@ -32,11 +34,147 @@
 #include "json_helper.h"
 #endif
 
+namespace {
+	/**
+	 * LRU cache of compiled regular expressions.
+	 * Compiling a std::regex is much slower than matching, and Maniac games
+	 * often run the same expression in a loop.
+	 */
+	template <typename CharT>
+	class RegexCache {
+	public:
+		using String = std::basic_string<CharT>;
+		using Regex = std::basic_regex<CharT>;
+		using Flags = std::regex_constants::syntax_option_type;
+
+		const Regex& Get(const String& pattern, Flags flags = std::regex_constants::ECMAScript) {
+			auto key = std::make_pair(pattern, flags);
+			auto it = index.find(key);
+			if (it != index.end()) {
+				entries.splice(entries.begin(), entries, it->second);
+				return it->second->second;
+			}
+
+			// Invalid expressions throw before anything is added
+			Regex regex(pattern, flags);
+			entries.emplace_front(key, std::move(regex));
+			index.emplace(std::move(key), entries.begin());
+
+			if (entries.size() > capacity) {
+				index.erase(entries.back().first);
+				entries.pop_back();
+			}
+			return entries.front().second;
+		}
+
+	private:
+		static constexpr size_t capacity = 32;
+
+		using Entry = std::pair<std::pair<String, Flags>, Regex>;
+		std::list<Entry> entries;
+		std::map<std::pair<String, Flags>, typename std::list<Entry>::iterator> index;
+	};
+
+	RegexCache<char> regex_cache;
+	RegexCache<wchar_t> wregex_cache;
+
+	/**
+	 * The narrow std::regex matches bytes. It can only be used when the
+	 * pattern is ASCII and has no escape for a codepoint above 0x7F
+	 * (\uXXXX or \xHH).
+	 */
+	bool IsAsciiRegex(StringView expr) {
+		if (!Utils::StringIsAscii(expr)) {
+			return false;
+		}
+
+		for (size_t i = 0; i + 1 < expr.size(); ++i) {
+			if (expr[i] != '\\') {
+				continue;
+			}
+			++i;
+			if (expr[i] == 'u') {
+				return false;
+			}
+			if (expr[i] == 'x' && i + 1 < expr.size() && expr[i + 1] > '7') {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
 void Game_Strings::WarnGet(int id) const {
 	Output::Debug("Invalid read strvar[{}]!", id);
 	--_warnings;
 }
 
+void Game_Strings::SetData(const std::vector<lcf::DBString>& s) {
+	int i = 1;
+	for (const auto& string: s) {
+		Store(i, ToString(string));
+		++i;
+	}
+
+#ifdef HAVE_NLOHMANN_JSON
+	_json_cache.clear();
+#endif
+}
+
+void Game_Strings::Store(int id, const std::string& value) {
+	assert(id > 0);
+	if (id > static_cast<int>(_slots.size())) {
+		_slots.resize(id);
+	}
+
+	auto& slot = _slots[id - 1];
+	auto size = static_cast<uint32_t>(value.size());
+
+	if (size <= inline_size) {
+		_arena_garbage += slot.capacity;
+		slot.capacity = 0;
+		std::copy(value.begin(), value.end(), slot.inline_data);
+	} else if (size <= slot.capacity) {
+		std::copy(value.begin(), value.end(), _arena.begin() + slot.offset);
+	} else {
+		_arena_garbage += slot.capacity;
+		slot.capacity = 0;
+		// Compact when more than half of a large arena is unused
+		if (_arena_garbage > 64 * 1024 && _arena_garbage > _arena.size() / 2) {
+			CompactArena();
+		}
+
+		// Leave room for strings that grow with Cat
+		slot.offset = static_cast<uint32_t>(_arena.size());
+		slot.capacity = size + size / 2;
+		_arena.resize(_arena.size() + slot.capacity);
+		std::copy(value.begin(), value.end(), _arena.begin() + slot.offset);
+	}
+
+	slot.size = size;
+	slot.used = true;
+
+#ifdef HAVE_NLOHMANN_JSON
+	_json_cache.erase(id);
+#endif
+}
+
+void Game_Strings::CompactArena() {
+	std::vector<char> arena;
+	arena.reserve(_arena.size() - _arena_garbage);
+
+	for (auto& slot: _slots) {
+		if (slot.capacity > 0) {
+			auto offset = static_cast<uint32_t>(arena.size());
+			arena.insert(arena.end(), _arena.begin() + slot.offset, _arena.begin() + slot.offset + slot.capacity);
+			slot.offset = offset;
+		}
+	}
+
+	_arena = std::move(arena);
+	_arena_garbage = 0;
+}
+
 #ifdef HAVE_NLOHMANN_JSON
 nlohmann::json* Game_Strings::ParseJson(int id) {
 	auto it = _json_cache.find(id);
@@ -50,8 +188,9 @@ nlohmann::json* Game_Strings::ParseJson(int id) {
 	if (!res) {
 		return nullptr;
 	} else {
-		_json_cache[id] = *res;
-		return &_json_cache[id];
+		auto& json = _json_cache[id];
+		json = std::move(*res);
+		return &json;
 	}
 }
 #endif
@@ -66,13 +205,13 @@ StringView Game_Strings::Cat(Str_Params params, StringView string) {
 		return {};
 	}
 
-	auto it = _strings.find(params.string_id);
-	if (it == _strings.end()) {
+	auto* slot = FindSlot(params.string_id);
+	if (!slot) {
 		Set(params, string);
 		return Get(params.string_id);
 	}
-	it->second += ToString(string);
-	return it->second;
+	Store(params.string_id, ToString(View(*slot)) + ToString(string));
+	return Get(params.string_id);
 }
 
 int Game_Strings::ToNum(Str_Params params, int var_id, Game_Variables& variables) {
@@ -80,16 +219,17 @@ int Game_Strings::ToNum(Str_Params params, int var_id, Game_Variables& variables
 		return -1;
 	}
 
-	auto it = _strings.find(params.string_id);
-	if (it == _strings.end()) {
+	auto* slot = FindSlot(params.string_id);
+	if (!slot) {
 		return 0;
 	}
 
+	std::string str = ToString(View(*slot));
 	int num;
 	if (params.hex)
-		num = static_cast<int>(std::strtol(it->second.c_str(), nullptr, 16));
+		num = static_cast<int>(std::strtol(str.c_str(), nullptr, 16));
 	else
-		num = static_cast<int>(std::strtol(it->second.c_str(), nullptr, 0));
+		num = static_cast<int>(std::strtol(str.c_str(), nullptr, 0));
 
 	variables.Set(var_id, num);
 
@@ -300,16 +440,21 @@ StringView Game_Strings::ExMatch(Str_Params params, std::string expr, int var_id
 	auto source = Get(params.string_id);
 	std::string base = Substring(source, begin, Utils::UTF8Length(source));
 
-	std::wsmatch match;
-	auto wbase = Utils::ToWideString(base);
-	auto wexpr = Utils::ToWideString(expr);
-
-	std::wregex r(wexpr);
-
-	std::regex_search(wbase, match, r);
-	str_result = Utils::FromWideString(match.str());
+	if (Utils::StringIsAscii(base) && IsAsciiRegex(expr)) {
+		// Without multibyte characters the byte position is the codepoint position
+		std::smatch match;
+		std::regex_search(base, match, regex_cache.Get(expr));
+		str_result = match.str();
+		var_result = match.position() + begin;
+	} else {
+		std::wsmatch match;
+		auto wbase = Utils::ToWideString(base);
+		auto wexpr = Utils::ToWideString(expr);
 
-	var_result = match.position() + begin;
+		std::regex_search(wbase, match, wregex_cache.Get(wexpr));
+		str_result = Utils::FromWideString(match.str());
+		var_result = match.position() + begin;
+	}
 	variables.Set(var_id, var_result);
 	Game_Map::SetNeedRefreshForVarChange(var_id);
 
@@ -320,14 +465,14 @@ StringView Game_Strings::ExMatch(Str_Params params, std::string expr, int var_id
 	return str_result;
 }
 
-const Game_Strings::Strings_t& Game_Strings::RangeOp(Str_Params params, int string_id_1, std::string string, int op, int args[], Game_Variables& variables) {
+void Game_Strings::RangeOp(Str_Params params, int string_id_1, std::string string, int op, int args[], Game_Variables& variables) {
 	if (EP_UNLIKELY(ShouldWarn(params.string_id))) {
 		WarnGet(params.string_id);
 	}
 	if (EP_UNLIKELY(ShouldWarn(string_id_1))) {
 		WarnGet(string_id_1);
 	}
-	if (params.string_id <= 0 && string_id_1 <= 0) { return GetData(); }
+	if (params.string_id <= 0 && string_id_1 <= 0) { return; }
 
 	// maniacs just ignores if only one of the params is <= 0
 	if (params.string_id <= 0) { params.string_id = 1; }
@@ -351,7 +496,6 @@ const Game_Strings::Strings_t& Game_Strings::RangeOp(Str_Params params, int stri
 		case 10: ExMatch(params, string, args[1] + (params.string_id - start), args[2], args[3], variables); break;
 		}
 	}
-	return GetData();
 }
 
 std::string Game_Strings::PrependMin(StringView string, int min_size, char c) {
@@ -450,13 +594,15 @@ std::string Game_Strings::Erase(StringView source, int begin, int length) {
 std::string Game_Strings::RegExReplace(StringView str, StringView search, StringView replace, std::regex_constants::match_flag_type flags) {
 	// std::regex only works with char and wchar, not char32
 	// For full Unicode support requires the w-API, even on non-Windows systems
+	if (Utils::StringIsAscii(str) && IsAsciiRegex(search) && Utils::StringIsAscii(replace)) {
+		return std::regex_replace(ToString(str), regex_cache.Get(ToString(search)), ToString(replace), flags);
+	}
+
 	auto wstr = Utils::ToWideString(str);
 	auto wsearch = Utils::ToWideString(search);
 	auto wreplace = Utils::ToWideString(replace);
 
-	std::wregex rexp(wsearch);
-
-	auto result = std::regex_replace(wstr, rexp, wreplace, flags);
+	auto result = std::regex_replace(wstr, wregex_cache.Get(wsearch), wreplace, flags);
 
 	return Utils::FromWideString(result);
 }
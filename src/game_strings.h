@@ -19,6 +19,8 @@
 #include "system.h"
 #include <cstdint>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <lcf/data.h>
 #include "compiler.h"
 #include "game_variables.h"
@@ -44,11 +46,13 @@
  *
  * Where simple to implement UTF8 is used directly.
  * In other cases the code does a roundtrip through UTF32.
+ *
+ * The strings are stored in a vector indexed by id. Short strings are stored
+ * inline, longer ones in a shared arena. A StringView returned by this class
+ * is only valid until the next string is modified.
  */
 class Game_Strings {
 public:
-	using Strings_t = std::unordered_map<int, std::string>;
-
 	// currently only warns when ID <= 0
 	static constexpr int max_warnings = 10;
 
@@ -67,9 +71,7 @@ public:
 
 	Game_Strings() = default;
 
-	void SetData(Strings_t s);
 	void SetData(const std::vector<lcf::DBString>& s);
-	const Strings_t& GetData() const;
 	std::vector<lcf::DBString> GetLcfData() const;
 
 	StringView Get(int id) const;
@@ -92,7 +94,7 @@ public:
 	StringView PopLine(Str_Params params, int offset, int string_out_id);
 	StringView ExMatch(Str_Params params, std::string expr, int var_id, int begin, int string_out_id, Game_Variables& variables);
 
-	const Strings_t& RangeOp(Str_Params params, int string_id_1, std::string string, int op, int args[], Game_Variables& variables);
+	void RangeOp(Str_Params params, int string_id_1, std::string string, int op, int args[], Game_Variables& variables);
 
 	static std::string PrependMin(StringView string, int min_size, char c);
 	static std::string Extract(StringView string, bool as_hex);
@@ -106,11 +108,40 @@ public:
 	static std::optional<std::string> ManiacsCommandInserterHex(char ch, const char** iter, const char* end, uint32_t escape_char);
 
 private:
+	static constexpr uint32_t inline_size = 16;
+
+	struct Slot {
+		uint32_t size = 0;
+		/** Reserved bytes in the arena, 0 when the string is stored inline */
+		uint32_t capacity = 0;
+		/** Whether the string was ever assigned */
+		bool used = false;
+		union {
+			char inline_data[inline_size];
+			uint32_t offset;
+		};
+	};
+
 	void Set(Str_Params params, StringView string);
 	bool ShouldWarn(int id) const;
 	void WarnGet(int id) const;
 
-	Strings_t _strings;
+	const Slot* FindSlot(int id) const;
+	StringView View(const Slot& slot) const;
+
+	/**
+	 * Replaces the string with the given id and invalidates the cached JSON.
+	 *
+	 * @param id string id (> 0)
+	 * @param value new content, must not be a view of a stored string
+	 */
+	void Store(int id, const std::string& value);
+	void CompactArena();
+
+	std::vector<Slot> _slots;
+	std::vector<char> _arena;
+	/** Arena bytes no longer referenced by a slot */
+	size_t _arena_garbage = 0;
 	mutable int _warnings = max_warnings;
 
 #ifdef HAVE_NLOHMANN_JSON
@@ -128,57 +159,25 @@ inline void Game_Strings::Set(Str_Params params, StringView string) {
 		ins_string = Extract(ins_string, params.hex);
 	}
 
-	auto it = _strings.find(params.string_id);
-	if (it == _strings.end()) {
-		if (ins_string.empty()) {
-			return;
-		} else {
-			_strings[params.string_id] = ins_string;
-		}
-	} else {
-		it->second = ins_string;
-	}
-
-#ifdef HAVE_NLOHMANN_JSON
-	_json_cache.erase(params.string_id);
-#endif
-}
-
-inline void Game_Strings::SetData(Strings_t s) {
-	_strings = std::move(s);
-
-#ifdef HAVE_NLOHMANN_JSON
-	_json_cache.clear();
-#endif
-}
-
-inline void Game_Strings::SetData(const std::vector<lcf::DBString>& s) {
-	int i = 1;
-	for (const auto& string: s) {
-		if (!s.empty()) {
-			_strings[i] = ToString(string);
-		}
-		++i;
+	if (!FindSlot(params.string_id) && ins_string.empty()) {
+		return;
 	}
-
-#ifdef HAVE_NLOHMANN_JSON
-	_json_cache.clear();
-#endif
-}
-
-inline const Game_Strings::Strings_t& Game_Strings::GetData() const {
-	return _strings;
+	Store(params.string_id, ins_string);
 }
 
 inline std::vector<lcf::DBString> Game_Strings::GetLcfData() const {
 	std::vector<lcf::DBString> lcf_data;
 
-	for (auto& [index, value]: _strings) {
-		assert(index > 0);
-		if (index >= static_cast<int>(lcf_data.size())) {
-			lcf_data.resize(index + 1);
+	for (int i = static_cast<int>(_slots.size()) - 1; i >= 0; --i) {
+		if (_slots[i].used) {
+			lcf_data.resize(i + 2);
+			break;
+		}
+	}
+	for (size_t i = 0; i < _slots.size(); ++i) {
+		if (_slots[i].used) {
+			lcf_data[i] = lcf::DBString(View(_slots[i]));
 		}
-		lcf_data[index - 1] = lcf::DBString(value);
 	}
 
 	return lcf_data;
@@ -188,15 +187,29 @@ inline bool Game_Strings::ShouldWarn(int id) const {
 	return id <= 0 && _warnings > 0;
 }
 
+inline const Game_Strings::Slot* Game_Strings::FindSlot(int id) const {
+	if (id <= 0 || id > static_cast<int>(_slots.size()) || !_slots[id - 1].used) {
+		return nullptr;
+	}
+	return &_slots[id - 1];
+}
+
+inline StringView Game_Strings::View(const Slot& slot) const {
+	if (slot.capacity == 0) {
+		return StringView(slot.inline_data, slot.size);
+	}
+	return StringView(_arena.data() + slot.offset, slot.size);
+}
+
 inline StringView Game_Strings::Get(int id) const {
 	if (EP_UNLIKELY(ShouldWarn(id))) {
 		WarnGet(id);
 	}
-	auto it = _strings.find(id);
-	if (it == _strings.end()) {
+	auto* slot = FindSlot(id);
+	if (!slot) {
 		return {};
 	}
-	return it->second;
+	return View(*slot);
 }
 
 inline StringView Game_Strings::GetIndirect(int id, const Game_Variables& variables) const {
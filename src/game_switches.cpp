@@ -17,6 +17,7 @@
 
 // Headers
 #include "game_switches.h"
+#include "interpreter_trace.h"
 #include "output.h"
 #include <lcf/reader_util.h>
 #include <lcf/data.h>
@@ -26,6 +27,51 @@ void Game_Switches::WarnGet(int variable_id) const {
 	--_warnings;
 }
 
+void Game_Switches::SetData(const Switches_t& s) {
+	_words.assign((s.size() + kWordBits - 1) / kWordBits, 0);
+	_size = static_cast<int>(s.size());
+	for (size_t i = 0; i < s.size(); ++i) {
+		if (s[i]) {
+			_words[i / kWordBits] |= Word(1) << (i % kWordBits);
+		}
+	}
+}
+
+Game_Switches::Switches_t Game_Switches::GetData() const {
+	Switches_t s(_size);
+	for (int i = 0; i < _size; ++i) {
+		s[i] = (_words[i / kWordBits] >> (i % kWordBits)) & 1;
+	}
+	return s;
+}
+
+void Game_Switches::Resize(int size) {
+	if (size > _size) {
+		_words.resize((size + kWordBits - 1) / kWordBits, 0);
+		_size = size;
+	}
+}
+
+template <typename F>
+void Game_Switches::ForEachWord(int begin, int end, F&& f) const {
+	if (begin >= end) {
+		return;
+	}
+
+	int first_word = begin / kWordBits;
+	int last_word = (end - 1) / kWordBits;
+	for (int w = first_word; w <= last_word; ++w) {
+		Word mask = ~Word(0);
+		if (w == first_word) {
+			mask &= ~Word(0) << (begin % kWordBits);
+		}
+		if (w == last_word) {
+			mask &= ~Word(0) >> (kWordBits - 1 - (end - 1) % kWordBits);
+		}
+		f(w, mask);
+	}
+}
+
 bool Game_Switches::Set(int switch_id, bool value) {
 	if (EP_UNLIKELY(ShouldWarn(switch_id, switch_id))) {
 		Output::Debug("Invalid write sw[{}] = {}!", switch_id, value);
@@ -34,11 +80,17 @@ bool Game_Switches::Set(int switch_id, bool value) {
 	if (switch_id <= 0) {
 		return false;
 	}
-	auto& ss = _switches;
-	if (switch_id > static_cast<int>(ss.size())) {
-		ss.resize(switch_id);
+	Resize(switch_id);
+	if (InterpreterTrace::IsActive()) {
+		InterpreterTrace::SwitchesChanged(switch_id, switch_id);
+	}
+	int idx = switch_id - 1;
+	Word bit = Word(1) << (idx % kWordBits);
+	if (value) {
+		_words[idx / kWordBits] |= bit;
+	} else {
+		_words[idx / kWordBits] &= ~bit;
 	}
-	ss[switch_id - 1] = value;
 	return value;
 }
 
@@ -47,13 +99,17 @@ void Game_Switches::SetRange(int first_id, int last_id, bool value) {
 		Output::Debug("Invalid write sw[{},{}] = {}!", first_id, last_id, value);
 		--_warnings;
 	}
-	auto& ss = _switches;
-	if (last_id > static_cast<int>(ss.size())) {
-		ss.resize(last_id, false);
-	}
-	for (int i = std::max(0, first_id - 1); i < last_id; ++i) {
-		ss[i] = value;
+	Resize(last_id);
+	if (InterpreterTrace::IsActive()) {
+		InterpreterTrace::SwitchesChanged(first_id, last_id);
 	}
+	ForEachWord(std::max(0, first_id - 1), last_id, [&](int w, Word mask) {
+		if (value) {
+			_words[w] |= mask;
+		} else {
+			_words[w] &= ~mask;
+		}
+	});
 }
 
 bool Game_Switches::Flip(int switch_id) {
@@ -64,12 +120,13 @@ bool Game_Switches::Flip(int switch_id) {
 	if (switch_id <= 0) {
 		return false;
 	}
-	auto& ss = _switches;
-	if (switch_id > static_cast<int>(ss.size())) {
-		ss.resize(switch_id);
+	Resize(switch_id);
+	if (InterpreterTrace::IsActive()) {
+		InterpreterTrace::SwitchesChanged(switch_id, switch_id);
 	}
-	ss[switch_id - 1].flip();
-	return ss[switch_id - 1];
+	int idx = switch_id - 1;
+	_words[idx / kWordBits] ^= Word(1) << (idx % kWordBits);
+	return (_words[idx / kWordBits] >> (idx % kWordBits)) & 1;
 }
 
 void Game_Switches::FlipRange(int first_id, int last_id) {
@@ -77,13 +134,13 @@ void Game_Switches::FlipRange(int first_id, int last_id) {
 		Output::Debug("Invalid flip sw[{},{}]!", first_id, last_id);
 		--_warnings;
 	}
-	auto& ss = _switches;
-	if (last_id > static_cast<int>(ss.size())) {
-		ss.resize(last_id);
-	}
-	for (int i = std::max(0, first_id - 1); i < last_id; ++i) {
-		ss[i].flip();
+	Resize(last_id);
+	if (InterpreterTrace::IsActive()) {
+		InterpreterTrace::SwitchesChanged(first_id, last_id);
 	}
+	ForEachWord(std::max(0, first_id - 1), last_id, [&](int w, Word mask) {
+		_words[w] ^= mask;
+	});
 }
 
 StringView Game_Switches::GetName(int _id) const {
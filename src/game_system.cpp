@@ -148,7 +148,7 @@ bool Game_System::BgmPlayedOnce() {
 }
 
 void Game_System::SePlay(const lcf::rpg::Sound& se, bool stop_sounds) {
-	if (se.name.empty()) {
+	if (se_muted || se.name.empty()) {
 		return;
 	} else if (se.name == "(OFF)") {
 		if (stop_sounds) {
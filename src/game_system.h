@@ -436,6 +436,16 @@ public:
 	/** @return Whether the game was loaded from a savegame in the current frame */
 	bool IsLoadedThisFrame() const;
 
+	/**
+	 * Ignores all SePlay calls, e.g. while battles are simulated.
+	 *
+	 * @param muted whether sound effects are ignored
+	 */
+	void SetSeMuted(bool muted);
+
+	/** @return Whether SePlay calls are ignored */
+	bool IsSeMuted() const;
+
 private:
 	std::string InelukiReadLink(Filesystem_Stream::InputStream& stream);
 
@@ -452,6 +462,7 @@ private:
 	std::map<std::string, FileRequestBinding> se_request_ids;
 	Color bg_color = Color{ 0, 0, 0, 255 };
 	bool bgm_pending = false;
+	bool se_muted = false;
 	int loaded_frame_count = 0;
 };
 
@@ -550,6 +561,14 @@ inline bool Game_System::IsLoadedThisFrame() const {
 	return loaded_frame_count + 1 == data.frame_count;
 }
 
+inline void Game_System::SetSeMuted(bool muted) {
+	se_muted = muted;
+}
+
+inline bool Game_System::IsSeMuted() const {
+	return se_muted;
+}
+
 inline Game_System::AtbMode Game_System::GetAtbMode() {
 	return static_cast<Game_System::AtbMode>(data.atb_mode);
 }
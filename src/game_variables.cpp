@@ -17,6 +17,7 @@
 
 // Headers
 #include "game_variables.h"
+#include "interpreter_trace.h"
 #include "output.h"
 #include <lcf/reader_util.h>
 #include <lcf/data.h>
@@ -155,6 +156,9 @@ Game_Variables::Var_t Game_Variables::SetOp(int variable_id, Var_t value, F&& op
 	if (EP_UNLIKELY(variable_id > static_cast<int>(_variables.size()))) {
 		_variables.resize(variable_id, 0);
 	}
+	if (InterpreterTrace::IsActive()) {
+		InterpreterTrace::VariablesChanged(variable_id, variable_id);
+	}
 	auto& v = _variables[variable_id - 1];
 	value = op(v, value);
 	v = Utils::Clamp(value, _min, _max);
@@ -171,6 +175,9 @@ void Game_Variables::PrepareRange(const int first_id, const int last_id, const c
 	if (EP_UNLIKELY(last_id > static_cast<int>(vv.size()))) {
 		vv.resize(last_id, 0);
 	}
+	if (InterpreterTrace::IsActive()) {
+		InterpreterTrace::VariablesChanged(first_id, last_id);
+	}
 }
 
 template <typename... Args>
@@ -187,25 +194,33 @@ void Game_Variables::PrepareArray(const int first_id_a, const int last_id_a, con
 	if (EP_UNLIKELY(last_id_b > static_cast<int>(vv.size()))) {
 		vv.resize(last_id_b, 0);
 	}
+	if (InterpreterTrace::IsActive()) {
+		InterpreterTrace::VariablesChanged(first_id_a, last_id_a);
+	}
 }
 
+// The limits are copied because writes through the data pointer could alias
+// them. Otherwise they are reloaded for every element.
 template <typename V, typename F>
 void Game_Variables::WriteRange(const int first_id, const int last_id, V&& value, F&& op) {
-	auto& vv = _variables;
+	Var_t* vv = _variables.data();
+	const Var_t minval = _min;
+	const Var_t maxval = _max;
 	for (int i = std::max(0, first_id - 1); i < last_id; ++i) {
-		auto& v = vv[i];
-		v = Utils::Clamp(op(v, value()), _min, _max);
+		vv[i] = Utils::Clamp(op(vv[i], value()), minval, maxval);
 	}
 }
 
 template <typename F>
 void Game_Variables::WriteArray(const int first_id_a, const int last_id_a, const int first_id_b, F&& op) {
-	auto& vv = _variables;
-	int out_b = std::max(0, first_id_b - 1);
-	for (int i = std::max(0, first_id_a - 1); i < last_id_a; ++i) {
-		auto& v_a = vv[i];
-		auto v_b = vv[out_b++];
-		v_a = Utils::Clamp(op(v_a, v_b), _min, _max);
+	Var_t* vv_a = _variables.data() + std::max(0, first_id_a - 1);
+	const Var_t* vv_b = _variables.data() + std::max(0, first_id_b - 1);
+	const Var_t minval = _min;
+	const Var_t maxval = _max;
+	const int steps = last_id_a - std::max(0, first_id_a - 1);
+	// Overlapping arrays are processed element by element in order
+	for (int i = 0; i < steps; ++i) {
+		vv_a[i] = Utils::Clamp(op(vv_a[i], vv_b[i]), minval, maxval);
 	}
 }
 
@@ -587,6 +602,9 @@ void Game_Variables::BitShiftRightArray(int first_id_a, int last_id_a, int first
 
 void Game_Variables::SwapArray(int first_id_a, int last_id_a, int first_id_b) {
 	PrepareArray(first_id_a, last_id_a, first_id_b, "Invalid write var[{},{}] <-> var[{},{}]!");
+	if (InterpreterTrace::IsActive()) {
+		InterpreterTrace::VariablesChanged(first_id_b, first_id_b + last_id_a - first_id_a);
+	}
 	auto& vv = _variables;
 	const int steps = std::max(0, last_id_a - first_id_a + 1);
 	int out_b = std::max(0, first_id_b + steps - 2);
@@ -21,6 +21,7 @@
 #include "main_data.h"
 #include "game_system.h"
 #include "game_map.h"
+#include "game_pathfinder.h"
 #include "game_player.h"
 #include "game_vehicle.h"
 #include "output.h"
@@ -78,6 +79,12 @@ void Game_Vehicle::SetSaveData(lcf::rpg::SaveVehicleLocation save) {
 	SanitizeData(TypeNames[type]);
 }
 
+lcf::rpg::SaveVehicleLocation Game_Vehicle::GetSaveData() const {
+	auto save = *data();
+	Game_Pathfinder::EncodeMoveRoute(save.move_route);
+	return save;
+}
+
 bool Game_Vehicle::IsInCurrentMap() const {
 	return GetMapId() == Game_Map::GetMapId();
 }
@@ -99,10 +99,6 @@ inline void Game_Vehicle::SetOrigSpriteGraphic(std::string sprite_name, int inde
 	data()->orig_sprite_id = index;
 }
 
-inline lcf::rpg::SaveVehicleLocation Game_Vehicle::GetSaveData() const {
-	return *data();
-}
-
 inline bool Game_Vehicle::IsInPosition(int x, int y) const {
 	return IsInCurrentMap() && Game_Character::IsInPosition(x, y);
 }
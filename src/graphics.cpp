@@ -30,6 +30,8 @@
 #include "drawable_mgr.h"
 #include "baseui.h"
 #include "game_clock.h"
+#include "instrumentation.h"
+#include "input.h"
 
 using namespace std::chrono_literals;
 
@@ -63,7 +65,9 @@ void Graphics::Quit() {
 }
 
 void Graphics::Update() {
+	Instrumentation::UpdateAudioStats();
 	fps_overlay->SetDrawFps(DisplayUi->RenderFps());
+	fps_overlay->SetDrawAudio(Input::IsSystemPressed(Input::SHOW_AUDIO_STATS));
 
 	//Update Graphics:
 	if (fps_overlay->Update()) {
@@ -188,6 +188,11 @@ bool ImageBMP::Read(const uint8_t* data, unsigned len, bool transparent, ImageOu
 }
 
 bool ImageBMP::Read(Filesystem_Stream::InputStream& stream, bool transparent, ImageOut& output) {
+	auto data = stream.GetData();
+	if (!data.empty()) {
+		return Read(data.data(), (unsigned) data.size(), transparent, output);
+	}
+
 	std::vector<uint8_t> buffer = Utils::ReadStream(stream);
 	return Read(&buffer.front(), (unsigned) buffer.size(), transparent, output);
 }
@@ -39,6 +39,15 @@ static void read_data_istream(png_structp png_ptr, png_bytep data, png_size_t le
 	}
 }
 
+static void read_data_span(png_structp png_ptr, png_bytep data, png_size_t length) {
+	auto* bufp = reinterpret_cast<Span<const uint8_t>*>(png_get_io_ptr(png_ptr));
+	if (length > bufp->size()) {
+		png_error(png_ptr, "Read beyond end of data");
+	}
+	memcpy(data, bufp->data(), length);
+	*bufp = bufp->subspan(length);
+}
+
 static void on_png_warning(png_structp, png_const_charp warn_msg) {
 	Output::Debug("libpng: {}", warn_msg);
 }
@@ -59,6 +68,12 @@ bool ImagePNG::Read(const void* buffer, bool transparent, ImageOut& output) {
 }
 
 bool ImagePNG::Read(Filesystem_Stream::InputStream& stream, bool transparent, ImageOut& output) {
+	auto data = stream.GetData();
+	if (!data.empty()) {
+		// Memory backed streams are decoded without copying through the stream buffer
+		return ReadPNGWithReadFunction(&data, read_data_span, transparent, output);
+	}
+
 	return ReadPNGWithReadFunction(&stream, read_data_istream, transparent, output);
 }
 
@@ -85,6 +85,7 @@ namespace Input {
 		FAST_FORWARD_B,
 		TOGGLE_FULLSCREEN,
 		TOGGLE_ZOOM,
+		SHOW_AUDIO_STATS,
 		BUTTON_COUNT
 	};
 
@@ -131,6 +132,7 @@ namespace Input {
 		"FAST_FORWARD_B",
 		"TOGGLE_FULLSCREEN",
 		"TOGGLE_ZOOM",
+		"SHOW_AUDIO_STATS",
 		"BUTTON_COUNT");
 
 	constexpr auto kInputButtonHelp = lcf::makeEnumTags<InputButton>(
@@ -176,6 +178,7 @@ namespace Input {
 		"Run the game at x{} speed",
 		"Toggle Fullscreen mode",
 		"Toggle Window Zoom level",
+		"Show the audio mixer statistics while held",
 		"Total Button Count");
 
 	/**
@@ -191,6 +194,7 @@ namespace Input {
 			case TOGGLE_ZOOM:
 			case FAST_FORWARD_A:
 			case FAST_FORWARD_B:
+			case SHOW_AUDIO_STATS:
 				return true;
 			default:
 				return false;
@@ -96,6 +96,7 @@ Input::ButtonMappingArray Input::GetDefaultButtonMappings() {
 		{SHOW_LOG, Keys::F3},
 		{TOGGLE_FULLSCREEN, Keys::F4},
 		{TOGGLE_ZOOM, Keys::F5},
+		{SHOW_AUDIO_STATS, Keys::F6},
 		{PAGE_UP, Keys::PGUP},
 		{PAGE_DOWN, Keys::PGDN},
 		{RESET, Keys::F12},
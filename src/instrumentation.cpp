@@ -15,7 +15,11 @@
  * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
+#include <algorithm>
 #include "instrumentation.h"
+#include "filefinder.h"
+#include "output.h"
 #include "utils.h"
 
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
@@ -34,3 +38,143 @@ void Instrumentation::Init(const char* name) {
 	(void)name;
 #endif
 }
+
+namespace {
+	using namespace std::chrono_literals;
+
+	constexpr auto audio_stats_interval = 1s;
+
+	// Written by the audio thread, collected by the main thread
+	std::atomic<int> audio_callbacks;
+	std::atomic<int> audio_buffer_frames;
+	std::atomic<int> audio_frequency;
+	std::atomic<int64_t> audio_decode_sum;
+	std::atomic<int64_t> audio_decode_max;
+	std::atomic<int> audio_underruns;
+	std::atomic<int> audio_se_peak;
+	std::atomic<int> audio_se_capacity;
+	std::atomic<int> audio_se_dropped;
+	std::array<std::atomic<int64_t>, Instrumentation::max_audio_channels> audio_channel_time;
+
+	// Only accessed by the audio thread
+	Game_Clock::time_point audio_last_callback;
+
+	// Only accessed by the main thread
+	Instrumentation::AudioStats audio_stats;
+	Game_Clock::time_point audio_stats_time;
+	Game_Clock::time_point audio_stats_start;
+	Filesystem_Stream::OutputStream audio_stats_out;
+
+	template <typename T>
+	void AtomicMax(std::atomic<T>& a, T value) {
+		T prev = a.load(std::memory_order_relaxed);
+		while (prev < value && !a.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {}
+	}
+
+	std::chrono::microseconds ToUs(int64_t ns) {
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(ns));
+	}
+}
+
+void Instrumentation::AudioCallback(Game_Clock::time_point begin, Game_Clock::time_point end, int buffer_frames, int frequency) {
+	auto decode_time = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin);
+	auto buffer_time = std::chrono::nanoseconds(1'000'000'000LL * buffer_frames / std::max(frequency, 1));
+
+	audio_callbacks.fetch_add(1, std::memory_order_relaxed);
+	audio_buffer_frames.store(buffer_frames, std::memory_order_relaxed);
+	audio_frequency.store(frequency, std::memory_order_relaxed);
+	audio_decode_sum.fetch_add(decode_time.count(), std::memory_order_relaxed);
+	AtomicMax<int64_t>(audio_decode_max, decode_time.count());
+
+	// Gaps of more than 10 buffers are pauses of the audio device and not an underrun
+	auto gap = begin - audio_last_callback;
+	bool late = audio_last_callback.time_since_epoch().count() != 0 && gap > 2 * buffer_time && gap < 10 * buffer_time;
+	if (decode_time > buffer_time || late) {
+		audio_underruns.fetch_add(1, std::memory_order_relaxed);
+	}
+	audio_last_callback = begin;
+}
+
+void Instrumentation::AudioChannelDecoded(int channel, Game_Clock::duration decode_time) {
+	if (channel < 0 || channel >= max_audio_channels) {
+		return;
+	}
+	audio_channel_time[channel].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(decode_time).count(), std::memory_order_relaxed);
+}
+
+void Instrumentation::AudioSeChannels(int active, int capacity) {
+	AtomicMax(audio_se_peak, active);
+	audio_se_capacity.store(capacity, std::memory_order_relaxed);
+}
+
+void Instrumentation::AudioSeDropped() {
+	audio_se_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Instrumentation::UpdateAudioStats() {
+	auto now = Game_Clock::now();
+	if (now - audio_stats_time < audio_stats_interval) {
+		return;
+	}
+	audio_stats_time = now;
+
+	AudioStats stats;
+	stats.callbacks = audio_callbacks.exchange(0, std::memory_order_relaxed);
+	stats.buffer_frames = audio_buffer_frames.load(std::memory_order_relaxed);
+	int frequency = audio_frequency.load(std::memory_order_relaxed);
+	if (frequency > 0) {
+		stats.buffer_time = std::chrono::microseconds(1'000'000LL * stats.buffer_frames / frequency);
+	}
+	int64_t decode_sum = audio_decode_sum.exchange(0, std::memory_order_relaxed);
+	if (stats.callbacks > 0) {
+		stats.decode_time_avg = ToUs(decode_sum / stats.callbacks);
+	}
+	stats.decode_time_max = ToUs(audio_decode_max.exchange(0, std::memory_order_relaxed));
+	stats.underruns = audio_underruns.exchange(0, std::memory_order_relaxed);
+	stats.underruns_total = audio_stats.underruns_total + stats.underruns;
+	stats.se_channels_peak = audio_se_peak.exchange(0, std::memory_order_relaxed);
+	stats.se_channels_capacity = audio_se_capacity.load(std::memory_order_relaxed);
+	stats.se_dropped = audio_se_dropped.exchange(0, std::memory_order_relaxed);
+	for (int i = 0; i < max_audio_channels; ++i) {
+		stats.channel_time[i] = ToUs(audio_channel_time[i].exchange(0, std::memory_order_relaxed));
+	}
+	audio_stats = stats;
+
+	if (audio_stats_out) {
+		auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - audio_stats_start).count();
+		audio_stats_out << fmt::format("{},{},{},{},{},{},{},{},{},{},",
+			ms, stats.callbacks, stats.buffer_frames, stats.buffer_time.count(),
+			stats.decode_time_avg.count(), stats.decode_time_max.count(), stats.underruns,
+			stats.se_channels_peak, stats.se_channels_capacity, stats.se_dropped);
+		// Decoding time of the channels that were active, as "channel:us" pairs
+		bool first = true;
+		for (int i = 0; i < max_audio_channels; ++i) {
+			if (stats.channel_time[i].count() > 0) {
+				audio_stats_out << fmt::format("{}{}:{}", first ? "" : " ", i, stats.channel_time[i].count());
+				first = false;
+			}
+		}
+		audio_stats_out << "\n";
+	}
+}
+
+const Instrumentation::AudioStats& Instrumentation::GetAudioStats() {
+	return audio_stats;
+}
+
+bool Instrumentation::SetAudioStatsOutput(StringView path) {
+	audio_stats_out.Close();
+	if (path.empty()) {
+		return false;
+	}
+
+	audio_stats_out = FileFinder::Root().OpenOutputStream(path);
+	if (!audio_stats_out) {
+		Output::Warning("Failed to open audio stats file {} for writing", path);
+		return false;
+	}
+
+	audio_stats_start = Game_Clock::now();
+	audio_stats_out << "time_ms,callbacks,buffer_frames,buffer_us,decode_avg_us,decode_max_us,underruns,se_peak,se_capacity,se_dropped,channel_us\n";
+	return true;
+}
@@ -25,7 +25,11 @@
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 #include <ittnotify.h>
 #endif
+#include <array>
 #include <cassert>
+#include <chrono>
+#include "game_clock.h"
+#include "string_view.h"
 
 class Instrumentation {
 public:
@@ -73,6 +77,83 @@ public:
 		bool begun = false;
 	};
 
+	/** Maximum number of mixer channels tracked by the audio telemetry */
+	static constexpr int max_audio_channels = 64;
+
+	/** Audio mixer telemetry of the last sampling interval (one second) */
+	struct AudioStats {
+		/** Number of mixer callbacks */
+		int callbacks = 0;
+		/** Frames per output buffer */
+		int buffer_frames = 0;
+		/** Playback duration of one output buffer */
+		std::chrono::microseconds buffer_time = {};
+		/** Average time spent mixing one buffer */
+		std::chrono::microseconds decode_time_avg = {};
+		/** Longest time spent mixing one buffer */
+		std::chrono::microseconds decode_time_max = {};
+		/** Underruns during the interval */
+		int underruns = 0;
+		/** Underruns since startup */
+		int underruns_total = 0;
+		/** Maximum number of sound effects playing at once */
+		int se_channels_peak = 0;
+		/** Number of sound effect channels */
+		int se_channels_capacity = 0;
+		/** Sound effects not played or cut off because all channels were busy */
+		int se_dropped = 0;
+		/** Decoding time spent per mixer channel */
+		std::array<std::chrono::microseconds, max_audio_channels> channel_time = {};
+	};
+
+	/**
+	 * Called by the audio mixer after an output buffer was mixed.
+	 * An underrun is counted when mixing took longer than the buffer plays
+	 * or when the callback came late.
+	 *
+	 * @param begin time when mixing started
+	 * @param end time when mixing finished
+	 * @param buffer_frames frames in the output buffer
+	 * @param frequency output frequency
+	 */
+	static void AudioCallback(Game_Clock::time_point begin, Game_Clock::time_point end, int buffer_frames, int frequency);
+
+	/**
+	 * Called by the audio mixer after a channel was decoded.
+	 *
+	 * @param channel channel id, the BGM channels followed by the SE voices
+	 * @param decode_time time spent decoding
+	 */
+	static void AudioChannelDecoded(int channel, Game_Clock::duration decode_time);
+
+	/**
+	 * Called by the audio mixer with the sound effect channel usage.
+	 *
+	 * @param active sound effect channels that are playing
+	 * @param capacity number of sound effect channels
+	 */
+	static void AudioSeChannels(int active, int capacity);
+
+	/** Called when a sound effect was dropped or cut off because all channels were busy */
+	static void AudioSeDropped();
+
+	/**
+	 * Collects the audio telemetry once per second.
+	 * Must be called from the main thread on every frame.
+	 */
+	static void UpdateAudioStats();
+
+	/** @return audio telemetry of the last sampling interval */
+	static const AudioStats& GetAudioStats();
+
+	/**
+	 * Writes the audio telemetry as CSV, one row per second, to a file.
+	 *
+	 * @param path file to write to, an empty path closes the file
+	 * @return whether the file was opened
+	 */
+	static bool SetAudioStatsOutput(StringView path);
+
 private:
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 	static __itt_domain* domain;
@@ -0,0 +1,509 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "interpreter_trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include "system.h"
+#include "filefinder.h"
+#include "filesystem_stream.h"
+#include "output.h"
+#include "player.h"
+
+#ifdef USE_THREADS
+#  include <chrono>
+#  include <condition_variable>
+#  include <mutex>
+#  include <thread>
+#endif
+
+bool InterpreterTrace::detail::active = false;
+
+namespace {
+	constexpr char trace_magic[] = "EPTRACE";
+	constexpr int trace_version = 1;
+
+	/** Must be a power of two */
+	constexpr size_t buffer_size = 1 << 20;
+
+	void EncodeInt(uint32_t value, std::vector<uint8_t>& out) {
+		int shift = 28;
+		while (shift > 0 && (value >> shift) == 0) {
+			shift -= 7;
+		}
+		for (; shift > 0; shift -= 7) {
+			out.push_back(static_cast<uint8_t>(((value >> shift) & 0x7F) | 0x80));
+		}
+		out.push_back(static_cast<uint8_t>(value & 0x7F));
+	}
+
+	void EncodeRanges(const std::vector<InterpreterTrace::Range>& ranges, std::vector<uint8_t>& out) {
+		EncodeInt(static_cast<uint32_t>(ranges.size()), out);
+		for (auto& range: ranges) {
+			EncodeInt(static_cast<uint32_t>(range.first), out);
+			EncodeInt(static_cast<uint32_t>(range.last - range.first), out);
+		}
+	}
+
+	bool DecodeInt(std::istream& is, int& value) {
+		uint32_t v = 0;
+		for (int i = 0; i < 5; ++i) {
+			int c = is.get();
+			if (c == EOF) {
+				return false;
+			}
+			v = (v << 7) | (c & 0x7F);
+			if ((c & 0x80) == 0) {
+				value = static_cast<int32_t>(v);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool DecodeRanges(std::istream& is, std::vector<InterpreterTrace::Range>& ranges) {
+		int count;
+		if (!DecodeInt(is, count) || count < 0) {
+			return false;
+		}
+		ranges.resize(count);
+		for (auto& range: ranges) {
+			int len;
+			if (!DecodeInt(is, range.first) || !DecodeInt(is, len)) {
+				return false;
+			}
+			range.last = range.first + len;
+		}
+		return true;
+	}
+
+	/**
+	 * Lock-free byte queue with one producer (main thread) and one
+	 * consumer (writer thread).
+	 */
+	class RingBuffer {
+	public:
+		RingBuffer() : data(buffer_size) {}
+
+		/** @return whether the data fit into the buffer */
+		bool Push(const uint8_t* src, size_t len) {
+			size_t h = head.load(std::memory_order_relaxed);
+			size_t t = tail.load(std::memory_order_acquire);
+			if (buffer_size - (h - t) < len) {
+				return false;
+			}
+			size_t pos = h & (buffer_size - 1);
+			size_t first = std::min(len, buffer_size - pos);
+			std::memcpy(&data[pos], src, first);
+			std::memcpy(&data[0], src + first, len - first);
+			head.store(h + len, std::memory_order_release);
+			return true;
+		}
+
+		/** Writes everything in the buffer to os */
+		void PopTo(std::ostream& os) {
+			size_t t = tail.load(std::memory_order_relaxed);
+			size_t h = head.load(std::memory_order_acquire);
+			while (t != h) {
+				size_t pos = t & (buffer_size - 1);
+				size_t len = std::min(h - t, buffer_size - pos);
+				os.write(reinterpret_cast<const char*>(&data[pos]), len);
+				t += len;
+			}
+			tail.store(t, std::memory_order_release);
+		}
+
+		size_t Size() const {
+			return head.load(std::memory_order_relaxed) - tail.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::vector<uint8_t> data;
+		std::atomic<size_t> head = { 0 };
+		std::atomic<size_t> tail = { 0 };
+	};
+
+	struct Recorder {
+		Filesystem_Stream::OutputStream out;
+		RingBuffer buffer;
+#ifdef USE_THREADS
+		std::thread writer;
+		std::mutex mutex;
+		std::condition_variable cv;
+		bool stop = false;
+		std::atomic<bool> wake = { false };
+#endif
+
+		// Only accessed by the main thread
+		InterpreterTrace::Record pending;
+		bool in_command = false;
+		int prev_frame = 0;
+		std::vector<uint8_t> encoded;
+
+		void Write(const std::vector<uint8_t>& bytes);
+		void Flush();
+#ifdef USE_THREADS
+		void WriterThread();
+#endif
+	};
+
+	std::unique_ptr<Recorder> recorder;
+
+	void AddRange(std::vector<InterpreterTrace::Range>& ranges, int first_id, int last_id) {
+		first_id = std::max(first_id, 1);
+		if (last_id < first_id) {
+			return;
+		}
+		// Commands often write the same or adjacent ids repeatedly
+		if (!ranges.empty() && first_id <= ranges.back().last + 1 && last_id >= ranges.back().first - 1) {
+			ranges.back().first = std::min(ranges.back().first, first_id);
+			ranges.back().last = std::max(ranges.back().last, last_id);
+			return;
+		}
+		ranges.push_back({ first_id, last_id });
+	}
+}
+
+void Recorder::Write(const std::vector<uint8_t>& bytes) {
+#ifdef USE_THREADS
+	if (buffer.Size() + bytes.size() > buffer_size / 2 && !wake.exchange(true)) {
+		cv.notify_one();
+	}
+	while (!buffer.Push(bytes.data(), bytes.size())) {
+		// Records must not be lost, wait for the writer
+		cv.notify_one();
+		std::this_thread::yield();
+	}
+#else
+	if (!buffer.Push(bytes.data(), bytes.size())) {
+		buffer.PopTo(out);
+		buffer.Push(bytes.data(), bytes.size());
+	}
+#endif
+}
+
+void Recorder::Flush() {
+#ifdef USE_THREADS
+	if (writer.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+		}
+		cv.notify_one();
+		writer.join();
+	}
+#endif
+	buffer.PopTo(out);
+	out.flush();
+}
+
+#ifdef USE_THREADS
+void Recorder::WriterThread() {
+	using namespace std::chrono_literals;
+
+	for (;;) {
+		bool done;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cv.wait_for(lock, 100ms, [this]() { return stop || wake.load(); });
+			done = stop;
+		}
+		wake = false;
+		buffer.PopTo(out);
+		if (done) {
+			break;
+		}
+	}
+}
+#endif
+
+bool InterpreterTrace::Record::operator==(const Record& o) const {
+	return frame == o.frame && interpreter_id == o.interpreter_id && event_id == o.event_id
+		&& index == o.index && code == o.code && switches == o.switches && variables == o.variables;
+}
+
+bool InterpreterTrace::Start(StringView path) {
+	Stop();
+
+	auto out = FileFinder::Root().OpenOutputStream(path);
+	if (!out) {
+		Output::Warning("Failed to open interpreter trace file {} for writing", path);
+		return false;
+	}
+
+	recorder = std::make_unique<Recorder>();
+	recorder->out = std::move(out);
+
+	std::vector<uint8_t> header;
+	EncodeHeader(header);
+	recorder->out.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+#ifdef USE_THREADS
+	recorder->writer = std::thread(&Recorder::WriterThread, recorder.get());
+#endif
+
+	detail::active = true;
+	return true;
+}
+
+void InterpreterTrace::Stop() {
+	if (!recorder) {
+		return;
+	}
+
+	if (recorder->in_command) {
+		CommandEnd();
+	}
+
+	detail::active = false;
+	recorder->Flush();
+	recorder.reset();
+}
+
+void InterpreterTrace::CommandBegin(int interpreter_id, int event_id, int index, int code) {
+	if (!recorder) {
+		return;
+	}
+
+	// A command that runs the interpreter again
+	if (recorder->in_command) {
+		CommandEnd();
+	}
+
+	auto& rec = recorder->pending;
+	rec.frame = Player::GetFrames();
+	rec.interpreter_id = interpreter_id;
+	rec.event_id = event_id;
+	rec.index = index;
+	rec.code = code;
+	rec.switches.clear();
+	rec.variables.clear();
+	recorder->in_command = true;
+}
+
+void InterpreterTrace::CommandEnd() {
+	if (!recorder || !recorder->in_command) {
+		return;
+	}
+
+	auto& rec = recorder->pending;
+	recorder->encoded.clear();
+	EncodeRecord(rec, recorder->prev_frame, recorder->encoded);
+	recorder->prev_frame = rec.frame;
+	recorder->in_command = false;
+	recorder->Write(recorder->encoded);
+}
+
+void InterpreterTrace::SwitchesChanged(int first_id, int last_id) {
+	if (recorder && recorder->in_command) {
+		AddRange(recorder->pending.switches, first_id, last_id);
+	}
+}
+
+void InterpreterTrace::VariablesChanged(int first_id, int last_id) {
+	if (recorder && recorder->in_command) {
+		AddRange(recorder->pending.variables, first_id, last_id);
+	}
+}
+
+void InterpreterTrace::EncodeHeader(std::vector<uint8_t>& out) {
+	out.insert(out.end(), std::begin(trace_magic), std::end(trace_magic) - 1);
+	EncodeInt(trace_version, out);
+}
+
+void InterpreterTrace::EncodeRecord(const Record& rec, int prev_frame, std::vector<uint8_t>& out) {
+	EncodeInt(static_cast<uint32_t>(rec.frame - prev_frame), out);
+	EncodeInt(static_cast<uint32_t>(rec.interpreter_id), out);
+	EncodeInt(static_cast<uint32_t>(rec.event_id), out);
+	EncodeInt(static_cast<uint32_t>(rec.index), out);
+	EncodeInt(static_cast<uint32_t>(rec.code), out);
+	EncodeRanges(rec.switches, out);
+	EncodeRanges(rec.variables, out);
+}
+
+InterpreterTrace::Reader::Reader(std::istream& is) : is(is) {
+	char magic[sizeof(trace_magic) - 1];
+	int version;
+	valid = is.read(magic, sizeof(magic)) && std::memcmp(magic, trace_magic, sizeof(magic)) == 0
+		&& DecodeInt(is, version) && version == trace_version;
+}
+
+bool InterpreterTrace::Reader::IsValid() const {
+	return valid;
+}
+
+bool InterpreterTrace::Reader::Next(Record& rec) {
+	if (!valid) {
+		return false;
+	}
+
+	int frame_diff;
+	if (!DecodeInt(is, frame_diff)) {
+		// End of the trace
+		return false;
+	}
+
+	if (!DecodeInt(is, rec.interpreter_id) || !DecodeInt(is, rec.event_id) || !DecodeInt(is, rec.index)
+			|| !DecodeInt(is, rec.code) || !DecodeRanges(is, rec.switches) || !DecodeRanges(is, rec.variables)) {
+		valid = false;
+		return false;
+	}
+
+	frame += frame_diff;
+	rec.frame = frame;
+	return true;
+}
+
+std::string InterpreterTrace::Format(const Record& rec) {
+	auto format_ranges = [](const std::vector<Range>& ranges) {
+		std::string s;
+		for (auto& range: ranges) {
+			if (!s.empty()) {
+				s += ',';
+			}
+			s += std::to_string(range.first);
+			if (range.last != range.first) {
+				s += '-';
+				s += std::to_string(range.last);
+			}
+		}
+		return s;
+	};
+
+	std::string s = fmt::format("frame={} interpreter={} event={} index={} code={}",
+		rec.frame, rec.interpreter_id, rec.event_id, rec.index, rec.code);
+	if (!rec.switches.empty()) {
+		s += " switches=" + format_ranges(rec.switches);
+	}
+	if (!rec.variables.empty()) {
+		s += " variables=" + format_ranges(rec.variables);
+	}
+	return s;
+}
+
+int InterpreterTrace::Decode(StringView path) {
+	auto is = FileFinder::Root().OpenInputStream(path);
+	if (!is) {
+		std::cerr << "Cannot open " << path << std::endl;
+		return 2;
+	}
+
+	Reader reader(is);
+	if (!reader.IsValid()) {
+		std::cerr << path << " is not an interpreter trace" << std::endl;
+		return 2;
+	}
+
+	Record rec;
+	while (reader.Next(rec)) {
+		std::cout << Format(rec) << '\n';
+	}
+
+	if (!reader.IsValid()) {
+		std::cerr << path << " is truncated" << std::endl;
+		return 2;
+	}
+	return 0;
+}
+
+namespace {
+	/** Number of records before the first difference printed by Diff */
+	constexpr size_t diff_context = 10;
+
+	enum class DiffResult {
+		Identical,
+		Different,
+		Invalid
+	};
+
+	DiffResult FindDifference(InterpreterTrace::Reader& a, InterpreterTrace::Reader& b, int& index,
+			std::deque<InterpreterTrace::Record>* context, InterpreterTrace::Record& rec_a, InterpreterTrace::Record& rec_b,
+			bool& has_a, bool& has_b) {
+		if (!a.IsValid() || !b.IsValid()) {
+			return DiffResult::Invalid;
+		}
+
+		for (index = 0;; ++index) {
+			has_a = a.Next(rec_a);
+			has_b = b.Next(rec_b);
+			if (!a.IsValid() || !b.IsValid()) {
+				return DiffResult::Invalid;
+			}
+			if (!has_a && !has_b) {
+				return DiffResult::Identical;
+			}
+			if (has_a != has_b || rec_a != rec_b) {
+				return DiffResult::Different;
+			}
+			if (context) {
+				if (context->size() == diff_context) {
+					context->pop_front();
+				}
+				context->push_back(rec_a);
+			}
+		}
+	}
+}
+
+bool InterpreterTrace::Compare(std::istream& a, std::istream& b, int& index) {
+	Reader reader_a(a);
+	Reader reader_b(b);
+	Record rec_a, rec_b;
+	bool has_a, has_b;
+	index = 0;
+	return FindDifference(reader_a, reader_b, index, nullptr, rec_a, rec_b, has_a, has_b) == DiffResult::Identical;
+}
+
+int InterpreterTrace::Diff(StringView path_a, StringView path_b) {
+	auto is_a = FileFinder::Root().OpenInputStream(path_a);
+	auto is_b = FileFinder::Root().OpenInputStream(path_b);
+	if (!is_a || !is_b) {
+		std::cerr << "Cannot open " << (is_a ? path_b : path_a) << std::endl;
+		return 2;
+	}
+
+	Reader a(is_a);
+	Reader b(is_b);
+	std::deque<Record> context;
+	Record rec_a, rec_b;
+	bool has_a, has_b;
+	int index = 0;
+
+	switch (FindDifference(a, b, index, &context, rec_a, rec_b, has_a, has_b)) {
+		case DiffResult::Identical:
+			std::cout << "Traces are identical (" << index << " commands)" << std::endl;
+			return 0;
+		case DiffResult::Invalid:
+			std::cerr << "Invalid or truncated trace after " << index << " commands" << std::endl;
+			return 2;
+		case DiffResult::Different:
+			break;
+	}
+
+	std::cout << "Traces differ at command " << index << '\n';
+	for (auto& rec: context) {
+		std::cout << "  " << Format(rec) << '\n';
+	}
+	std::cout << "- " << (has_a ? Format(rec_a) : "(end of trace)") << '\n';
+	std::cout << "+ " << (has_b ? Format(rec_b) : "(end of trace)") << std::endl;
+	return 1;
+}
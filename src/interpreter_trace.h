@@ -0,0 +1,194 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_INTERPRETER_TRACE_H
+#define EP_INTERPRETER_TRACE_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "compiler.h"
+#include "string_view.h"
+
+/**
+ * Records every event command executed by the interpreters to a compact
+ * binary file. Used to find where two runs (e.g. of --replay-input) diverge.
+ *
+ * The file starts with a header followed by one record per executed command.
+ * All numbers are stored as variable length integers (7 bit per byte, most
+ * significant group first). A record contains the frame (as difference to the
+ * previous record), interpreter id, event id, command index, command code and
+ * the ranges of switches and variables written by the command.
+ *
+ * Records are encoded on the main thread into a lock-free ring buffer that is
+ * written to the file by a background thread.
+ */
+namespace InterpreterTrace {
+
+/** Ids first to last (inclusive) were written */
+struct Range {
+	int first = 0;
+	int last = 0;
+
+	bool operator==(const Range& o) const { return first == o.first && last == o.last; }
+	bool operator!=(const Range& o) const { return !(*this == o); }
+};
+
+/** One executed event command */
+struct Record {
+	int frame = 0;
+	/** Interpreters are numbered in creation order */
+	int interpreter_id = 0;
+	int event_id = 0;
+	/** Index of the command in the event page */
+	int index = 0;
+	int code = 0;
+	std::vector<Range> switches;
+	std::vector<Range> variables;
+
+	bool operator==(const Record& o) const;
+	bool operator!=(const Record& o) const { return !(*this == o); }
+};
+
+/**
+ * Starts recording to a file. A running recording is stopped first.
+ *
+ * @param path file to write to
+ * @return whether the file was opened
+ */
+bool Start(StringView path);
+
+/** Writes all pending records and closes the file */
+void Stop();
+
+/** @return whether a trace is recorded */
+bool IsActive();
+
+/**
+ * Called by the interpreter before a command executes.
+ *
+ * @param interpreter_id id of the interpreter
+ * @param event_id event the command belongs to
+ * @param index index of the command
+ * @param code command code
+ */
+void CommandBegin(int interpreter_id, int event_id, int index, int code);
+
+/** Called by the interpreter after a command executed */
+void CommandEnd();
+
+/**
+ * Called when switches first to last are written.
+ * Only writes while a command executes are recorded.
+ */
+void SwitchesChanged(int first_id, int last_id);
+
+/**
+ * Called when variables first to last are written.
+ * Only writes while a command executes are recorded.
+ */
+void VariablesChanged(int first_id, int last_id);
+
+/**
+ * Appends the file header to out.
+ *
+ * @param out buffer to append to
+ */
+void EncodeHeader(std::vector<uint8_t>& out);
+
+/**
+ * Appends a record to out.
+ *
+ * @param rec record to encode
+ * @param prev_frame frame of the previous record (0 for the first)
+ * @param out buffer to append to
+ */
+void EncodeRecord(const Record& rec, int prev_frame, std::vector<uint8_t>& out);
+
+/** Decodes a trace file record by record */
+class Reader {
+public:
+	/**
+	 * Reads the header.
+	 *
+	 * @param is stream to read from
+	 */
+	explicit Reader(std::istream& is);
+
+	/** @return whether the header is valid and no read error occurred */
+	bool IsValid() const;
+
+	/**
+	 * Reads the next record.
+	 *
+	 * @param rec filled with the record
+	 * @return false at the end of the trace or on error
+	 */
+	bool Next(Record& rec);
+
+private:
+	std::istream& is;
+	int frame = 0;
+	bool valid = false;
+};
+
+/**
+ * @param rec record to format
+ * @return one line description of the record
+ */
+std::string Format(const Record& rec);
+
+/**
+ * Prints all records of a trace file to stdout.
+ *
+ * @param path trace file
+ * @return process exit code
+ */
+int Decode(StringView path);
+
+/**
+ * Compares two trace streams.
+ *
+ * @param a first trace
+ * @param b second trace
+ * @param index set to the number of identical records
+ * @return whether both traces are identical
+ */
+bool Compare(std::istream& a, std::istream& b, int& index);
+
+/**
+ * Prints the first difference of two trace files with the records leading
+ * to it to stdout.
+ *
+ * @param path_a first trace file
+ * @param path_b second trace file
+ * @return process exit code: 0 when identical, 1 when different, 2 on error
+ */
+int Diff(StringView path_a, StringView path_b);
+
+namespace detail {
+	extern bool active;
+}
+
+} // namespace InterpreterTrace
+
+inline bool InterpreterTrace::IsActive() {
+	return EP_UNLIKELY(detail::active);
+}
+
+#endif
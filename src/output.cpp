@@ -22,6 +22,7 @@
 #include <cstdio>
 #include <iostream>
 #include <fstream>
+#include <mutex>
 #include <thread>
 #include <chrono>
 #include <fmt/color.h>
@@ -112,6 +113,20 @@ namespace {
 
 	LogCallbackFn log_cb = LogCallback;
 	LogCallbackUserData log_cb_udata = nullptr;
+
+	// Unset until Player::Init, all messages are written immediately before
+	std::thread::id main_thread_id;
+	std::mutex thread_messages_mutex;
+	std::vector<std::pair<LogLevel, std::string>> thread_messages;
+
+	bool DeferThreadMessage(LogLevel lvl, std::string const& msg) {
+		if (main_thread_id == std::thread::id() || std::this_thread::get_id() == main_thread_id) {
+			return false;
+		}
+		std::lock_guard<std::mutex> lock(thread_messages_mutex);
+		thread_messages.emplace_back(lvl, msg);
+		return true;
+	}
 }
 
 std::string Output::LogLevelToString(LogLevel lvl) {
@@ -134,6 +149,10 @@ void Output::IgnorePause(bool const val) {
 	ignore_pause = val;
 }
 
+void Output::SetMainThread() {
+	main_thread_id = std::this_thread::get_id();
+}
+
 void Output::SetLogCallback(LogCallbackFn fn, LogCallbackUserData userdata) {
 	log_cb = fn;
 	log_cb_udata = userdata;
@@ -195,6 +214,20 @@ static void WriteLog(LogLevel lvl, std::string const& msg, Color const& c = Colo
 	}
 }
 
+static void WriteLogLevel(LogLevel lvl, std::string const& msg) {
+	switch (lvl) {
+		case LogLevel::Warning:
+			WriteLog(lvl, msg, Color(255, 255, 0, 255));
+			break;
+		case LogLevel::Info:
+			WriteLog(lvl, msg, Color(255, 255, 255, 255));
+			break;
+		default:
+			WriteLog(lvl, msg, Color(128, 128, 128, 255));
+			break;
+	}
+}
+
 static void HandleErrorOutput(const std::string& err) {
 	// Drawing directly on the screen because message_overlay is not visible
 	// when faded out
@@ -223,6 +256,8 @@ static void HandleErrorOutput(const std::string& err) {
 }
 
 void Output::Quit() {
+	FlushThreadMessages();
+
 	if (LOG_FILE) {
 		LOG_FILE.Close();
 	}
@@ -320,23 +355,39 @@ void Output::ErrorStr(std::string const& err) {
 	exit(Player::exit_code);
 }
 
+void Output::FlushThreadMessages() {
+	std::vector<std::pair<LogLevel, std::string>> messages;
+	{
+		std::lock_guard<std::mutex> lock(thread_messages_mutex);
+		if (thread_messages.empty()) {
+			return;
+		}
+		messages.swap(thread_messages);
+	}
+
+	// Already filtered by the log level when queued
+	for (auto& [lvl, msg]: messages) {
+		WriteLogLevel(lvl, msg);
+	}
+}
+
 void Output::WarningStr(std::string const& warn) {
-	if (log_level < LogLevel::Warning) {
+	if (log_level < LogLevel::Warning || DeferThreadMessage(LogLevel::Warning, warn)) {
 		return;
 	}
-	WriteLog(LogLevel::Warning, warn, Color(255, 255, 0, 255));
+	WriteLogLevel(LogLevel::Warning, warn);
 }
 
 void Output::InfoStr(std::string const& msg) {
-	if (log_level < LogLevel::Info) {
+	if (log_level < LogLevel::Info || DeferThreadMessage(LogLevel::Info, msg)) {
 		return;
 	}
-	WriteLog(LogLevel::Info, msg, Color(255, 255, 255, 255));
+	WriteLogLevel(LogLevel::Info, msg);
 }
 
 void Output::DebugStr(std::string const& msg) {
-	if (log_level < LogLevel::Debug) {
+	if (log_level < LogLevel::Debug || DeferThreadMessage(LogLevel::Debug, msg)) {
 		return;
 	}
-	WriteLog(LogLevel::Debug, msg, Color(128, 128, 128, 255));
+	WriteLogLevel(LogLevel::Debug, msg);
 }
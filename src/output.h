@@ -89,6 +89,20 @@ namespace Output {
 	 */
 	void ToggleLog();
 
+	/**
+	 * Marks the calling thread as the thread running the main loop.
+	 * Messages logged by other threads are queued from now on.
+	 * Called by Player::Init.
+	 */
+	void SetMainThread();
+
+	/**
+	 * Writes the messages logged by other threads since the last call.
+	 * These messages are queued because the log file and the message
+	 * overlay are only accessed by the main thread. Called once per frame.
+	 */
+	void FlushThreadMessages();
+
 	/**
 	 * Ignores pause in Warning and Error.
 	 *
@@ -89,6 +89,9 @@ namespace Platform {
 		/** @return Filesize or -1 on error */
 		int64_t GetSize() const;
 
+		/** @return Modification time in seconds since the Unix epoch or -1 on error */
+		int64_t GetModifiedTime() const;
+
 		/**
 		 * Creates a directory recursively at the filename path.
 		 * @param follow_symlinks Whether to follow symlinks (if supported on this platform)
@@ -96,6 +99,15 @@ namespace Platform {
 		 */
 		bool MakeDirectory(bool follow_symlinks) const;
 
+		/**
+		 * Renames the file. An existing file at the target is replaced.
+		 * On most platforms this is atomic.
+		 *
+		 * @param new_name new name of the file
+		 * @return true when the file was renamed
+		 */
+		bool Rename(const std::string& new_name) const;
+
 	private:
 #ifdef _WIN32
 		const std::wstring filename;
@@ -72,12 +72,14 @@
 #include "scene_battle.h"
 #include "scene_logo.h"
 #include "scene_map.h"
+#include "scene_save.h"
 #include "utils.h"
 #include "version.h"
 #include "game_quit.h"
 #include "scene_settings.h"
 #include "scene_title.h"
 #include "instrumentation.h"
+#include "interpreter_trace.h"
 #include "transition.h"
 #include <lcf/scope_guard.h>
 #include <lcf/log_handler.h>
@@ -85,6 +87,8 @@
 #include "game_clock.h"
 #include "message_overlay.h"
 #include "audio_midi.h"
+#include "audio_wavrender.h"
+#include "battle_simulator.h"
 
 #ifdef __ANDROID__
 #include "platform/android/android.h"
@@ -129,10 +133,14 @@ namespace Player {
 	int frames;
 	std::string replay_input_path;
 	std::string record_input_path;
+	std::string render_audio_path;
+	std::string audio_stats_path;
+	std::string trace_interpreter_path;
 	std::string command_line;
 	int speed_modifier_a;
 	int speed_modifier_b;
 	int rng_seed = -1;
+	int simulate_battles = 0;
 	Game_ConfigPlayer player_config;
 	Game_ConfigGame game_config;
 #ifdef EMSCRIPTEN
@@ -152,6 +160,9 @@ namespace {
 }
 
 void Player::Init(std::vector<std::string> args) {
+	// Not the thread of the static initialization on all platforms (e.g. Android)
+	Output::SetMainThread();
+
 	lcf::LogHandler::SetHandler([](lcf::LogHandler::Level level, StringView message, lcf::LogHandler::UserData) {
 		Output::Debug("lcf ({}): {}", lcf::LogHandler::kLevelTags.tag(level), message);
 	});
@@ -200,7 +211,28 @@ void Player::Init(std::vector<std::string> args) {
 	Input::Init(cfg.input, replay_input_path, record_input_path);
 	Input::AddRecordingData(Input::RecordingData::CommandLine, command_line);
 
+	if (!render_audio_path.empty()) {
+#if defined(SUPPORT_AUDIO) && defined(WANT_DRWAV)
+		if (!no_audio_flag) {
+			SetAudioOverride(WavRenderAudio::Create(cfg.audio, render_audio_path));
+		}
+#else
+		Output::Warning("--render-audio is not supported by this build");
+#endif
+	}
+
+	if (!audio_stats_path.empty()) {
+		Instrumentation::SetAudioStatsOutput(audio_stats_path);
+	}
+
+	if (!trace_interpreter_path.empty()) {
+		InterpreterTrace::Start(trace_interpreter_path);
+	}
+
 	player_config = std::move(cfg.player);
+	if (player_config.directory_index.Get()) {
+		FileFinder::LoadDirectoryIndex(Game_Config::GetGlobalConfigFilesystem());
+	}
 	speed_modifier_a = cfg.input.speed_modifier_a.Get();
 	speed_modifier_b = cfg.input.speed_modifier_b.Get();
 }
@@ -254,6 +286,8 @@ void Player::MainLoop() {
 
 		Scene::old_instances.clear();
 		Scene::instance->MainFunction();
+		Scene_Save::UpdatePendingSaves();
+		Output::FlushThreadMessages();
 
 		Graphics::GetMessageOverlay().Update();
 
@@ -414,8 +448,15 @@ void Player::Exit() {
 	if (ret) Output::TakeScreenshot(ret);
 #endif
 	Player::ResetGameObjects();
+	// Finalizes the WAV file of --render-audio
+	SetAudioOverride(nullptr);
+	Instrumentation::SetAudioStatsOutput("");
+	InterpreterTrace::Stop();
 	Font::Dispose();
 	Graphics::Quit();
+	if (player_config.directory_index.Get()) {
+		FileFinder::SaveDirectoryIndex(Game_Config::GetGlobalConfigFilesystem());
+	}
 	Output::Quit();
 	FileFinder::Quit();
 	DisplayUi.reset();
@@ -581,6 +622,12 @@ Game_Config Player::ParseCommandLine() {
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 1, "--simulate-battles")) {
+			if (arg.ParseValue(0, li_value) && li_value > 0) {
+				simulate_battles = li_value;
+			}
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--start-map-id")) {
 			if (arg.ParseValue(0, li_value)) {
 				start_map_id = li_value;
@@ -616,6 +663,36 @@ Game_Config Player::ParseCommandLine() {
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 1, "--render-audio")) {
+			if (arg.NumValues() > 0) {
+				render_audio_path = arg.Value(0);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--audio-stats")) {
+			if (arg.NumValues() > 0) {
+				audio_stats_path = arg.Value(0);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--trace-interpreter")) {
+			if (arg.NumValues() > 0) {
+				trace_interpreter_path = arg.Value(0);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--trace-decode")) {
+			if (arg.NumValues() > 0) {
+				exit(InterpreterTrace::Decode(arg.Value(0)));
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 2, "--trace-diff")) {
+			if (arg.NumValues() > 1) {
+				exit(InterpreterTrace::Diff(arg.Value(0), arg.Value(1)));
+			}
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--encoding")) {
 			if (arg.NumValues() > 0) {
 				forced_encoding = arg.Value(0);
@@ -674,6 +751,14 @@ Game_Config Player::ParseCommandLine() {
 }
 
 void Player::CreateGameObjects() {
+	auto startup_time = Game_Clock::now();
+	auto phase_time = startup_time;
+	auto log_phase = [&](const char* phase) {
+		auto now = Game_Clock::now();
+		Output::Debug("Startup: {} took {}ms", phase, std::chrono::duration_cast<std::chrono::milliseconds>(now - phase_time).count());
+		phase_time = now;
+	};
+
 	// Parse game specific settings
 	CmdlineParser cp(arguments);
 	game_config = Game_ConfigGame::Create(cp);
@@ -688,8 +773,10 @@ void Player::CreateGameObjects() {
 
 	// Guess non-standard extensions (for the DB) before loading the encoding
 	GuessNonStandardExtensions();
+	log_phase("Configuration");
 
 	GetEncoding();
+	log_phase("Encoding detection");
 	escape_symbol = lcf::ReaderUtil::Recode("\\", encoding);
 	if (escape_symbol.empty()) {
 		Output::Error("Invalid encoding: {}.", encoding);
@@ -714,7 +801,10 @@ void Player::CreateGameObjects() {
 		FileFinder::DumpFilesystem(FileFinder::Save());
 	}
 
+	log_phase("Filesystem setup");
+
 	LoadDatabase();
+	log_phase("Database");
 
 	bool no_rtp_warning_flag = false;
 	Player::has_custom_resolution = false;
@@ -816,7 +906,10 @@ void Player::CreateGameObjects() {
 
 	Output::Debug("Engine configured as: 2k={} 2k3={} MajorUpdated={} Eng={}", Player::IsRPG2k(), Player::IsRPG2k3(), Player::IsMajorUpdatedVersion(), Player::IsEnglish());
 
+	log_phase("Game information");
+
 	Main_Data::filefinder_rtp = std::make_unique<FileFinder_RTP>(no_rtp_flag, no_rtp_warning_flag, rtp_path);
+	log_phase("RTP");
 
 	if (!game_config.patch_override) {
 		if (!FileFinder::Game().FindFile("harmony.dll").empty()) {
@@ -840,8 +933,10 @@ void Player::CreateGameObjects() {
 	game_config.PrintActivePatches();
 
 	ResetGameObjects();
+	log_phase("Game objects");
 
 	LoadFonts();
+	log_phase("Fonts");
 
 	if (Player::IsPatchKeyPatch()) {
 		Main_Data::game_ineluki->ExecuteScriptList(FileFinder::Game().FindFile("autorun.script"));
@@ -850,6 +945,13 @@ void Player::CreateGameObjects() {
 	if (Player::IsPatchDestiny()) {
 		Main_Data::game_destiny->Load();
 	}
+
+	Output::Debug("Startup: Total {}ms", std::chrono::duration_cast<std::chrono::milliseconds>(Game_Clock::now() - startup_time).count());
+
+	// Most folders are known after the startup, written again on exit when more were read
+	if (player_config.directory_index.Get()) {
+		FileFinder::SaveDirectoryIndex(Game_Config::GetGlobalConfigFilesystem());
+	}
 }
 
 bool Player::ChangeResolution(int width, int height) {
@@ -886,6 +988,9 @@ void Player::RestoreBaseResolution() {
 }
 
 void Player::ResetGameObjects() {
+	// Pending saves still refer to the old game state
+	Scene_Save::WaitForPendingSaves();
+
 	// The init order is important
 	Main_Data::Cleanup();
 
@@ -1108,6 +1213,7 @@ static void OnMapSaveFileReady(FileRequestResult*, lcf::rpg::Save save) {
 }
 
 void Player::LoadSavegame(const std::string& save_name, int save_id) {
+	Scene_Save::WaitForPendingSaves();
 	Output::Debug("Loading Save {}", save_name);
 
 	bool load_on_map = Scene::instance->type == Scene::Map;
@@ -1286,9 +1392,90 @@ void Player::SetupBattleTest() {
 		Main_Data::game_party->SetupBattleTest();
 	}
 
+	if (simulate_battles > 0) {
+		BattleSimulator::Config cfg;
+		cfg.troop_id = args.troop_id;
+		cfg.battles = simulate_battles;
+		cfg.seed = rng_seed > 0 ? static_cast<uint32_t>(rng_seed) : Rand::GetRNG()();
+		cfg.condition = args.condition;
+
+		BattleSimulator::PrintStats(cfg, BattleSimulator::Run(cfg));
+		exit_flag = true;
+		return;
+	}
+
 	Scene::Push(Scene_Battle::Create(std::move(args)), true);
 }
 
+static bool ReadCompressedInt(std::istream& is, uint32_t& value, std::vector<uint8_t>& raw) {
+	value = 0;
+	for (int i = 0; i < 5; ++i) {
+		int c = is.get();
+		if (c == EOF) {
+			return false;
+		}
+		raw.push_back(static_cast<uint8_t>(c));
+		value = (value << 7) | (c & 0x7F);
+		if ((c & 0x80) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Loads only the Terms and System chunks of a database.
+ * This is all the encoding detection needs and avoids parsing the whole
+ * database twice. All other chunks are skipped without reading them.
+ *
+ * @param is stream of the LDB file
+ * @return partial database or nullptr on error
+ */
+static std::unique_ptr<lcf::rpg::Database> LoadDatabaseSystem(Filesystem_Stream::InputStream& is) {
+	// Chunk IDs of lcf::rpg::Database, the chunks are stored in ascending order
+	constexpr uint32_t chunk_terms = 0x15;
+	constexpr uint32_t chunk_system = 0x16;
+
+	auto file_size = static_cast<uint32_t>(is.GetSize());
+	std::vector<uint8_t> partial;
+
+	uint32_t header_len;
+	if (!ReadCompressedInt(is, header_len, partial) || header_len > 32) {
+		return nullptr;
+	}
+	partial.resize(partial.size() + header_len);
+	if (!is.read(reinterpret_cast<char*>(partial.data() + partial.size() - header_len), header_len)) {
+		return nullptr;
+	}
+
+	while (true) {
+		size_t chunk_start = partial.size();
+		uint32_t id;
+		uint32_t size;
+		if (!ReadCompressedInt(is, id, partial) || id == 0 || id > chunk_system || !ReadCompressedInt(is, size, partial)) {
+			partial.resize(chunk_start);
+			break;
+		}
+
+		if (size > file_size) {
+			return nullptr;
+		}
+
+		if (id == chunk_terms || id == chunk_system) {
+			partial.resize(partial.size() + size);
+			if (!is.read(reinterpret_cast<char*>(partial.data() + partial.size() - size), size)) {
+				return nullptr;
+			}
+		} else {
+			partial.resize(chunk_start);
+			is.seekg(size, std::ios_base::cur);
+		}
+	}
+
+	Filesystem_Stream::InputStream partial_is(new Filesystem_Stream::InputMemoryStreamBuf(std::move(partial)), ToString(is.GetName()));
+	return lcf::LDB_Reader::Load(partial_is);
+}
+
 std::string Player::GetEncoding() {
 	encoding = forced_encoding;
 
@@ -1307,7 +1494,13 @@ std::string Player::GetEncoding() {
 		std::string ldb = FileFinder::Game().FindFile(fileext_map.MakeFilename(RPG_RT_PREFIX, SUFFIX_LDB));
 		auto ldb_stream = FileFinder::Game().OpenInputStream(ldb);
 		if (ldb_stream) {
-			auto db = lcf::LDB_Reader::Load(ldb_stream);
+			auto db = LoadDatabaseSystem(ldb_stream);
+			if (!db) {
+				Output::Debug("Partial database load failed. Loading the whole database.");
+				ldb_stream.clear();
+				ldb_stream.seekg(0, std::ios_base::beg);
+				db = lcf::LDB_Reader::Load(ldb_stream);
+			}
 			if (db) {
 				std::vector<std::string> encodings = lcf::ReaderUtil::DetectEncodings(*db);
 
@@ -1400,6 +1593,10 @@ Engine options:
                                  skills.
  -c, --config-path P  Set a custom configuration path. When not specified, the
                       configuration folder in the users home directory is used.
+ --directory-index    Remember the folder contents of the game and RTP in the
+                      configuration folder. Folders are only read again when
+                      their modification time changed. Speeds up the startup
+                      on slow storage. Disable with --no-directory-index.
  --encoding N         Instead of autodetecting the encoding or using the one in
                       RPG_RT.ini, the encoding N is used.
  --enemyai-algo A     Which EnemyAI algorithm to use.
@@ -1426,6 +1623,9 @@ Engine options:
  --language LANG      Load the game translation in language/LANG folder.
  --load-game-id N     Skip the title scene and load SaveN.lsd (N is padded to
                       two digits).
+ --map-cache-size N   Number of parsed maps kept in memory. Maps reachable from
+                      the current map are preloaded. 0 disables the cache.
+                      The default is 8.
  --new-game           Skip the title scene and start a new game directly.
  --no-log-color       Disable colors in terminal log.
  --no-rtp             Disable support for the Runtime Package (RTP).
@@ -1499,7 +1699,14 @@ Video options:
 
 Audio options:
  --no-audio           Disable audio (in case you prefer your own music).
+ --audio-stats FILE   Write audio mixer telemetry (mixing time, underruns,
+                      sound effect channel usage) once per second as CSV to
+                      FILE. Hold F6 to show it on screen.
  --music-volume V     Set volume of background music to V (0-100).
+ --render-audio FILE  Do not output audio to the sound card. Instead decode it in
+                      lockstep with the game frames and write it to the WAV
+                      file FILE. Combine with --replay-input for reproducible
+                      audio.
  --sound-volume V     Set volume of sound effects to V (0-100).
  --soundfont FILE     Soundfont in sf2 format to use when playing MIDI files.
  --soundfont-path P   The path in which the settings scene looks for soundfonts.
@@ -1513,6 +1720,11 @@ Debug options:
                       condition and terrain ID.
  --hide-title         Hide the title background image and center the command
                       menu.
+ --simulate-battles N
+                      Used together with --battle-test. Instead of showing the
+                      battle simulate it N times without graphics and sound,
+                      print statistics about the outcome and exit.
+                      Use --seed for reproducible results.
  --start-map-id N     Overwrite the map used for new games and use MapN.lmu
                       instead (N is padded to four digits).
                       Incompatible with --load-game-id.
@@ -1523,6 +1735,13 @@ Debug options:
                       position (X, Y).
                       Incompatible with --load-game-id.
  --test-play          Enable TestPlay (Debug) mode.
+ --trace-decode FILE  Print the interpreter trace FILE as text and exit.
+ --trace-diff A B     Compare the interpreter traces A and B, print the first
+                      difference and exit.
+ --trace-interpreter FILE
+                      Record every executed event command and the switches and
+                      variables it changed to FILE. Combine with --replay-input
+                      and --seed to find where two runs diverge.
 
 Other options:
  -v, --version        Display program version and exit.
@@ -389,6 +389,18 @@ namespace Player {
 	/** Path to record input log to */
 	extern std::string record_input_path;
 
+	/** Path to render the audio output to (WAV) */
+	extern std::string render_audio_path;
+
+	/** Number of battles to simulate instead of running the battle test */
+	extern int simulate_battles;
+
+	/** Path to write the audio telemetry to (CSV) */
+	extern std::string audio_stats_path;
+
+	/** Path to record the interpreter trace to */
+	extern std::string trace_interpreter_path;
+
 	/** The concatenated command line */
 	extern std::string command_line;
 
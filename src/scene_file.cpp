@@ -26,8 +26,11 @@
 #include "game_party.h"
 #include "input.h"
 #include <lcf/lsd/reader.h>
+#include <lcf/reader_lcf.h>
+#include <lcf/writer_lcf.h>
 #include "player.h"
 #include "scene_file.h"
+#include "scene_save.h"
 #include "bitmap.h"
 #include <lcf/reader_util.h>
 #include "output.h"
@@ -104,7 +107,7 @@ void Scene_File::PopulateSaveWindow(Window_SaveFile& win, int id) {
 			return;
 		}
 
-		std::unique_ptr<lcf::rpg::Save> savegame = lcf::LSD_Reader::Load(save_stream, Player::encoding);
+		std::unique_ptr<lcf::rpg::Save> savegame = LoadSaveTitle(save_stream);
 
 		if (savegame) {
 			PopulatePartyFaces(win, id, *savegame);
@@ -116,11 +119,53 @@ void Scene_File::PopulateSaveWindow(Window_SaveFile& win, int id) {
 	}
 }
 
+std::unique_ptr<lcf::rpg::Save> Scene_File::LoadSaveTitle(std::istream& is) {
+	// The title is always the first chunk of a savegame
+	constexpr int chunk_title = 0x64;
+	// Titles are a few hundred bytes, protects against reading garbage
+	constexpr int max_title_size = 64 * 1024;
+
+	lcf::LcfReader reader(is);
+	std::string header;
+	int header_size = reader.ReadInt();
+	if (header_size != 11) {
+		return nullptr;
+	}
+	reader.ReadString(header, header_size);
+	if (header != "LcfSaveData") {
+		return nullptr;
+	}
+
+	int chunk_id = reader.ReadInt();
+	int chunk_size = reader.ReadInt();
+	if (chunk_id != chunk_title || chunk_size <= 0 || chunk_size > max_title_size) {
+		return nullptr;
+	}
+
+	std::vector<uint8_t> title;
+	reader.Read(title, chunk_size);
+	if (!is || title.size() != static_cast<size_t>(chunk_size)) {
+		return nullptr;
+	}
+
+	// Parse a savegame that consists only of the title chunk
+	std::stringstream title_stream;
+	lcf::LcfWriter writer(title_stream, Player::IsRPG2k3() ? lcf::EngineVersion::e2k3 : lcf::EngineVersion::e2k);
+	writer.WriteInt(header_size);
+	writer.Write(header);
+	writer.WriteInt(chunk_id);
+	writer.WriteInt(chunk_size);
+	writer.Write(title);
+
+	return lcf::LSD_Reader::Load(title_stream, Player::encoding);
+}
+
 void Scene_File::Start() {
 	CreateHelpWindow();
 	border_top = Scene_File::MakeBorderSprite(32);
 
 	// Refresh File Finder Save Folder
+	Scene_Save::WaitForPendingSaves();
 	fs = FileFinder::Save();
 
 	for (int i = 0; i < Utils::Clamp<int32_t>(lcf::Data::system.easyrpg_max_savefiles, 3, 99); i++) {
@@ -129,7 +174,6 @@ void Scene_File::Start() {
 		w->SetIndex(i);
 		w->SetZ(Priority_Window);
 		PopulateSaveWindow(*w, i);
-		w->Refresh();
 
 		file_windows.push_back(w);
 	}
@@ -163,7 +207,17 @@ void Scene_File::RefreshWindows() {
 		Window_SaveFile *w = file_windows[i].get();
 		w->SetY(40 + (i - top_index) * 64);
 		w->SetActive(i == index);
-		w->Refresh();
+	}
+	RefreshVisibleWindows();
+}
+
+void Scene_File::RefreshVisibleWindows() {
+	// Drawing the faces is expensive: Windows outside of the screen are
+	// drawn when they scroll in
+	for (auto& fw: file_windows) {
+		if (fw->GetY() + fw->GetHeight() > 32 && fw->GetY() < Player::screen_height) {
+			fw->RefreshIfChanged();
+		}
 	}
 }
 
@@ -171,8 +225,8 @@ void Scene_File::Refresh() {
 	for (int i = 0; i < Utils::Clamp<int32_t>(lcf::Data::system.easyrpg_max_savefiles, 3, 99); i++) {
 		Window_SaveFile *w = file_windows[i].get();
 		PopulateSaveWindow(*w, i);
-		w->Refresh();
 	}
+	RefreshVisibleWindows();
 }
 
 void Scene_File::vUpdate() {
@@ -182,6 +236,7 @@ void Scene_File::vUpdate() {
 		for (auto& fw: file_windows) {
 			fw->Update();
 		}
+		RefreshVisibleWindows();
 		return;
 	}
 
@@ -19,6 +19,8 @@
 #define EP_SCENE_FILE_H
 
 // Headers
+#include <iosfwd>
+#include <memory>
 #include <vector>
 #include "filefinder.h"
 #include <lcf/rpg/save.h>
@@ -52,6 +54,16 @@ public:
 
 	bool IsWindowMoving() const;
 
+	/**
+	 * Loads only the SaveTitle chunk of a savegame, this is all the file
+	 * windows display. The remaining chunks with the map and event state
+	 * are not read.
+	 *
+	 * @param is stream of the savegame
+	 * @return savegame that only contains the title or nullptr when the file is invalid
+	 */
+	static std::unique_ptr<lcf::rpg::Save> LoadSaveTitle(std::istream& is);
+
 protected:
 	virtual void CreateHelpWindow();
 	virtual void PopulateSaveWindow(Window_SaveFile& win, int id);
@@ -61,6 +73,7 @@ protected:
 	static std::unique_ptr<Sprite> MakeArrowSprite(bool down);
 
 	void RefreshWindows();
+	void RefreshVisibleWindows();
 	void MoveFileWindows(int dy, int dt);
 	void UpdateArrows();
 	bool HandleExtraCommandsWindow();
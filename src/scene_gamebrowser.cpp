@@ -229,6 +229,9 @@ void Scene_GameBrowser::BootGame() {
 		return;
 	}
 
+	// The browser is not updated while the game runs
+	gamelist_window->CancelScan();
+
 	FileFinder::SetGameFilesystem(entry.fs);
 	Player::CreateGameObjects();
 
@@ -400,11 +400,13 @@ void Scene_Map::OnAsyncSuspend(F&& f, AsyncOp aop, bool is_preupdate) {
 
 	if (aop.GetType() == AsyncOp::eSave) {
 		auto savefs = FileFinder::Save();
-		bool success = Scene_Save::Save(savefs, aop.GetSaveSlot());
-		if (aop.GetSaveResultVar() > 0) {
-			Main_Data::game_variables->Set(aop.GetSaveResultVar(), success ? 1 : 0);
-			Game_Map::SetNeedRefresh(true);
-		}
+		int result_var = aop.GetSaveResultVar();
+		Scene_Save::SaveAsync(savefs, aop.GetSaveSlot(), [result_var](bool success) {
+			if (result_var > 0) {
+				Main_Data::game_variables->Set(result_var, success ? 1 : 0);
+				Game_Map::SetNeedRefresh(true);
+			}
+		});
 	}
 
 	if (aop.GetType() == AsyncOp::eLoad) {
@@ -16,6 +16,7 @@
  */
 
 // Headers
+#include <deque>
 #include <sstream>
 
 #ifdef EMSCRIPTEN
@@ -45,6 +46,95 @@
 #include "translation.h"
 #include "version.h"
 
+#ifdef USE_THREADS
+#  include <future>
+#endif
+
+namespace {
+	struct PendingSave {
+		FilesystemView fs;
+		std::string filename;
+#ifdef USE_THREADS
+		std::future<std::string> data;
+#else
+		std::string data;
+#endif
+		std::function<void(bool)> on_finish;
+	};
+
+	/** Savegames in request order, written when their encoding finished */
+	std::deque<PendingSave> pending_saves;
+
+	/** @return encoded savegame or an empty string on failure */
+	std::string EncodeSave(const lcf::rpg::Save& save, lcf::EngineVersion engine, const std::string& encoding) {
+		std::stringstream ss;
+		if (!lcf::LSD_Reader::Save(ss, save, engine, encoding)) {
+			return {};
+		}
+		return ss.str();
+	}
+
+	bool WriteSaveFile(const FilesystemView& fs, StringView filename, const std::string& data) {
+		auto os = fs.OpenOutputStream(filename);
+		if (!os) {
+			return false;
+		}
+		os.write(data.data(), data.size());
+		os.flush();
+		return static_cast<bool>(os);
+	}
+
+	bool WriteSave(const FilesystemView& fs, const std::string& filename, const std::string& data) {
+		if (data.empty()) {
+			Output::Warning("Failed saving to {}: Encoding failed", filename);
+			return false;
+		}
+
+		if (fs.IsFeatureSupported(Filesystem::Feature::Rename)) {
+			// A crash while writing must not destroy the previous savegame
+			std::string tmp_filename = filename + ".tmp";
+			if (!WriteSaveFile(fs, tmp_filename, data)) {
+				Output::Warning("Failed saving to {}", tmp_filename);
+				return false;
+			}
+			if (!fs.RenameFile(tmp_filename, filename)) {
+				Output::Warning("Failed saving to {}: Rename of {} failed", filename, tmp_filename);
+				return false;
+			}
+			return true;
+		}
+
+		if (!WriteSaveFile(fs, filename, data)) {
+			Output::Warning("Failed saving to {}", filename);
+			return false;
+		}
+		return true;
+	}
+
+	void FinishPendingSaves(bool wait) {
+		while (!pending_saves.empty()) {
+#ifdef USE_THREADS
+			if (!wait && pending_saves.front().data.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				break;
+			}
+			std::string data = pending_saves.front().data.get();
+#else
+			std::string data = std::move(pending_saves.front().data);
+#endif
+			// The callback can request another save
+			PendingSave pending = std::move(pending_saves.front());
+			pending_saves.pop_front();
+
+			bool res = WriteSave(pending.fs, pending.filename, data);
+			AsyncHandler::SaveFilesystem();
+
+			if (pending.on_finish) {
+				pending.on_finish(res);
+			}
+		}
+	}
+}
+
 Scene_Save::Scene_Save() :
 	Scene_File(ToString(lcf::Data::terms.save_game_message)) {
 	Scene::type = Scene::Save;
@@ -55,12 +145,12 @@ void Scene_Save::Start() {
 
 	for (int i = 0; i < Utils::Clamp<int32_t>(lcf::Data::system.easyrpg_max_savefiles, 3, 99); i++) {
 		file_windows[i]->SetHasSave(true);
-		file_windows[i]->Refresh();
 	}
+	RefreshVisibleWindows();
 }
 
 void Scene_Save::Action(int index) {
-	Save(fs, index + 1);
+	SaveAsync(fs, index + 1);
 
 	Scene::Pop();
 }
@@ -77,20 +167,63 @@ std::string Scene_Save::GetSaveFilename(const FilesystemView& fs, int slot_id) {
 }
 
 bool Scene_Save::Save(const FilesystemView& fs, int slot_id, bool prepare_save) {
-	const auto filename = GetSaveFilename(fs, slot_id);
-	Output::Debug("Saving to {}", filename);
+	bool res = false;
+	SaveAsync(fs, slot_id, [&res](bool success) { res = success; }, prepare_save);
+	WaitForPendingSaves();
+	return res;
+}
 
-	auto save_stream = FileFinder::Save().OpenOutputStream(filename);
+bool Scene_Save::Save(std::ostream& os, int slot_id, bool prepare_save) {
+	auto save = CreateSaveData(slot_id, prepare_save);
 
-	if (!save_stream) {
-		Output::Warning("Failed saving to {}", filename);
-		return false;
-	}
+	auto lcf_engine = Player::IsRPG2k3() ? lcf::EngineVersion::e2k3 : lcf::EngineVersion::e2k;
+	bool res = lcf::LSD_Reader::Save(os, save, lcf_engine, Player::encoding);
+
+	Main_Data::game_dynrpg->Save(slot_id);
+
+	AsyncHandler::SaveFilesystem();
 
-	return Save(save_stream, slot_id, prepare_save);
+	return res;
 }
 
-bool Scene_Save::Save(std::ostream& os, int slot_id, bool prepare_save) {
+void Scene_Save::SaveAsync(const FilesystemView& fs, int slot_id, std::function<void(bool)> on_finish, bool prepare_save) {
+	PendingSave pending;
+	pending.fs = fs;
+	pending.filename = GetSaveFilename(fs, slot_id);
+	pending.on_finish = std::move(on_finish);
+	Output::Debug("Saving to {}", pending.filename);
+
+	auto save = CreateSaveData(slot_id, prepare_save);
+	auto lcf_engine = Player::IsRPG2k3() ? lcf::EngineVersion::e2k3 : lcf::EngineVersion::e2k;
+
+	Main_Data::game_dynrpg->Save(slot_id);
+
+#ifdef USE_THREADS
+	// Only encoding runs on the worker, the filesystems are not thread-safe
+	pending.data = std::async(std::launch::async, [](lcf::rpg::Save save, lcf::EngineVersion engine, std::string encoding) {
+		return EncodeSave(save, engine, encoding);
+	}, std::move(save), lcf_engine, Player::encoding);
+	pending_saves.push_back(std::move(pending));
+#else
+	pending.data = EncodeSave(save, lcf_engine, Player::encoding);
+	pending_saves.push_back(std::move(pending));
+	FinishPendingSaves(true);
+#endif
+}
+
+void Scene_Save::UpdatePendingSaves() {
+	FinishPendingSaves(false);
+}
+
+void Scene_Save::WaitForPendingSaves() {
+	FinishPendingSaves(true);
+}
+
+bool Scene_Save::IsSavePending() {
+	return !pending_saves.empty();
+}
+
+lcf::rpg::Save Scene_Save::CreateSaveData(int slot_id, bool prepare_save) {
 	lcf::rpg::Save save;
 	auto& title = save.title;
 	// TODO: Maybe find a better place to setup the save file?
@@ -153,14 +286,7 @@ bool Scene_Save::Save(std::ostream& os, int slot_id, bool prepare_save) {
 			sme.map_id = 0;
 		}
 	}
-	auto lcf_engine = Player::IsRPG2k3() ? lcf::EngineVersion::e2k3 : lcf::EngineVersion::e2k;
-	bool res = lcf::LSD_Reader::Save(os, save, lcf_engine, Player::encoding);
-
-	Main_Data::game_dynrpg->Save(slot_id);
-
-	AsyncHandler::SaveFilesystem();
-
-	return res;
+	return save;
 }
 
 bool Scene_Save::IsSlotValid(int) {
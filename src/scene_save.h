@@ -19,7 +19,9 @@
 #define EP_SCENE_SAVE_H
 
 // Headers
+#include <functional>
 #include <vector>
+#include <lcf/rpg/save.h>
 #include "scene.h"
 #include "scene_file.h"
 
@@ -42,6 +44,39 @@ public:
 	static std::string GetSaveFilename(const FilesystemView& tree, int slot_id);
 	static bool Save(const FilesystemView& tree, int slot_id, bool prepare_save = true);
 	static bool Save(std::ostream& os, int slot_id, bool prepare_save = true);
+
+	/**
+	 * Creates a snapshot of the current game state for saving.
+	 *
+	 * @param slot_id save slot
+	 * @param prepare_save when true the save count is incremented and the
+	 *   header of the savegame is updated
+	 * @return savegame data
+	 */
+	static lcf::rpg::Save CreateSaveData(int slot_id, bool prepare_save = true);
+
+	/**
+	 * Saves the game without blocking the main thread.
+	 * The game state is captured immediately. Encoding happens on a worker
+	 * thread and the file is replaced atomically when supported by the
+	 * filesystem.
+	 *
+	 * @param tree filesystem to save in
+	 * @param slot_id save slot
+	 * @param on_finish invoked on the main thread with the result once the
+	 *   savegame was written
+	 * @param prepare_save see CreateSaveData
+	 */
+	static void SaveAsync(const FilesystemView& tree, int slot_id, std::function<void(bool)> on_finish = {}, bool prepare_save = true);
+
+	/** Writes all pending savegames whose encoding has finished. Called once per frame. */
+	static void UpdatePendingSaves();
+
+	/** Blocks until all pending savegames are written. */
+	static void WaitForPendingSaves();
+
+	/** @return Whether a savegame is still being encoded or written */
+	static bool IsSavePending();
 };
 
 #endif
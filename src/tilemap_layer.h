@@ -30,6 +30,7 @@
 #include "opacity.h"
 #include "span.h"
 
+class AutotileAtlas;
 class TilemapLayer;
 
 /**
@@ -118,39 +119,12 @@ private:
 	void CreateTileCache(const std::vector<short>& nmap_data);
 	void CreateTileCacheAt(int x, int y, int tile_id);
 	void RecreateTileDataAt(int x, int y, int tile_id);
-	void GenerateAutotileAB(short ID, short animID);
-	void GenerateAutotileD(short ID);
-	void DrawTile(Bitmap& dst, Bitmap& tile, Bitmap& tone_tile, int x, int y, int row, int col, uint32_t tone_hash, bool allow_fast_blit = true);
-	void DrawTileImpl(Bitmap& dst, Bitmap& tile, Bitmap& tone_tile, int x, int y, int row, int col, uint32_t tone_hash, ImageOpacity op, bool allow_fast_blit);
+	void DrawTile(Bitmap& dst, Bitmap& tile, Bitmap& tone_tile, std::unordered_set<uint32_t>& tone_tiles, int x, int y, int row, int col, uint32_t tone_hash, bool allow_fast_blit = true);
+	void DrawTileImpl(Bitmap& dst, Bitmap& tile, Bitmap& tone_tile, std::unordered_set<uint32_t>& tone_tiles, int x, int y, int row, int col, uint32_t tone_hash, ImageOpacity op, bool allow_fast_blit);
 	void RecalculateAutotile(int x, int y, int tile_id);
 
-	static const int TILES_PER_ROW = 64;
-
-	struct TileXY {
-		uint8_t x;
-		uint8_t y;
-		bool valid;
-		TileXY() : valid(false) {}
-		TileXY(uint8_t x, uint8_t y) : x(x), y(y), valid(true) {}
-	};
-
-	BitmapRef GenerateAutotiles(int count, const std::unordered_map<uint32_t, TileXY>& map);
-
-	TileXY GetCachedAutotileAB(short ID, short animID);
-	TileXY GetCachedAutotileD(short ID);
-	BitmapRef autotiles_ab_screen;
-	BitmapRef autotiles_ab_screen_effect;
-	BitmapRef autotiles_d_screen;
-	BitmapRef autotiles_d_screen_effect;
-
-	int autotiles_ab_next = -1;
-	int autotiles_d_next = -1;
-
-	TileXY autotiles_ab[3][3][16][47] = {};
-	TileXY autotiles_d[12][50] = {};
-
-	std::unordered_map<uint32_t, TileXY> autotiles_ab_map;
-	std::unordered_map<uint32_t, TileXY> autotiles_d_map;
+	/** Autotiles of the chipset, shared with other maps. Only used by the lower layer. */
+	std::shared_ptr<AutotileAtlas> autotiles;
 
 	struct TileData {
 		short ID;
@@ -16,29 +16,221 @@
  */
 
 // Headers
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 #include "window_gamelist.h"
 #include "filefinder.h"
+#include "filesystem_native.h"
 #include "bitmap.h"
 #include "font.h"
+#include "game_config.h"
+#include "output.h"
+#include "platform.h"
 #include "system.h"
+#include "utils.h"
+
+#ifdef USE_THREADS
+#  include <future>
+#  include <thread>
+#endif
+
+namespace {
+	constexpr unsigned max_scan_threads = 4;
+	constexpr StringView project_type_cache_name = "gamelist_cache.txt";
+	/** The cache is started again when it grows beyond this, paths of removed games are never purged */
+	constexpr size_t project_type_cache_max = 4096;
+
+	struct CachedProjectType {
+		int64_t mtime;
+		FileFinder::ProjectType type;
+	};
+
+	/** Project types by full path, valid as long as the modification time matches */
+	std::unordered_map<std::string, CachedProjectType> project_type_cache;
+	std::mutex project_type_cache_mutex;
+	bool project_type_cache_loaded = false;
+	bool project_type_cache_modified = false;
+
+	/**
+	 * Loads the cache written by a previous launch from the configuration
+	 * folder. One entry per line: modification time, project type and path.
+	 */
+	void LoadProjectTypeCache() {
+		if (project_type_cache_loaded) {
+			return;
+		}
+		project_type_cache_loaded = true;
+
+		auto fs = Game_Config::GetGlobalConfigFilesystem();
+		if (!fs) {
+			return;
+		}
+		auto is = fs.OpenInputStream(project_type_cache_name);
+		if (!is) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(project_type_cache_mutex);
+		std::string line;
+		while (Utils::ReadLine(is, line) && project_type_cache.size() < project_type_cache_max) {
+			std::istringstream ss(line);
+			int64_t mtime;
+			int type;
+			std::string path;
+			if (!(ss >> mtime >> type) || mtime < 0 || type < 0 || type > FileFinder::ProjectType::SimRpgMaker95) {
+				continue;
+			}
+			ss.get();
+			if (!std::getline(ss, path) || path.empty()) {
+				continue;
+			}
+			project_type_cache[path] = { mtime, static_cast<FileFinder::ProjectType>(type) };
+		}
+	}
+
+	/** Writes the cache to the configuration folder when new entries were added */
+	void SaveProjectTypeCache() {
+		std::ostringstream ss;
+		{
+			std::lock_guard<std::mutex> lock(project_type_cache_mutex);
+			if (!project_type_cache_modified) {
+				return;
+			}
+			project_type_cache_modified = false;
+			for (const auto& [path, entry]: project_type_cache) {
+				ss << entry.mtime << ' ' << static_cast<int>(entry.type) << ' ' << path << '\n';
+			}
+		}
+
+		auto fs = Game_Config::GetGlobalConfigFilesystem();
+		if (!fs) {
+			return;
+		}
+		auto os = fs.OpenOutputStream(project_type_cache_name);
+		if (!os) {
+			Output::Debug("GameList: Cannot write {}", project_type_cache_name);
+			return;
+		}
+		os << ss.str();
+	}
+
+	bool FindCachedProjectType(const std::string& path, int64_t mtime, FileFinder::ProjectType& type) {
+		if (mtime < 0) {
+			return false;
+		}
+		std::lock_guard<std::mutex> lock(project_type_cache_mutex);
+		auto it = project_type_cache.find(path);
+		if (it == project_type_cache.end() || it->second.mtime != mtime) {
+			return false;
+		}
+		type = it->second.type;
+		return true;
+	}
+}
+
+struct Window_GameList::Scan {
+	struct Job {
+		int index;
+		std::string path;
+		int64_t mtime;
+	};
+
+	~Scan() {
+		// The workers finish their current job, destroying them waits for this
+		cancelled = true;
+	}
+
+	/** @return true when no worker is running anymore */
+	bool IsFinished() const {
+#ifdef USE_THREADS
+		return std::all_of(workers.begin(), workers.end(), [](const auto& worker) {
+			return worker.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		});
+#else
+		return true;
+#endif
+	}
+
+	void Run() {
+		for (;;) {
+			size_t i = next_job++;
+			if (cancelled || i >= jobs.size()) {
+				return;
+			}
+			auto& job = jobs[i];
+
+			// Every job uses an own filesystem because the directory cache is not thread-safe
+			auto fs = std::make_shared<NativeFilesystem>("", FilesystemView());
+			auto game_fs = fs->Create(job.path);
+			auto type = game_fs ? FileFinder::GetProjectType(game_fs) : FileFinder::ProjectType::Unknown;
+
+			if (job.mtime >= 0) {
+				std::lock_guard<std::mutex> lock(project_type_cache_mutex);
+				if (project_type_cache.size() >= project_type_cache_max) {
+					project_type_cache.clear();
+				}
+				project_type_cache[job.path] = { job.mtime, type };
+				project_type_cache_modified = true;
+			}
+
+			std::lock_guard<std::mutex> lock(results_mutex);
+			results.emplace_back(job.index, type);
+		}
+	}
+
+	std::vector<Job> jobs;
+	std::atomic<size_t> next_job{0};
+	std::atomic<bool> cancelled{false};
+	size_t num_finished = 0;
+
+	std::mutex results_mutex;
+	std::vector<std::pair<int, FileFinder::ProjectType>> results;
+
+#ifdef USE_THREADS
+	/** Destroyed first, the futures wait for the workers */
+	std::vector<std::future<void>> workers;
+#endif
+};
+
+std::vector<std::shared_ptr<Window_GameList::Scan>> Window_GameList::cancelled_scans;
 
 Window_GameList::Window_GameList(int ix, int iy, int iwidth, int iheight) :
 	Window_Selectable(ix, iy, iwidth, iheight) {
 	column_max = 1;
 }
 
+Window_GameList::~Window_GameList() {
+	CancelScan();
+}
+
 bool Window_GameList::Refresh(FilesystemView filesystem_base, bool show_dotdot) {
+	CancelScan();
+
 	base_fs = filesystem_base;
 	if (!base_fs) {
 		return false;
 	}
 
 	game_entries.clear();
+	entry_pending.clear();
 
 	this->show_dotdot = show_dotdot;
 
 	auto files = base_fs.ListDirectory();
 
+	bool scan_in_background = false;
+#if defined(USE_THREADS) && !defined(USE_CUSTOM_FILEBUF)
+	scan_in_background = dynamic_cast<const NativeFilesystem*>(&base_fs.GetOwner()) != nullptr;
+	if (scan_in_background) {
+		LoadProjectTypeCache();
+	}
+#endif
+	std::unordered_set<std::string> pending_names;
+
 	// Find valid game diectories
 	for (auto& dir : *files) {
 		assert(!dir.second.name.empty() && "VFS BUG: Empty filename in the folder");
@@ -52,25 +244,30 @@ bool Window_GameList::Refresh(FilesystemView filesystem_base, bool show_dotdot)
 		if (StringView(dir.second.name).ends_with(".save")) {
 			continue;
 		}
+
 		if (dir.second.type == DirectoryTree::FileType::Regular) {
-			if (FileFinder::IsSupportedArchiveExtension(dir.second.name)) {
-				// The type is only determined on platforms with fast file IO (Windows and UNIX systems)
-				// A platform is considered "fast" when it does not require our custom IO buffer
-#ifndef USE_CUSTOM_FILEBUF
-				auto fs = base_fs.Create(dir.second.name);
-				game_entries.push_back({ dir.second.name, FileFinder::GetProjectType(fs) });
-#else
-				game_entries.push_back({ dir.second.name, FileFinder::ProjectType::Unknown });
-#endif
+			if (!FileFinder::IsSupportedArchiveExtension(dir.second.name)) {
+				continue;
 			}
-		} else if (dir.second.type == DirectoryTree::FileType::Directory) {
+		} else if (dir.second.type != DirectoryTree::FileType::Directory) {
+			continue;
+		}
+
+		auto type = FileFinder::ProjectType::Unknown;
+		// The type is only determined on platforms with fast file IO (Windows and UNIX systems)
+		// A platform is considered "fast" when it does not require our custom IO buffer
 #ifndef USE_CUSTOM_FILEBUF
+		if (scan_in_background) {
+			auto path = FileFinder::MakePath(base_fs.GetFullPath(), dir.second.name);
+			if (!FindCachedProjectType(path, Platform::File(path).GetModifiedTime(), type)) {
+				pending_names.insert(dir.second.name);
+			}
+		} else {
 			auto fs = base_fs.Create(dir.second.name);
-			game_entries.push_back({ dir.second.name, FileFinder::GetProjectType(fs) });
-#else
-			game_entries.push_back({ dir.second.name, FileFinder::ProjectType::Unknown });
-#endif
+			type = FileFinder::GetProjectType(fs);
 		}
+#endif
+		game_entries.push_back({ dir.second.name, type });
 	}
 
 	// Sort game list in place
@@ -84,6 +281,28 @@ bool Window_GameList::Refresh(FilesystemView filesystem_base, bool show_dotdot)
 		game_entries.insert(game_entries.begin(), { "..", FileFinder::ProjectType::Unknown });
 	}
 
+	entry_pending.resize(game_entries.size());
+	if (!pending_names.empty()) {
+		scan = std::make_shared<Scan>();
+		for (size_t i = 0; i < game_entries.size(); ++i) {
+			const auto& name = game_entries[i].dir_name;
+			if (pending_names.count(name) > 0) {
+				auto path = FileFinder::MakePath(base_fs.GetFullPath(), name);
+				int64_t mtime = Platform::File(path).GetModifiedTime();
+				scan->jobs.push_back({ static_cast<int>(i), std::move(path), mtime });
+				entry_pending[i] = true;
+			}
+		}
+
+#ifdef USE_THREADS
+		unsigned num_threads = std::min<unsigned>({ max_scan_threads, std::max(1u, std::thread::hardware_concurrency()),
+			static_cast<unsigned>(scan->jobs.size()) });
+		for (unsigned i = 0; i < num_threads; ++i) {
+			scan->workers.push_back(std::async(std::launch::async, [s = scan.get()]() { s->Run(); }));
+		}
+#endif
+	}
+
 	if (HasValidEntry()) {
 		item_max = game_entries.size();
 
@@ -118,7 +337,7 @@ void Window_GameList::DrawItem(int index) {
 
 #ifndef USE_CUSTOM_FILEBUF
 	auto color = Font::ColorDefault;
-	if (ge.type == FileFinder::Unknown) {
+	if (ge.type == FileFinder::Unknown && !entry_pending[index]) {
 		color = Font::ColorHeal;
 	} else if (ge.type > FileFinder::ProjectType::Supported) {
 		color = Font::ColorKnockout;
@@ -173,6 +392,57 @@ void Window_GameList::DrawErrorText(bool show_dotdot) {
 	}
 }
 
+void Window_GameList::Update() {
+	Window_Selectable::Update();
+
+	if (!scan) {
+		return;
+	}
+
+	std::vector<std::pair<int, FileFinder::ProjectType>> results;
+	{
+		std::lock_guard<std::mutex> lock(scan->results_mutex);
+		results.swap(scan->results);
+	}
+
+	for (auto& [index, type]: results) {
+		game_entries[index].type = type;
+		entry_pending[index] = false;
+		DrawItem(index);
+	}
+
+	scan->num_finished += results.size();
+	if (scan->num_finished == scan->jobs.size()) {
+		scan.reset();
+		SaveProjectTypeCache();
+	}
+}
+
+void Window_GameList::CancelScan() {
+	// Drop the cancelled scans whose workers are done, destroying them does not block
+	cancelled_scans.erase(std::remove_if(cancelled_scans.begin(), cancelled_scans.end(), [](const auto& s) {
+		return s->IsFinished();
+	}), cancelled_scans.end());
+
+	if (!scan) {
+		return;
+	}
+
+	// Kept alive until the workers finished their current job
+	scan->cancelled = true;
+	if (!scan->IsFinished()) {
+		cancelled_scans.push_back(std::move(scan));
+	}
+	scan.reset();
+	std::fill(entry_pending.begin(), entry_pending.end(), false);
+
+	SaveProjectTypeCache();
+}
+
+bool Window_GameList::IsScanning() const {
+	return scan != nullptr;
+}
+
 bool Window_GameList::HasValidEntry() {
 	size_t minval = show_dotdot ? 1 : 0;
 	return game_entries.size() > minval;
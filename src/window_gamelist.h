@@ -19,6 +19,7 @@
 #define EP_WINDOW_GAMELIST_H
 
 // Headers
+#include <memory>
 #include <vector>
 #include "window_selectable.h"
 #include "filefinder.h"
@@ -34,11 +35,34 @@ public:
 	 */
 	Window_GameList(int ix, int iy, int iwidth, int iheight);
 
+	~Window_GameList() override;
+
 	/**
 	 * Refreshes the game list.
+	 * On native filesystems the project types are determined by worker
+	 * threads and the entries are redrawn while the results arrive.
+	 * The types are cached in the configuration folder by path and
+	 * modification time, unchanged entries are not scanned again.
 	 */
 	bool Refresh(FilesystemView filesystem_base, bool show_dotdot);
 
+	/**
+	 * Redraws the entries whose project type was determined by the
+	 * background scan.
+	 */
+	void Update() override;
+
+	/**
+	 * Stops the background scan without waiting for the workers. Entries
+	 * not scanned yet keep an unknown project type.
+	 */
+	void CancelScan();
+
+	/**
+	 * @return true while project types are determined in the background
+	 */
+	bool IsScanning() const;
+
 	/**
 	 * Draws an item together with the quantity.
 	 *
@@ -59,8 +83,15 @@ public:
 	FileFinder::FsEntry GetFilesystemEntry() const;
 
 private:
+	struct Scan;
+
 	FilesystemView base_fs;
 	std::vector<FileFinder::GameEntry> game_entries;
+	/** Entries whose project type is still determined by the scan */
+	std::vector<bool> entry_pending;
+	std::shared_ptr<Scan> scan;
+	/** Cancelled scans whose workers did not finish their current job yet */
+	static std::vector<std::shared_ptr<Scan>> cancelled_scans;
 
 	bool show_dotdot = false;
 };
@@ -66,20 +66,24 @@ std::string Window_SaveFile::GetSaveFileName() const {
 
 void Window_SaveFile::SetIndex(int id) {
 	index = id;
+	changed = true;
 }
 
 void Window_SaveFile::SetDisplayOverride(const std::string& name, int index) {
 	override_name = name;
 	override_index = index;
+	changed = true;
 }
 
 void Window_SaveFile::SetParty(lcf::rpg::SaveTitle title) {
 	data = std::move(title);
 	has_party = true;
+	changed = true;
 }
 
 void Window_SaveFile::SetCorrupted(bool corrupted) {
 	this->corrupted = corrupted;
+	changed = true;
 }
 
 bool Window_SaveFile::IsValid() const {
@@ -92,9 +96,17 @@ bool Window_SaveFile::HasParty() const {
 
 void Window_SaveFile::SetHasSave(bool valid) {
 	this->has_save = valid;
+	changed = true;
+}
+
+void Window_SaveFile::RefreshIfChanged() {
+	if (changed) {
+		Refresh();
+	}
 }
 
 void Window_SaveFile::Refresh() {
+	changed = false;
 	contents->Clear();
 
 	Font::SystemColor fc = has_save ? Font::ColorDefault : Font::ColorDisabled;
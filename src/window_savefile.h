@@ -38,6 +38,11 @@ public:
 	 */
 	void Refresh();
 
+	/**
+	 * Renders the current save when it changed since the last Refresh.
+	 */
+	void RefreshIfChanged();
+
 	/**
 	 * Sets the ID of the savegame.
 	 *
@@ -102,6 +107,7 @@ protected:
 	bool corrupted = false;
 	bool has_save = false;
 	bool has_party = false;
+	bool changed = true;
 };
 
 inline bool Window_SaveFile::IsSystemGraphicUpdateAllowed() const {
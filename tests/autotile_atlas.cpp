@@ -0,0 +1,161 @@
+#include "doctest.h"
+#include "autotile_atlas.h"
+#include "bitmap.h"
+#include "cache.h"
+#include "color.h"
+#include "map_data.h"
+#include "options.h"
+
+TEST_SUITE_BEGIN("AutotileAtlas");
+
+static BitmapRef MakeChipset(std::string id) {
+	auto chipset = Bitmap::Create(480, 256);
+	chipset->SetId(std::move(id));
+	return chipset;
+}
+
+TEST_CASE("Lazy") {
+	AutotileAtlas atlas(MakeChipset("ChipSet/test"));
+	REQUIRE_EQ(atlas.GetCountAB(), 0);
+	REQUIRE_EQ(atlas.GetCountD(), 0);
+	REQUIRE(!atlas.GetBitmapAB());
+	REQUIRE(!atlas.GetBitmapD());
+
+	auto ab = atlas.GetAB(BLOCK_A, 0);
+	REQUIRE(ab.valid);
+	REQUIRE_EQ(ab.x, 0);
+	REQUIRE_EQ(ab.y, 0);
+	REQUIRE_EQ(atlas.GetCountAB(), 1);
+	REQUIRE(atlas.GetBitmapAB());
+	REQUIRE(!atlas.GetBitmapD());
+
+	auto again = atlas.GetAB(BLOCK_A, 0);
+	REQUIRE_EQ(again.x, ab.x);
+	REQUIRE_EQ(again.y, ab.y);
+	REQUIRE_EQ(atlas.GetCountAB(), 1);
+
+	// Every animation step is a different tile
+	auto step = atlas.GetAB(BLOCK_A, 1);
+	REQUIRE(step.valid);
+	REQUIRE_EQ(step.x, 1);
+	REQUIRE_EQ(atlas.GetCountAB(), 2);
+}
+
+TEST_CASE("Dedup") {
+	AutotileAtlas atlas(MakeChipset("ChipSet/test"));
+
+	// The variants 0, 47 and 48 are made of the same quarters
+	auto d = atlas.GetD(BLOCK_D);
+	REQUIRE(d.valid);
+	auto d47 = atlas.GetD(BLOCK_D + 47);
+	auto d48 = atlas.GetD(BLOCK_D + 48);
+	REQUIRE_EQ(d47.x, d.x);
+	REQUIRE_EQ(d48.x, d.x);
+	REQUIRE_EQ(atlas.GetCountD(), 1);
+
+	auto other = atlas.GetD(BLOCK_D + BLOCK_D_STRIDE);
+	REQUIRE(other.valid);
+	REQUIRE_NE(other.x, d.x);
+	REQUIRE_EQ(atlas.GetCountD(), 2);
+}
+
+TEST_CASE("Invalid") {
+	AutotileAtlas atlas(MakeChipset("ChipSet/test"));
+
+	REQUIRE(!atlas.GetAB(BLOCK_C - 1, 0).valid);
+	REQUIRE(!atlas.GetAB(-1, 0).valid);
+	REQUIRE(!atlas.GetD(BLOCK_D_END).valid);
+	REQUIRE(!atlas.GetD(BLOCK_D - 1).valid);
+	REQUIRE_EQ(atlas.GetCountAB(), 0);
+	REQUIRE_EQ(atlas.GetCountD(), 0);
+}
+
+TEST_CASE("Grow") {
+	AutotileAtlas atlas(MakeChipset("ChipSet/test"));
+	auto first = atlas.GetAB(BLOCK_A, 0);
+
+	for (int anim = 0; anim < 3; ++anim) {
+		for (int id = BLOCK_A; id < BLOCK_C; ++id) {
+			if (id % 50 < 47 && (id % 1000) / 50 < 16) {
+				REQUIRE(atlas.GetAB(id, anim).valid);
+			}
+		}
+	}
+
+	const int rows = atlas.GetBitmapAB()->height() / TILE_SIZE;
+	REQUIRE_GE(rows * AutotileAtlas::TILES_PER_ROW, atlas.GetCountAB());
+	REQUIRE_GT(atlas.GetCountAB(), AutotileAtlas::TILES_PER_ROW * 4);
+
+	// Tiles keep their position
+	auto pos = atlas.GetAB(BLOCK_A, 0);
+	REQUIRE_EQ(pos.x, first.x);
+	REQUIRE_EQ(pos.y, first.y);
+}
+
+TEST_CASE("ToneEffect") {
+	AutotileAtlas atlas(MakeChipset("ChipSet/test"));
+	atlas.GetAB(BLOCK_A, 0);
+	atlas.GetD(BLOCK_D);
+
+	const Tone tone(255, 0, 0, 0);
+	auto& effect = atlas.GetToneEffect(tone);
+	REQUIRE(effect.tone == tone);
+	REQUIRE_EQ(effect.ab->height(), atlas.GetBitmapAB()->height());
+	REQUIRE_EQ(effect.d->height(), atlas.GetBitmapD()->height());
+	effect.tiles_ab.insert(0);
+
+	atlas.GetToneEffect(Tone(0, 255, 0, 0));
+	REQUIRE_EQ(atlas.GetToneEffect(tone).tiles_ab.size(), 1);
+}
+
+TEST_CASE("ToneBlit") {
+	auto chipset = MakeChipset("ChipSet/test");
+	chipset->Fill(Color(100, 100, 100, 255));
+	AutotileAtlas atlas(chipset);
+
+	auto ab = atlas.GetAB(BLOCK_A, 0);
+	auto d = atlas.GetD(BLOCK_D);
+	auto& bitmap_ab = *atlas.GetBitmapAB();
+	auto& bitmap_d = *atlas.GetBitmapD();
+	REQUIRE(bitmap_ab.GetImageOpacity() != ImageOpacity::Transparent);
+	REQUIRE(bitmap_d.GetImageOpacity() != ImageOpacity::Transparent);
+	REQUIRE(bitmap_ab.GetTileOpacity(ab.x, ab.y) == ImageOpacity::Opaque);
+	REQUIRE(bitmap_d.GetTileOpacity(d.x, d.y) == ImageOpacity::Opaque);
+
+	// How TilemapLayer draws a tile under a screen tone
+	const Tone tone(255, 128, 128, 128);
+	auto& effect = atlas.GetToneEffect(tone);
+	const Rect rect_ab(ab.x * TILE_SIZE, ab.y * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+	const Rect rect_d(d.x * TILE_SIZE, d.y * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+	effect.ab->ToneBlit(rect_ab.x, rect_ab.y, bitmap_ab, rect_ab, tone, Opacity::Opaque());
+	effect.d->ToneBlit(rect_d.x, rect_d.y, bitmap_d, rect_d, tone, Opacity::Opaque());
+
+	auto color_ab = effect.ab->GetColorAt(rect_ab.x, rect_ab.y);
+	auto color_d = effect.d->GetColorAt(rect_d.x, rect_d.y);
+	REQUIRE_EQ(color_ab.alpha, 255);
+	REQUIRE_GT(color_ab.red, 100);
+	REQUIRE_EQ(color_d.alpha, 255);
+	REQUIRE_GT(color_d.red, 100);
+}
+
+TEST_CASE("Cache") {
+	auto chipset = MakeChipset("ChipSet/test");
+
+	auto atlas = Cache::Autotiles(chipset);
+	atlas->GetD(BLOCK_D);
+
+	// Shared by all maps using the chipset
+	REQUIRE_EQ(Cache::Autotiles(MakeChipset("ChipSet/test")), atlas);
+	REQUIRE_EQ(atlas->GetCountD(), 1);
+	REQUIRE_NE(Cache::Autotiles(MakeChipset("ChipSet/other")), atlas);
+
+	// Generated chipsets are not shared
+	auto generated = MakeChipset("");
+	REQUIRE_NE(Cache::Autotiles(generated), Cache::Autotiles(generated));
+
+	Cache::Clear();
+	REQUIRE_NE(Cache::Autotiles(chipset), atlas);
+	Cache::Clear();
+}
+
+TEST_SUITE_END();
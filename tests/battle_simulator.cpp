@@ -0,0 +1,102 @@
+#include "test_mock_actor.h"
+#include "battle_simulator.h"
+#include "game_actor.h"
+#include "rand.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("BattleSimulator");
+
+static void SetupBattle() {
+	for (int id = 1; id <= 2; ++id) {
+		MakeDBActor(id, 1, 50, 120, 0, 30, 20, 10, 25);
+		auto* actor = Main_Data::game_actors->GetActor(id);
+		actor->SetBaseMaxHp(120);
+		actor->SetBaseAtk(30);
+		actor->SetBaseDef(20);
+		actor->SetBaseSpi(10);
+		actor->SetBaseAgi(25);
+		actor->SetHp(actor->GetMaxHp());
+	}
+
+	for (int id = 1; id <= 2; ++id) {
+		auto* enemy = MakeDBEnemy(id, 100, 0, 35, 15, 10, 20);
+		enemy->actions.push_back({});
+		enemy->actions.back().rating = 5;
+		enemy->actions.back().kind = lcf::rpg::EnemyAction::Kind_basic;
+		enemy->actions.back().basic = lcf::rpg::EnemyAction::Basic_attack;
+	}
+}
+
+static BattleSimulator::Config MakeConfig(int battles) {
+	BattleSimulator::Config cfg;
+	cfg.troop_id = 1;
+	cfg.battles = battles;
+	cfg.seed = 1234;
+	return cfg;
+}
+
+TEST_CASE("Outcome") {
+	const MockBattle mb(2, 2, Player::EngineRpg2k | Player::EngineEnglish);
+	SetupBattle();
+
+	auto stats = BattleSimulator::Run(MakeConfig(50));
+	REQUIRE_EQ(stats.battles, 50);
+	REQUIRE_EQ(stats.victories + stats.defeats + stats.draws, 50);
+	REQUIRE_GT(stats.turns, 0);
+	REQUIRE_LE(stats.party_hp, stats.party_max_hp);
+}
+
+TEST_CASE("TurnLimit") {
+	const MockBattle mb(2, 2, Player::EngineRpg2k | Player::EngineEnglish);
+	SetupBattle();
+
+	auto cfg = MakeConfig(10);
+	cfg.max_turns = 1;
+	auto stats = BattleSimulator::Run(cfg);
+	REQUIRE_EQ(stats.draws, 10);
+	REQUIRE_EQ(stats.turns, 10);
+}
+
+TEST_CASE("Deterministic") {
+	const MockBattle mb(2, 2, Player::EngineRpg2k | Player::EngineEnglish);
+	SetupBattle();
+
+	auto a = BattleSimulator::Run(MakeConfig(20));
+	auto b = BattleSimulator::Run(MakeConfig(20));
+	REQUIRE_EQ(a.victories, b.victories);
+	REQUIRE_EQ(a.defeats, b.defeats);
+	REQUIRE_EQ(a.turns, b.turns);
+	REQUIRE_EQ(a.party_hp, b.party_hp);
+}
+
+TEST_CASE("StateRestored") {
+	const MockBattle mb(2, 2, Player::EngineRpg2k | Player::EngineEnglish);
+	SetupBattle();
+
+	auto* actor = Main_Data::game_actors->GetActor(1);
+	actor->SetHp(70);
+	Main_Data::game_switches->Set(5, true);
+	Rand::SeedRandomNumberGenerator(99);
+	auto rng = Rand::GetRNG();
+
+	BattleSimulator::Run(MakeConfig(10));
+
+	REQUIRE_EQ(actor->GetHp(), 70);
+	REQUIRE_EQ(Main_Data::game_actors->GetActor(2)->GetHp(), 120);
+	REQUIRE(Main_Data::game_switches->Get(5));
+	REQUIRE(Rand::GetRNG() == rng);
+	REQUIRE(Game_Battle::battle_running);
+	REQUIRE(!Main_Data::game_system->IsSeMuted());
+	REQUIRE(Main_Data::game_party->GetActors().size() == 2);
+}
+
+TEST_CASE("InvalidTroop") {
+	const MockBattle mb(2, 2, Player::EngineRpg2k | Player::EngineEnglish);
+
+	auto cfg = MakeConfig(10);
+	cfg.troop_id = 999;
+	auto stats = BattleSimulator::Run(cfg);
+	REQUIRE_EQ(stats.battles, 0);
+}
+
+TEST_SUITE_END();
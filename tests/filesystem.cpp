@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
 #include "filesystem.h"
+#include "filesystem_native.h"
+#include "filesystem_stream.h"
 #include "filefinder.h"
 #include "main_data.h"
 #include "doctest.h"
@@ -88,4 +93,85 @@ TEST_CASE("FindFile") {
 	Player::escape_symbol = "";
 }
 
+TEST_CASE("DirectoryIndex") {
+	std::stringstream index;
+	{
+		auto native = std::make_shared<NativeFilesystem>("", FilesystemView());
+		// No index file yet
+		Filesystem_Stream::InputStream is;
+		CHECK(!native->LoadDirectoryIndex(is));
+		std::stringstream unchanged;
+		CHECK(!native->SaveDirectoryIndex(unchanged));
+
+		REQUIRE(native->Subtree(EP_TEST_PATH "/game").ListDirectory("Charset"));
+		CHECK(native->SaveDirectoryIndex(index));
+		CHECK(!native->SaveDirectoryIndex(unchanged));
+	}
+
+	auto native = std::make_shared<NativeFilesystem>("", FilesystemView());
+	CHECK(native->LoadDirectoryIndex(index));
+	auto charset = native->Subtree(EP_TEST_PATH "/game").ListDirectory("cHaRsEt");
+	REQUIRE(charset);
+	CHECK(charset->size() == 1);
+	CHECK((*charset)[0].second.name == "chara1.png");
+
+	std::stringstream corrupted(std::string("EasyRPG DirIndex\x01\x00\x00\x00\xff", 21));
+	CHECK(!native->LoadDirectoryIndex(corrupted));
+}
+
+TEST_CASE("InputStreamData") {
+	auto fs = FileFinder::Root().Subtree(EP_TEST_PATH "/game");
+	auto is = fs.OpenInputStream("RPG_RT.ldb");
+	REQUIRE(is);
+
+	auto data = is.GetData();
+	auto content = Utils::ReadStream(is);
+#ifdef USE_MMAP
+	REQUIRE(!data.empty());
+#endif
+	if (!data.empty()) {
+		CHECK(std::equal(data.begin(), data.end(), content.begin(), content.end()));
+
+		// The data starts at the read position
+		is.clear();
+		is.seekg(10);
+		auto rest = is.GetData();
+		CHECK(rest.size() == content.size() - 10);
+		CHECK(std::equal(rest.begin(), rest.end(), content.begin() + 10, content.end()));
+		CHECK(is.tellg() == 10);
+	}
+}
+
+#ifdef USE_MMAP
+TEST_CASE("InputMappedStreamBuf") {
+	std::vector<uint8_t> content(100 * 1024);
+	for (size_t i = 0; i < content.size(); ++i) {
+		content[i] = static_cast<uint8_t>(i * 7);
+	}
+
+	FILE* f = std::tmpfile();
+	REQUIRE(f);
+	REQUIRE(std::fwrite(content.data(), 1, content.size(), f) == content.size());
+	std::fflush(f);
+	auto* buf = Filesystem_Stream::InputMappedStreamBuf::Create(fileno(f), content.size());
+	std::fclose(f);
+	REQUIRE(buf);
+
+	CHECK(!buf->CreateSubView(content.size() - 10, 11));
+	Filesystem_Stream::InputStream view(buf->CreateSubView(1000, 5000), "view");
+
+	// The view keeps the mapping alive
+	Filesystem_Stream::InputStream is(buf, "mapped");
+	CHECK(is.GetData().size() == content.size());
+	is.Close();
+
+	REQUIRE(view);
+	CHECK(view.GetSize() == 5000);
+	CHECK(view.GetData().data()[0] == content[1000]);
+	view.seekg(-1, std::ios_base::end);
+	CHECK(view.get() == content[5999]);
+	CHECK(view.get() == EOF);
+}
+#endif
+
 TEST_SUITE_END();
@@ -1,4 +1,5 @@
 #include "filesystem.h"
+#include "filesystem_zip.h"
 #include "filefinder.h"
 #include "main_data.h"
 #include "doctest.h"
@@ -60,6 +61,41 @@ TEST_CASE("File reading") {
 	CHECK(line_out == "lo");
 }
 
+TEST_CASE("File reading: Streaming") {
+	auto fs = FileFinder::Root().Create(ZIP_PATH);
+	auto is_mem = fs.OpenInputStream("1kb");
+	REQUIRE(is_mem);
+	auto expected = Utils::ReadStream(is_mem);
+
+	ZipFilesystem::SetStreamingThreshold(0);
+	auto is_deflate = fs.OpenInputStream("1kb");
+	auto is_plain = fs.OpenInputStream("text");
+	ZipFilesystem::SetStreamingThreshold(1024 * 1024);
+	REQUIRE(is_deflate);
+	REQUIRE(is_plain);
+
+	// Both streams have their own handle and can be read interleaved
+	std::string line_out;
+	CHECK(Utils::ReadLine(is_plain, line_out));
+	CHECK(line_out == "hello");
+
+	CHECK(is_deflate.GetSize() == 1024);
+	CHECK(Utils::ReadStream(is_deflate) == expected);
+
+	is_plain.seekg(3, std::ios_base::beg);
+	CHECK(Utils::ReadLine(is_plain, line_out));
+	CHECK(line_out == "lo");
+
+	is_deflate.clear();
+	is_deflate.seekg(1000, std::ios_base::beg);
+	CHECK(is_deflate.get() == expected[1000]);
+	is_deflate.seekg(-901, std::ios_base::cur);
+	CHECK(is_deflate.get() == expected[100]);
+	is_deflate.seekg(-1, std::ios_base::end);
+	CHECK(is_deflate.get() == expected[1023]);
+	CHECK(is_deflate.get() == EOF);
+}
+
 TEST_CASE("File IO error") {
 	auto fs = FileFinder::Root().Create(ZIP_PATH);
 	CHECK(!fs.OpenInputStream("game"));
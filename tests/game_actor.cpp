@@ -1,4 +1,5 @@
 #include "test_mock_actor.h"
+#include "rand.h"
 #include "doctest.h"
 
 template <typename... Args>
@@ -860,4 +861,128 @@ TEST_CASE("ChangeParam") {
 	}
 }
 
+static void testStatCache(const Game_Battler& battler) {
+	for (auto weapon: { Game_Battler::WeaponAll, Game_Battler::WeaponNone, Game_Battler::WeaponPrimary, Game_Battler::WeaponSecondary }) {
+		REQUIRE_EQ(battler.GetAtk(weapon), battler.CalcValueAfterAtkStates(battler.GetBaseAtk(weapon) + battler.GetAtkModifier()));
+		REQUIRE_EQ(battler.GetDef(weapon), battler.CalcValueAfterDefStates(battler.GetBaseDef(weapon) + battler.GetDefModifier()));
+		REQUIRE_EQ(battler.GetSpi(weapon), battler.CalcValueAfterSpiStates(battler.GetBaseSpi(weapon) + battler.GetSpiModifier()));
+		REQUIRE_EQ(battler.GetAgi(weapon), battler.CalcValueAfterAgiStates(battler.GetBaseAgi(weapon) + battler.GetAgiModifier()));
+	}
+}
+
+TEST_CASE("StatCache") {
+	const MockBattle m;
+	Rand::SeedRandomNumberGenerator(1234);
+
+	// States 2-9 halve or double different parameters
+	for (int i = 1; i < 9; ++i) {
+		auto& state = lcf::Data::states[i];
+		state.affect_type = (i % 2) ? lcf::rpg::State::AffectType_half : lcf::rpg::State::AffectType_double;
+		state.affect_attack = (i % 3) == 0;
+		state.affect_defense = (i % 3) == 1;
+		state.affect_spirit = i >= 5;
+		state.affect_agility = (i % 4) != 0;
+		state.priority = i * 5;
+	}
+
+	for (int i = 1; i <= 3; ++i) {
+		auto& cls = lcf::Data::classes[i - 1];
+		cls.parameters.Setup(99);
+		for (int lvl = 0; lvl < 99; ++lvl) {
+			cls.parameters.maxhp[lvl] = 100 + lvl * i;
+			cls.parameters.attack[lvl] = 10 + lvl * i;
+			cls.parameters.defense[lvl] = 20 + lvl * i;
+			cls.parameters.spirit[lvl] = 30 + lvl * i;
+			cls.parameters.agility[lvl] = 40 + lvl * i;
+		}
+	}
+
+	for (int i = 1; i <= 4; ++i) {
+		auto& actor = lcf::Data::actors[i - 1];
+		for (int lvl = 0; lvl < 99; ++lvl) {
+			actor.parameters.maxhp[lvl] = 200 + lvl;
+			actor.parameters.attack[lvl] = lvl * 3 + i;
+			actor.parameters.defense[lvl] = lvl * 2 + i;
+			actor.parameters.spirit[lvl] = lvl + i;
+			actor.parameters.agility[lvl] = lvl * 4 + i;
+		}
+	}
+
+	MakeDBEquip(1, lcf::rpg::Item::Type_weapon, 50, 0, 5, -10);
+	MakeDBEquip(2, lcf::rpg::Item::Type_weapon, 20, 10, 0, 30);
+	MakeDBEquip(3, lcf::rpg::Item::Type_shield, 0, 40, 0, -5);
+	MakeDBEquip(4, lcf::rpg::Item::Type_armor, 0, 60, 0, -20);
+	MakeDBEquip(5, lcf::rpg::Item::Type_helmet, 0, 20, 10, 0);
+	MakeDBEquip(6, lcf::rpg::Item::Type_accessory, 15, 15, 15, 15);
+	lcf::Data::items[5].state_set[4] = true;
+
+	std::vector<Game_Battler*> battlers;
+	for (int i = 0; i < 4; ++i) {
+		auto* enemy = Main_Data::game_enemyparty->GetEnemy(i);
+		Setup(enemy, 500, 100, 100 + i * 10, 150, 200, 250 - i * 10);
+
+		battlers.push_back(Main_Data::game_party->GetActor(i));
+		battlers.push_back(enemy);
+	}
+
+	// Equipment item ids by slot, the shield slot holds a weapon for two weapon actors
+	const std::vector<int> equip[] = { { 0, 1, 2 }, { 0, 2, 3 }, { 0, 4 }, { 0, 5 }, { 0, 6 } };
+
+	for (int iter = 0; iter < 2000; ++iter) {
+		auto& battler = *battlers[Rand::GetRandomNumber(0, battlers.size() - 1)];
+		auto* actor = battler.GetType() == Game_Battler::Type_Ally ? static_cast<Game_Actor*>(&battler) : nullptr;
+
+		switch (Rand::GetRandomNumber(0, actor ? 9 : 3)) {
+			case 0:
+				battler.AddState(Rand::GetRandomNumber(1, 9), true);
+				break;
+			case 1:
+				battler.RemoveState(Rand::GetRandomNumber(1, 9), false);
+				break;
+			case 2:
+				battler.ChangeAtkModifier(Rand::GetRandomNumber(-100, 100));
+				battler.ChangeDefModifier(Rand::GetRandomNumber(-100, 100));
+				battler.ChangeSpiModifier(Rand::GetRandomNumber(-100, 100));
+				battler.ChangeAgiModifier(Rand::GetRandomNumber(-100, 100));
+				break;
+			case 3:
+				if (Rand::ChanceOf(1, 4)) {
+					battler.RemoveAllStates();
+				} else {
+					battler.BattleStateHeal();
+				}
+				break;
+			case 4: {
+				int slot = Rand::GetRandomNumber(1, 5);
+				auto& items = equip[slot - 1];
+				actor->SetTwoWeapons(Rand::ChanceOf(1, 2));
+				actor->SetEquipment(slot, items[Rand::GetRandomNumber(0, items.size() - 1)]);
+				break;
+			}
+			case 5:
+				actor->SetLevel(Rand::GetRandomNumber(1, 50));
+				break;
+			case 6:
+				actor->ChangeClass(Rand::GetRandomNumber(0, 3), Rand::GetRandomNumber(1, 50),
+						Game_Actor::eSkillNoChange, static_cast<Game_Actor::ClassChangeParamMode>(Rand::GetRandomNumber(0, 3)), nullptr);
+				break;
+			case 7:
+				actor->SetBaseAtk(Rand::GetRandomNumber(1, 999));
+				actor->SetBaseAgi(Rand::GetRandomNumber(1, 999));
+				break;
+			case 8:
+				actor->SetBaseDef(Rand::GetRandomNumber(1, 999));
+				actor->SetBaseSpi(Rand::GetRandomNumber(1, 999));
+				break;
+			case 9:
+				actor->RemoveWholeEquipment();
+				break;
+		}
+
+		for (auto* b: battlers) {
+			testStatCache(*b);
+		}
+	}
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,156 @@
+#include "doctest.h"
+#include "game_event_batch.h"
+#include "game_map.h"
+#include "rand.h"
+#include <tuple>
+#include <vector>
+
+#include "mock_game.h"
+
+TEST_SUITE_BEGIN("Game_EventBatch");
+
+using State = std::tuple<int, int, int, int, int, int, int, int>;
+
+static std::vector<lcf::rpg::Event> MakeEvents() {
+	std::vector<lcf::rpg::Event> events;
+
+	for (auto mt: { MoveType::MoveType_stationary, MoveType::MoveType_random, MoveType::MoveType_toward }) {
+		for (int ati = 0; ati <= static_cast<int>(AnimType::AnimType_step_frame_fix); ++ati) {
+			for (int speed = 1; speed <= 6; ++speed) {
+				events.push_back({});
+				auto& ev = events.back();
+				ev.ID = static_cast<int>(events.size()) + 1;
+				ev.x = 2 + (ev.ID % 18) * 2;
+				ev.y = 2 + (ev.ID / 18) % 13 * 2;
+				ev.pages.push_back({});
+				auto& page = ev.pages.back();
+				page.ID = 1;
+				page.move_type = mt;
+				page.animation_type = static_cast<AnimType>(ati);
+				page.move_speed = speed;
+				page.move_frequency = 1 + ev.ID % 8;
+				page.character_pattern = 1;
+			}
+		}
+	}
+	return events;
+}
+
+static State GetState(const Game_Event& ev) {
+	return State(ev.GetX(), ev.GetY(), ev.GetStopCount(), ev.GetAnimCount(),
+		ev.GetAnimFrame(), ev.GetFacing(), ev.GetDirection(), ev.GetRemainingStep());
+}
+
+// Changes some flags the same way for both runs
+static void ChangeFlags(std::vector<Game_Event>& events, int frame) {
+	for (int i = 0; i < static_cast<int>(events.size()); ++i) {
+		auto& ev = events[i];
+		if ((i + frame) % 37 == 0) {
+			ev.SetPaused(!ev.IsPaused());
+		}
+		if ((i + frame) % 53 == 0) {
+			ev.SetAnimPaused(!ev.IsAnimPaused());
+		}
+		if ((i * 7 + frame) % 97 == 0) {
+			ev.Flash(31, 0, 0, 31, 10);
+		}
+	}
+}
+
+static std::vector<std::vector<State>> Run(const std::vector<lcf::rpg::Event>& db_events, bool batched) {
+	std::vector<Game_Event> events;
+	events.reserve(db_events.size());
+	for (auto& ev: db_events) {
+		events.emplace_back(1, &ev);
+	}
+
+	Rand::SeedRandomNumberGenerator(42);
+	Game_EventBatch batch;
+
+	std::vector<std::vector<State>> states;
+	for (int frame = 0; frame < 300; ++frame) {
+		ChangeFlags(events, frame);
+
+		for (auto& ev: events) {
+			ev.SetProcessed(false);
+		}
+
+		for (auto& ev: events) {
+			if (batched && batch.Add(ev)) {
+				continue;
+			}
+			batch.Update();
+			ev.Update(false);
+		}
+		batch.Update();
+		REQUIRE_EQ(batch.GetSize(), 0);
+
+		states.emplace_back();
+		for (auto& ev: events) {
+			states.back().push_back(GetState(ev));
+		}
+	}
+	return states;
+}
+
+TEST_CASE("SameAsUpdate") {
+	const MockGame mg(MockMap::ePass40x30);
+
+	auto db_events = MakeEvents();
+	auto expected = Run(db_events, false);
+	auto actual = Run(db_events, true);
+
+	REQUIRE_EQ(expected.size(), actual.size());
+	for (size_t frame = 0; frame < expected.size(); ++frame) {
+		for (size_t i = 0; i < expected[frame].size(); ++i) {
+			CAPTURE(frame);
+			CAPTURE(i);
+			REQUIRE(expected[frame][i] == actual[frame][i]);
+		}
+	}
+}
+
+TEST_CASE("Skipped") {
+	const MockGame mg(MockMap::ePass40x30);
+	Game_EventBatch batch;
+
+	lcf::rpg::Event db_ev;
+	db_ev.ID = 2;
+	db_ev.pages.push_back({});
+	db_ev.pages.back().ID = 1;
+	Game_Event ev(1, &db_ev);
+
+	SUBCASE("stationary") {
+		REQUIRE(batch.Add(ev));
+		REQUIRE_EQ(batch.GetSize(), 1);
+		REQUIRE(ev.IsProcessed());
+		batch.Update();
+		REQUIRE_EQ(batch.GetSize(), 0);
+		REQUIRE_EQ(ev.GetStopCount(), 1);
+	}
+
+	SUBCASE("processed") {
+		ev.SetProcessed(true);
+		REQUIRE(batch.Add(ev));
+		REQUIRE_EQ(batch.GetSize(), 0);
+	}
+
+	SUBCASE("moving") {
+		ev.Move(Game_Character::Right);
+		REQUIRE(!batch.Add(ev));
+	}
+
+	SUBCASE("move route") {
+		lcf::rpg::MoveRoute mr;
+		mr.move_commands.push_back({});
+		ev.ForceMoveRoute(mr, 2);
+		REQUIRE(!batch.Add(ev));
+	}
+
+	SUBCASE("autostart") {
+		db_ev.pages.back().trigger = lcf::rpg::EventPage::Trigger_auto_start;
+		REQUIRE(!batch.Add(ev));
+	}
+}
+
+TEST_SUITE_END();
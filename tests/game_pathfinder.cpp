@@ -0,0 +1,258 @@
+#include "doctest.h"
+#include "game_pathfinder.h"
+#include "game_map.h"
+#include <lcf/lsd/reader.h>
+#include <sstream>
+#include <vector>
+
+#include "mock_game.h"
+
+TEST_SUITE_BEGIN("Game_Pathfinder");
+
+using Result = Game_Pathfinder::Result;
+
+// Blocks the tiles of column x, except for row gap_y
+static void BuildWall(int x, int last_y, int gap_y = -1) {
+	lcf::Data::chipsets[0].passable_data_upper[1] = 0;
+	Game_Map::SetChipset(1);
+
+	for (int y = 0; y <= last_y; ++y) {
+		if (y != gap_y) {
+			Game_Map::ReplaceTileAt(x, y, BLOCK_F + 1, 1);
+		}
+	}
+}
+
+static void WalkPath(Game_Character& ch, const std::vector<int>& path) {
+	for (int dir: path) {
+		const int x = ch.GetX();
+		const int y = ch.GetY();
+		const int nx = x + Game_Character::GetDxFromDirection(dir);
+		const int ny = y + Game_Character::GetDyFromDirection(dir);
+		REQUIRE(Game_Map::CheckWay(ch, x, y, nx, ny, false, nullptr));
+		ch.SetX(nx);
+		ch.SetY(ny);
+	}
+}
+
+TEST_CASE("FindPath") {
+	const MockGame mg(MockMap::ePass40x30);
+	Game_Pathfinder::ResetBudget();
+	MockGame::GetPlayer()->SetX(30);
+	MockGame::GetPlayer()->SetY(20);
+
+	auto& ev = *MockGame::GetEvent(1);
+	ev.SetX(2);
+	ev.SetY(2);
+
+	std::vector<int> path;
+
+	SUBCASE("open") {
+		REQUIRE(Game_Pathfinder::FindPath(ev, 8, 5, path) == Result::Step);
+		REQUIRE_EQ(path.size(), 9);
+		WalkPath(ev, path);
+		REQUIRE_EQ(ev.GetX(), 8);
+		REQUIRE_EQ(ev.GetY(), 5);
+		REQUIRE(Game_Pathfinder::FindPath(ev, 8, 5, path) == Result::Arrived);
+		REQUIRE(path.empty());
+	}
+
+	SUBCASE("wall") {
+		BuildWall(5, 8);
+		REQUIRE(Game_Pathfinder::FindPath(ev, 8, 2, path) == Result::Step);
+		REQUIRE_EQ(path.size(), 6 + 2 * 7);
+
+		// The grid is rebuilt after a tile change
+		Game_Map::ReplaceTileAt(5, 9, BLOCK_F + 1, 1);
+		REQUIRE(Game_Pathfinder::FindPath(ev, 8, 2, path) == Result::Step);
+		REQUIRE_EQ(path.size(), 6 + 2 * 8);
+		WalkPath(ev, path);
+		REQUIRE_EQ(ev.GetX(), 8);
+		REQUIRE_EQ(ev.GetY(), 2);
+	}
+
+	SUBCASE("no path") {
+		BuildWall(5, 29);
+		REQUIRE(Game_Pathfinder::FindPath(ev, 8, 2, path) == Result::NoPath);
+		REQUIRE(path.empty());
+	}
+
+	SUBCASE("characters") {
+		BuildWall(5, 29, 9);
+		ev.SetLayer(lcf::rpg::EventPage::Layers_same);
+		auto& player = *MockGame::GetPlayer();
+		player.SetX(5);
+		player.SetY(9);
+
+		REQUIRE(Game_Pathfinder::FindPath(ev, 8, 2, path) == Result::NoPath);
+
+		// Character positions are collected once per frame
+		player.SetX(5);
+		player.SetY(20);
+		Game_Pathfinder::ResetBudget();
+		REQUIRE(Game_Pathfinder::FindPath(ev, 8, 2, path) == Result::Step);
+
+		// The target may be occupied
+		player.SetX(5);
+		player.SetY(9);
+		Game_Pathfinder::ResetBudget();
+		REQUIRE(Game_Pathfinder::FindPath(ev, 5, 9, path) == Result::Step);
+
+		ev.SetThrough(true);
+		REQUIRE(Game_Pathfinder::FindPath(ev, 8, 2, path) == Result::Step);
+	}
+}
+
+TEST_CASE("Budget") {
+	const MockGame mg(MockMap::ePass40x30);
+	BuildWall(5, 29);
+	Game_Pathfinder::ResetBudget();
+
+	auto& ev = *MockGame::GetEvent(1);
+	ev.SetX(20);
+	ev.SetY(2);
+
+	std::vector<int> path;
+	REQUIRE(Game_Pathfinder::FindPath(ev, 2, 2, path) == Result::NoPath);
+	const int used = Game_Pathfinder::frame_budget - Game_Pathfinder::GetBudget();
+	REQUIRE_GT(used, 0);
+
+	int searches = 1;
+	while (Game_Pathfinder::FindPath(ev, 2, 2, path) == Result::NoPath) {
+		++searches;
+	}
+	REQUIRE_EQ(searches, Game_Pathfinder::frame_budget / used);
+	REQUIRE(Game_Pathfinder::FindPath(ev, 2, 2, path) == Result::Deferred);
+	REQUIRE(Game_Pathfinder::FindPath(ev, 30, 2, path) == Result::Deferred);
+
+	Game_Pathfinder::ResetBudget();
+	REQUIRE(Game_Pathfinder::FindPath(ev, 30, 2, path) == Result::Step);
+}
+
+static void WalkTo(Game_Character& ch, int x, int y) {
+	lcf::rpg::MoveRoute mr;
+	mr.move_commands.push_back({});
+	mr.move_commands.back().command_id = Game_Pathfinder::move_command_walk_to;
+	mr.move_commands.back().parameter_a = x;
+	mr.move_commands.back().parameter_b = y;
+	ch.ForceMoveRoute(mr, 8);
+}
+
+TEST_CASE("MoveRoute") {
+	const MockGame mg(MockMap::ePass40x30);
+	auto config = Player::game_config;
+	Player::game_config.patch_easyrpg.Set(true);
+
+	BuildWall(5, 8);
+
+	auto& ev = *MockGame::GetEvent(1);
+	ev.SetX(2);
+	ev.SetY(2);
+	MockGame::GetPlayer()->SetX(30);
+	MockGame::GetPlayer()->SetY(20);
+
+	WalkTo(ev, 8, 2);
+
+	for (int i = 0; i < 2000 && ev.IsMoveRouteOverwritten(); ++i) {
+		Game_Pathfinder::ResetBudget();
+		ForceUpdate(ev);
+	}
+
+	REQUIRE(!ev.IsMoveRouteOverwritten());
+	REQUIRE_EQ(ev.GetX(), 8);
+	REQUIRE_EQ(ev.GetY(), 2);
+
+	Player::game_config = config;
+}
+
+TEST_CASE("Unreachable") {
+	const MockGame mg(MockMap::ePass40x30);
+	auto config = Player::game_config;
+	Player::game_config.patch_easyrpg.Set(true);
+
+	BuildWall(5, 29);
+
+	auto& ev = *MockGame::GetEvent(1);
+	ev.SetX(2);
+	ev.SetY(2);
+	auto& player = *MockGame::GetPlayer();
+	player.SetX(30);
+	player.SetY(20);
+
+	WalkTo(ev, 8, 2);
+	WalkTo(player, 30, 5);
+
+	// The unreachable target is not searched again while nothing changes
+	Game_Pathfinder::ResetBudget();
+	ForceUpdate(ev);
+	REQUIRE_LT(Game_Pathfinder::GetBudget(), Game_Pathfinder::frame_budget);
+	Game_Pathfinder::ResetBudget();
+	ForceUpdate(ev);
+	REQUIRE_EQ(Game_Pathfinder::GetBudget(), Game_Pathfinder::frame_budget);
+
+	// The other walker is not starved
+	for (int i = 0; i < 2000 && player.IsMoveRouteOverwritten(); ++i) {
+		Game_Pathfinder::ResetBudget();
+		ForceUpdate(ev);
+		ForceUpdate(player);
+	}
+	REQUIRE(!player.IsMoveRouteOverwritten());
+	REQUIRE_EQ(player.GetX(), 30);
+	REQUIRE_EQ(player.GetY(), 5);
+
+	REQUIRE(ev.IsMoveRouteOverwritten());
+	REQUIRE_EQ(ev.GetX(), 2);
+	REQUIRE_EQ(ev.GetY(), 2);
+	REQUIRE_GT(ev.GetMoveFailureCount(), 0);
+
+	Player::game_config = config;
+}
+
+TEST_CASE("SaveLoad") {
+	const MockGame mg(MockMap::ePass40x30);
+
+	auto& ev = *MockGame::GetEvent(1);
+	auto& player = *MockGame::GetPlayer();
+	WalkTo(ev, 8, 2);
+	WalkTo(player, 31, 17);
+
+	lcf::rpg::Save save;
+	save.party_location = player.GetSaveData();
+	save.map_info.events.push_back(ev.GetSaveData());
+
+	// liblcf does not save the parameters of unknown move commands
+	std::stringstream ss;
+	REQUIRE(lcf::LSD_Reader::Save(ss, save, lcf::EngineVersion::e2k3, "1252"));
+	auto loaded = lcf::LSD_Reader::Load(ss, "1252");
+	REQUIRE(loaded);
+	REQUIRE_EQ(loaded->map_info.events.size(), 1);
+
+	player.CancelMoveRoute();
+	ev.CancelMoveRoute();
+	player.SetSaveData(loaded->party_location);
+	ev.SetSaveData(loaded->map_info.events[0]);
+
+	auto check = [](const Game_Character& ch, int x, int y) {
+		REQUIRE(ch.IsMoveRouteOverwritten());
+		const auto& cmds = ch.GetMoveRoute().move_commands;
+		REQUIRE_EQ(cmds.size(), 1);
+		REQUIRE_EQ(cmds[0].command_id, Game_Pathfinder::move_command_walk_to);
+		REQUIRE_EQ(cmds[0].parameter_a, x);
+		REQUIRE_EQ(cmds[0].parameter_b, y);
+	};
+	check(player, 31, 17);
+	check(ev, 8, 2);
+
+	// Targets outside of every map stay unreachable
+	lcf::rpg::MoveRoute route;
+	route.move_commands.resize(1);
+	route.move_commands[0].command_id = Game_Pathfinder::move_command_walk_to;
+	route.move_commands[0].parameter_a = -1;
+	route.move_commands[0].parameter_b = 5;
+	Game_Pathfinder::EncodeMoveRoute(route);
+	Game_Pathfinder::DecodeMoveRoute(route);
+	REQUIRE_EQ(route.move_commands[0].parameter_a, Game_Pathfinder::coordinate_limit - 1);
+	REQUIRE_EQ(route.move_commands[0].parameter_b, 5);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,186 @@
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "doctest.h"
+#include "game_strings.h"
+#include "game_variables.h"
+#include "main_data.h"
+
+#include "mock_game.h"
+
+TEST_SUITE_BEGIN("Game_Strings");
+
+TEST_CASE("RegExReplace") {
+	REQUIRE_EQ(Game_Strings::RegExReplace("ABC", "B", "x"), "AxC");
+	REQUIRE_EQ(Game_Strings::RegExReplace("AB\xE3\x81\x82" "C", "B", "x"), "Ax\xE3\x81\x82" "C");
+
+	// ASCII patterns with escapes of non-ASCII codepoints
+	REQUIRE_EQ(Game_Strings::RegExReplace("ABC", "\\u3042", "x"), "ABC");
+	REQUIRE_EQ(Game_Strings::RegExReplace("ABC", "[\\u3040-\\u309f]", "x"), "ABC");
+	REQUIRE_EQ(Game_Strings::RegExReplace("ABC", "\\xe9", "x"), "ABC");
+	REQUIRE_EQ(Game_Strings::RegExReplace("ABC", "\\x42", "x"), "AxC");
+	REQUIRE_EQ(Game_Strings::RegExReplace("AB\xE3\x81\x82" "C", "\\u3042", "x"), "ABxC");
+	REQUIRE_EQ(Game_Strings::RegExReplace("AB\xE3\x81\x82" "C", "[\\u3040-\\u309f]", "x"), "ABxC");
+}
+
+TEST_CASE("ExMatch") {
+	const MockGame mg(MockMap::ePass40x30);
+	Game_Strings strings;
+	auto& variables = *Main_Data::game_variables;
+
+	SUBCASE("ascii") {
+		strings.Asg(1, "ABC");
+		strings.ExMatch(1, "B", 1, 0, 2, variables);
+		REQUIRE_EQ(strings.Get(2), "B");
+		REQUIRE_EQ(variables.Get(1), 1);
+		strings.ExMatch(1, "\\u3042", 1, 0, 2, variables);
+		REQUIRE_EQ(strings.Get(2), "");
+		strings.ExMatch(1, "[\\u3040-\\u309f]", 1, 0, 2, variables);
+		REQUIRE_EQ(strings.Get(2), "");
+	}
+
+	SUBCASE("unicode") {
+		strings.Asg(1, "AB\xE3\x81\x82" "C");
+		strings.ExMatch(1, "\\u3042", 1, 0, 2, variables);
+		REQUIRE_EQ(strings.Get(2), "\xE3\x81\x82");
+		REQUIRE_EQ(variables.Get(1), 2);
+		strings.ExMatch(1, "[\\u3040-\\u309f]", 1, 0, 2, variables);
+		REQUIRE_EQ(strings.Get(2), "\xE3\x81\x82");
+		REQUIRE_EQ(variables.Get(1), 2);
+	}
+}
+
+TEST_CASE("StorageInlineBoundary") {
+	Game_Strings strings;
+
+	// 16 bytes are stored inline, 17 bytes in the arena
+	for (auto& str: { std::string(16, 'a'), std::string(17, 'b'), std::string(16, 'c'), std::string(1, 'd'), std::string(40, 'e'), std::string() }) {
+		strings.Asg(1, str);
+		REQUIRE_EQ(strings.Get(1), str);
+	}
+
+	strings.Asg(1, std::string(15, 'f'));
+	strings.Cat(1, "g");
+	REQUIRE_EQ(strings.Get(1), std::string(15, 'f') + "g");
+	strings.Cat(1, "h");
+	REQUIRE_EQ(strings.Get(1), std::string(15, 'f') + "gh");
+	strings.Asg(1, "i");
+	REQUIRE_EQ(strings.Get(1), "i");
+}
+
+TEST_CASE("StorageCatInPlace") {
+	Game_Strings strings;
+
+	strings.Asg(1, std::string(20, 'a'));
+	strings.Asg(2, std::string(20, 'b'));
+	const char* data = strings.Get(1).data();
+
+	// The arena reserves room for growth, the string is not moved
+	strings.Cat(1, "12345");
+	REQUIRE_EQ(strings.Get(1), std::string(20, 'a') + "12345");
+	REQUIRE(strings.Get(1).data() == data);
+	REQUIRE_EQ(strings.Get(2), std::string(20, 'b'));
+
+	// Growing beyond the reserved room relocates it
+	strings.Cat(1, std::string(20, 'c'));
+	REQUIRE_EQ(strings.Get(1), std::string(20, 'a') + "12345" + std::string(20, 'c'));
+	REQUIRE_EQ(strings.Get(2), std::string(20, 'b'));
+
+	// Concatenating a string to itself
+	strings.Asg(3, std::string(17, 'd'));
+	strings.Cat(3, strings.Get(3));
+	REQUIRE_EQ(strings.Get(3), std::string(34, 'd'));
+}
+
+TEST_CASE("StorageCompactArena") {
+	Game_Strings strings;
+
+	for (int i = 1; i <= 10; ++i) {
+		strings.Asg(i, std::string(10000, static_cast<char>('a' + i)));
+	}
+	// Frees most of the arena
+	for (int i = 1; i <= 9; ++i) {
+		strings.Asg(i, std::string(i, static_cast<char>('A' + i)));
+	}
+	// Compacts the arena before allocating
+	strings.Asg(11, std::string(20000, 'z'));
+
+	for (int i = 1; i <= 9; ++i) {
+		REQUIRE_EQ(strings.Get(i), std::string(i, static_cast<char>('A' + i)));
+	}
+	REQUIRE_EQ(strings.Get(10), std::string(10000, 'k'));
+	REQUIRE_EQ(strings.Get(11), std::string(20000, 'z'));
+
+	strings.Cat(10, "end");
+	REQUIRE_EQ(strings.Get(10), std::string(10000, 'k') + "end");
+	REQUIRE_EQ(strings.Get(11), std::string(20000, 'z'));
+}
+
+#ifdef HAVE_NLOHMANN_JSON
+TEST_CASE("StorageJsonCache") {
+	Game_Strings strings;
+
+	strings.Asg(1, R"({"value": 1})");
+	auto* json = strings.ParseJson(1);
+	REQUIRE(json);
+	REQUIRE_EQ((*json)["value"], 1);
+
+	strings.Asg(1, R"({"value": 2, "padding": "long enough for the arena"})");
+	json = strings.ParseJson(1);
+	REQUIRE(json);
+	REQUIRE_EQ((*json)["value"], 2);
+
+	strings.Asg(1, "[1");
+	strings.Cat(1, "]");
+	json = strings.ParseJson(1);
+	REQUIRE(json);
+	REQUIRE(json->is_array());
+
+	strings.SetData({ lcf::DBString(R"({"value": 3})") });
+	json = strings.ParseJson(1);
+	REQUIRE(json);
+	REQUIRE_EQ((*json)["value"], 3);
+}
+#endif
+
+TEST_CASE("StorageLcfData") {
+	Game_Strings strings;
+	// Same layout as the map of strings that was stored before
+	std::unordered_map<int, std::string> expected;
+
+	const int ids[] = { 3, 1, 7, 3, 12, 1, 7, 5, 3 };
+	const size_t sizes[] = { 0, 5, 16, 17, 30, 2, 0, 100, 16 };
+	for (size_t i = 0; i < std::size(ids); ++i) {
+		std::string str(sizes[i], static_cast<char>('a' + i));
+		strings.Asg(ids[i], str);
+		if (!str.empty() || expected.count(ids[i])) {
+			expected[ids[i]] = str;
+		}
+		strings.Cat(ids[i], "x");
+		expected[ids[i]] += "x";
+	}
+	strings.Asg(20, "");
+
+	std::vector<lcf::DBString> expected_lcf;
+	for (auto& [index, value]: expected) {
+		if (index >= static_cast<int>(expected_lcf.size())) {
+			expected_lcf.resize(index + 1);
+		}
+		expected_lcf[index - 1] = lcf::DBString(value);
+	}
+
+	auto lcf_data = strings.GetLcfData();
+	REQUIRE_EQ(lcf_data.size(), expected_lcf.size());
+	for (size_t i = 0; i < lcf_data.size(); ++i) {
+		REQUIRE_EQ(ToString(lcf_data[i]), ToString(expected_lcf[i]));
+	}
+
+	Game_Strings loaded;
+	loaded.SetData(lcf_data);
+	for (int i = 1; i <= static_cast<int>(lcf_data.size()); ++i) {
+		REQUIRE_EQ(loaded.Get(i), strings.Get(i));
+	}
+}
+
+TEST_SUITE_END();
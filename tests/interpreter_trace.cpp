@@ -0,0 +1,161 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "interpreter_trace.h"
+#include "game_switches.h"
+#include "game_variables.h"
+#include "doctest.h"
+
+using InterpreterTrace::Record;
+
+TEST_SUITE_BEGIN("InterpreterTrace");
+
+static Record MakeRecord(int frame, int interpreter_id, int event_id, int index, int code) {
+	Record rec;
+	rec.frame = frame;
+	rec.interpreter_id = interpreter_id;
+	rec.event_id = event_id;
+	rec.index = index;
+	rec.code = code;
+	return rec;
+}
+
+static std::vector<Record> MakeRecords() {
+	std::vector<Record> recs;
+	recs.push_back(MakeRecord(1, 0, 1, 0, 10110));
+	recs.push_back(MakeRecord(1, 0, 1, 1, 10220));
+	recs.back().variables = { { 1, 1 }, { 10, 5000 } };
+	recs.push_back(MakeRecord(300, 3, 0, 12, 10210));
+	recs.back().switches = { { 4, 4 } };
+	recs.push_back(MakeRecord(70000, 123456, 9999, 40000, 1005));
+	return recs;
+}
+
+static std::string Encode(const std::vector<Record>& recs) {
+	std::vector<uint8_t> out;
+	InterpreterTrace::EncodeHeader(out);
+	int prev_frame = 0;
+	for (auto& rec: recs) {
+		InterpreterTrace::EncodeRecord(rec, prev_frame, out);
+		prev_frame = rec.frame;
+	}
+	return std::string(out.begin(), out.end());
+}
+
+static std::vector<Record> Decode(std::istream& is) {
+	InterpreterTrace::Reader reader(is);
+	REQUIRE(reader.IsValid());
+
+	std::vector<Record> recs;
+	Record rec;
+	while (reader.Next(rec)) {
+		recs.push_back(rec);
+	}
+	REQUIRE(reader.IsValid());
+	return recs;
+}
+
+TEST_CASE("RoundTrip") {
+	auto recs = MakeRecords();
+	std::istringstream is(Encode(recs));
+
+	auto decoded = Decode(is);
+	REQUIRE_EQ(decoded.size(), recs.size());
+	for (size_t i = 0; i < recs.size(); ++i) {
+		REQUIRE(decoded[i] == recs[i]);
+	}
+}
+
+TEST_CASE("Invalid") {
+	std::istringstream is("NOTATRACE");
+	InterpreterTrace::Reader reader(is);
+	REQUIRE_FALSE(reader.IsValid());
+
+	auto data = Encode(MakeRecords());
+	std::istringstream truncated(data.substr(0, data.size() - 2));
+	InterpreterTrace::Reader reader2(truncated);
+	REQUIRE(reader2.IsValid());
+	Record rec;
+	while (reader2.Next(rec)) {
+	}
+	REQUIRE_FALSE(reader2.IsValid());
+}
+
+TEST_CASE("Compare") {
+	auto recs = MakeRecords();
+	int index = -1;
+
+	std::istringstream a(Encode(recs));
+	std::istringstream b(Encode(recs));
+	REQUIRE(InterpreterTrace::Compare(a, b, index));
+	REQUIRE_EQ(index, 4);
+
+	auto changed = recs;
+	changed[2].switches[0].last = 5;
+	std::istringstream c(Encode(recs));
+	std::istringstream d(Encode(changed));
+	REQUIRE_FALSE(InterpreterTrace::Compare(c, d, index));
+	REQUIRE_EQ(index, 2);
+
+	auto shorter = recs;
+	shorter.pop_back();
+	std::istringstream e(Encode(recs));
+	std::istringstream f(Encode(shorter));
+	REQUIRE_FALSE(InterpreterTrace::Compare(e, f, index));
+	REQUIRE_EQ(index, 3);
+}
+
+TEST_CASE("Record") {
+	const char* path = "interpreter_trace_test.bin";
+	Game_Switches switches;
+	Game_Variables variables(Game_Variables::min_2k, Game_Variables::max_2k);
+
+	REQUIRE(InterpreterTrace::Start(path));
+	REQUIRE(InterpreterTrace::IsActive());
+
+	// Not inside a command
+	switches.Set(1, true);
+
+	InterpreterTrace::CommandBegin(2, 5, 0, 10220);
+	variables.Set(3, 10);
+	variables.Add(4, 10);
+	variables.SetRange(20, 30, 1);
+	InterpreterTrace::CommandEnd();
+
+	InterpreterTrace::CommandBegin(2, 5, 1, 10210);
+	switches.Set(7, true);
+	switches.FlipRange(8, 9);
+	InterpreterTrace::CommandEnd();
+
+	InterpreterTrace::CommandBegin(0, 0, 4, 10110);
+	InterpreterTrace::Stop();
+	REQUIRE_FALSE(InterpreterTrace::IsActive());
+
+	std::ifstream is(path, std::ios_base::binary);
+	auto recs = Decode(is);
+	is.close();
+	std::remove(path);
+
+	REQUIRE_EQ(recs.size(), 3);
+
+	REQUIRE_EQ(recs[0].interpreter_id, 2);
+	REQUIRE_EQ(recs[0].event_id, 5);
+	REQUIRE_EQ(recs[0].index, 0);
+	REQUIRE_EQ(recs[0].code, 10220);
+	REQUIRE(recs[0].switches.empty());
+	REQUIRE_EQ(recs[0].variables.size(), 2);
+	REQUIRE_EQ(recs[0].variables[0].first, 3);
+	REQUIRE_EQ(recs[0].variables[0].last, 4);
+	REQUIRE_EQ(recs[0].variables[1].first, 20);
+	REQUIRE_EQ(recs[0].variables[1].last, 30);
+
+	REQUIRE_EQ(recs[1].index, 1);
+	REQUIRE_EQ(recs[1].switches.size(), 1);
+	REQUIRE_EQ(recs[1].switches[0].first, 7);
+	REQUIRE_EQ(recs[1].switches[0].last, 9);
+	REQUIRE(recs[1].variables.empty());
+
+	REQUIRE_EQ(recs[2].code, 10110);
+}
+
+TEST_SUITE_END();
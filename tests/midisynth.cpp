@@ -0,0 +1,93 @@
+#include "system.h"
+#include "doctest.h"
+
+#ifdef WANT_FMMIDI
+
+#include <vector>
+#include "decoder_fmmidi.h"
+
+// Renders a dense pseudo random note sequence on all channels and hashes the output.
+// Exercises program changes, panpot, modulation, pressure, damper and pitch bend.
+static uint32_t render_hash(midisynth::synthesizer& synth, int blocks) {
+	std::vector<int_least16_t> out(256 * 2);
+	uint32_t hash = 2166136261u;
+	uint32_t rnd = 1;
+
+	for (int b = 0; b < blocks; ++b) {
+		if (b % 8 == 0) {
+			for (int c = 0; c < 16; ++c) {
+				rnd = rnd * 1103515245 + 12345;
+				int note = 36 + (rnd >> 16) % 48;
+				if (b % 64 == 0) synth.midi_event(0xC0 | c, (c * 7 + b / 64) % 128, 0);
+				if (b % 32 == 0) synth.midi_event(0xB0 | c, 10, (rnd >> 8) & 127);
+				if (b % 48 == 0) synth.midi_event(0xB0 | c, 1, (rnd >> 4) & 127);
+				if (b % 40 == 0) synth.midi_event(0xD0 | c, (rnd >> 3) & 127, 0);
+				if (b % 24 == 0) synth.midi_event(0xB0 | c, 64, (b / 24 % 2) * 127);
+				if (b % 56 == 0) synth.midi_event(0xE0 | c, rnd & 127, (rnd >> 7) & 127);
+				synth.midi_event(0x90 | c, note, 40 + (rnd >> 20) % 80);
+				synth.midi_event(0x80 | c, (note + 5) % 128, 64);
+				if (b % 16 == 0) synth.midi_event(0x80 | c, (note + 12) % 128, 0);
+			}
+		}
+		synth.synthesize(out.data(), 256, 44100.0f);
+		for (auto x: out) {
+			hash ^= static_cast<uint16_t>(x);
+			hash *= 16777619u;
+		}
+	}
+
+	return hash;
+}
+
+TEST_SUITE_BEGIN("MidiSynth");
+
+TEST_CASE("OutputUnchanged") {
+	FmMidiDecoder dec;
+	dec.synth->set_max_polyphony(0);
+
+	// Hash of the output of the per-sample renderer before block rendering was introduced
+	REQUIRE_EQ(render_hash(*dec.synth, 172), 0xac94ef46u);
+}
+
+TEST_CASE("PolyphonyLimit") {
+	FmMidiDecoder dec;
+	auto& synth = *dec.synth;
+	synth.set_max_polyphony(4);
+
+	for (int i = 0; i < 4; ++i) {
+		synth.note_on(0, 60 + i, 100);
+	}
+	REQUIRE_EQ(synth.get_num_notes(), 4);
+
+	// Released notes are stolen first
+	synth.note_off(0, 62, 64);
+	synth.note_on(1, 70, 100);
+	REQUIRE_EQ(synth.get_num_notes(), 4);
+	REQUIRE_EQ(synth.get_channel(0)->get_num_notes(), 3);
+
+	// Otherwise the oldest note is stolen
+	synth.note_on(1, 71, 100);
+	synth.note_on(1, 72, 100);
+	REQUIRE_EQ(synth.get_num_notes(), 4);
+	REQUIRE_EQ(synth.get_channel(0)->get_num_notes(), 1);
+	REQUIRE_EQ(synth.get_channel(1)->get_num_notes(), 3);
+
+	// Note off with velocity 0 must not steal
+	synth.note_on(1, 72, 0);
+	REQUIRE_EQ(synth.get_num_notes(), 4);
+}
+
+TEST_CASE("PolyphonyUnlimited") {
+	FmMidiDecoder dec;
+	auto& synth = *dec.synth;
+	synth.set_max_polyphony(0);
+
+	for (int i = 0; i < 200; ++i) {
+		synth.note_on(i % 16, i % 128, 100);
+	}
+	REQUIRE_EQ(synth.get_num_notes(), 200);
+}
+
+TEST_SUITE_END();
+
+#endif
@@ -42,6 +42,12 @@ TEST_CASE("GetSize") {
 	CHECK(Platform::File(bad).GetSize() == -1);
 }
 
+TEST_CASE("GetModifiedTime") {
+	CHECK(Platform::File(onekb).GetModifiedTime() > 0);
+	CHECK(Platform::File(folder).GetModifiedTime() > 0);
+	CHECK(Platform::File(bad).GetModifiedTime() == -1);
+}
+
 TEST_CASE("ReadDirectory") {
 	Platform::Directory dir(EP_TEST_PATH "/platform");
 
@@ -123,6 +123,56 @@ TEST_CASE("FlipRange") {
 	REQUIRE_FALSE(s.Get(n + 1));
 }
 
+TEST_CASE("RangeWordBoundaries") {
+	constexpr int n = 200;
+	auto s = make();
+
+	// Ranges starting and ending inside of and on the edge of 64 bit words
+	s.SetRange(60, 130, true);
+	for (int i = 1; i <= n; ++i) {
+		REQUIRE_EQ(s.Get(i), i >= 60 && i <= 130);
+	}
+	REQUIRE_EQ(s.GetSize(), 130);
+
+	s.FlipRange(64, 129);
+	for (int i = 1; i <= n; ++i) {
+		REQUIRE_EQ(s.Get(i), (i >= 60 && i <= 63) || i == 130);
+	}
+
+	s.SetRange(n, n, true);
+	REQUIRE_EQ(s.GetSize(), n);
+	REQUIRE(s.Get(n));
+	REQUIRE_FALSE(s.Get(n - 1));
+
+	s.SetRange(5, 4, true);
+	REQUIRE_FALSE(s.Get(4));
+	REQUIRE_FALSE(s.Get(5));
+}
+
+TEST_CASE("Data") {
+	auto s = make();
+	Game_Switches::Switches_t data(100);
+	data[0] = true;
+	data[63] = true;
+	data[64] = true;
+	data[99] = true;
+
+	s.SetData(data);
+	REQUIRE_EQ(s.GetSize(), 100);
+	REQUIRE(s.Get(1));
+	REQUIRE(s.Get(64));
+	REQUIRE(s.Get(65));
+	REQUIRE(s.Get(100));
+	REQUIRE_EQ(s.CountRange(1, 100), 4);
+	REQUIRE(s.GetData() == data);
+
+	// Switches past the end are cleared after shrinking
+	s.Set(128, true);
+	s.SetData(Game_Switches::Switches_t(65));
+	s.Set(66, false);
+	REQUIRE_EQ(s.CountRange(1, 128), 0);
+}
+
 TEST_CASE("GetSize") {
 	auto s = make();
 	REQUIRE_EQ(s.GetSizeWithLimit(), max_switches);
@@ -555,6 +555,58 @@ TEST_CASE("Overflow/Underflow") {
 	REQUIRE(v.Get(1) == _min);
 }
 
+TEST_CASE("Overflow/Underflow Range") {
+	lcf::Data::variables.resize(max_vars);
+
+	auto _min = std::numeric_limits<Game_Variables::Var_t>::min();
+	auto _max = std::numeric_limits<Game_Variables::Var_t>::max();
+
+	// Long enough for loops the compiler vectorizes (e.g. at -O3)
+	constexpr int n = 37;
+
+	Game_Variables v(_min, _max);
+	v.SetWarning(0);
+
+	auto require_range = [&](Game_Variables::Var_t val) {
+		for (int i = 1; i <= n; ++i) {
+			REQUIRE_EQ(v.Get(i), val);
+		}
+	};
+
+	v.SetRange(1, n, _max);
+	v.AddRange(1, n, 1);
+	require_range(_max);
+
+	v.SetRange(1, n, _min);
+	v.SubRange(1, n, 1);
+	require_range(_min);
+
+	v.SetRange(1, n, _min);
+	v.MultRange(1, n, -2);
+	require_range(_max);
+
+	v.SetRange(1, n, _max);
+	v.MultRange(1, n, -2);
+	require_range(_min);
+
+	v.SetRange(1, n, _max);
+	v.SetRange(n + 1, n * 2, -1);
+	v.SubArray(1, n, n + 1);
+	require_range(_max);
+
+	v.AddArray(1, n, n + 1);
+	require_range(_max - 1);
+
+	Game_Variables v2k(Game_Variables::min_2k, Game_Variables::max_2k);
+	v2k.SetWarning(0);
+	v2k.SetRange(1, n, Game_Variables::max_2k);
+	v2k.AddRange(1, n, 1);
+	v2k.MultArray(1, n, 1);
+	for (int i = 1; i <= n; ++i) {
+		REQUIRE_EQ(v2k.Get(i), Game_Variables::max_2k);
+	}
+}
+
 TEST_CASE("Enumerate") {
 	auto s = make();
 